@@ -129,7 +129,42 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  // The parser fills in its own default access method when there is no USING clause.
+  std::string index_type;
+  if (stmt->accessMethod != nullptr && std::string(stmt->accessMethod) != DEFAULT_INDEX_TYPE) {
+    index_type = stmt->accessMethod;
+  }
+
+  // The parser has no INCLUDE clause, so covering columns are given as a storage option: WITH (include = 'c1, c2').
+  // WITH (bloom_filter = 'true') keeps a Bloom filter over the keys for point lookups.
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols;
+  bool bloom_filter = false;
+  if (stmt->options != nullptr) {
+    for (auto cell = stmt->options->head; cell != nullptr; cell = cell->next) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      auto option_name = StringUtil::Lower(option->defname);
+      if ((option_name != "include" && option_name != "bloom_filter") || option->arg == nullptr ||
+          option->arg->type != duckdb_libpgquery::T_PGString) {
+        throw NotImplementedException(fmt::format("unsupported index option {}", option->defname));
+      }
+      auto arg = std::string(reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg)->val.str);
+      if (option_name == "bloom_filter") {
+        auto flag = StringUtil::Lower(arg);
+        if (flag != "true" && flag != "false") {
+          throw NotImplementedException(fmt::format("unsupported bloom_filter value {}", arg));
+        }
+        bloom_filter = flag == "true";
+        continue;
+      }
+      for (const auto &name : StringUtil::Split(arg, ',')) {
+        auto column_ref = ResolveColumn(*table, std::vector{StringUtil::Strip(name, ' ')});
+        include_cols.emplace_back(std::make_unique<BoundColumnRef>(dynamic_cast<const BoundColumnRef &>(*column_ref)));
+      }
+    }
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), std::move(index_type),
+                                          std::move(include_cols), bloom_filter);
 }
 
 }  // namespace bustub
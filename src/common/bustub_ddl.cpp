@@ -56,8 +56,9 @@ void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement
   for (const auto &col : stmt.cols_) {
     auto idx = stmt.table_->schema_.GetColIdx(col->col_name_.back());
     col_ids.push_back(idx);
-    if (stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
-      throw NotImplementedException("only support creating index on integer column");
+    auto type = stmt.table_->schema_.GetColumn(idx).GetType();
+    if (type != TypeId::INTEGER && type != TypeId::VARCHAR) {
+      throw NotImplementedException("only support creating index on integer and varchar columns");
     }
   }
   auto key_schema = Schema::CopySchema(&stmt.table_->schema_, col_ids);
@@ -71,15 +72,65 @@ void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement
     throw NotImplementedException("only support creating index with exactly one or two columns");
   }
 
+  IndexType index_type;
+  if (stmt.index_type_.empty() || stmt.index_type_ == "btree") {
+    index_type = IndexType::BPlusTreeIndex;
+  } else if (stmt.index_type_ == "blink") {
+    index_type = IndexType::BLinkTreeIndex;
+  } else if (stmt.index_type_ == "hash") {
+    index_type = IndexType::HashTableIndex;
+  } else {
+    throw NotImplementedException(fmt::format("unsupported index type {}", stmt.index_type_));
+  }
+
+  // Included columns are copied into the leaf values, so they must be fixed-length and fit in the payload
+  std::vector<uint32_t> include_col_ids;
+  for (const auto &col : stmt.include_cols_) {
+    include_col_ids.push_back(stmt.table_->schema_.GetColIdx(col->col_name_.back()));
+  }
+  auto include_schema = Schema::CopySchema(&stmt.table_->schema_, include_col_ids);
+  if (!include_schema.IsInlined() || include_schema.GetLength() > COVERING_PAYLOAD_SIZE) {
+    throw NotImplementedException(
+        fmt::format("included columns must be fixed-length and take at most {} bytes", COVERING_PAYLOAD_SIZE));
+  }
+  // Varchar keys get a VarlenBPlusTreeIndex from the catalog, which has no covering variant
+  if (!key_schema.IsInlined() && !include_col_ids.empty()) {
+    throw NotImplementedException("included columns are not supported with varchar index keys");
+  }
+  if (index_type == IndexType::HashTableIndex && (!key_schema.IsInlined() || !include_col_ids.empty())) {
+    throw NotImplementedException("hash indexes only support integer keys without included columns");
+  }
+  // The catalog builds a VarlenBPlusTreeIndex for varchar keys, which has no B-link mode
+  if (index_type == IndexType::BLinkTreeIndex && !key_schema.IsInlined()) {
+    throw NotImplementedException("blink indexes only support integer keys");
+  }
+  if (stmt.bloom_filter_ && (!key_schema.IsInlined() || index_type != IndexType::BPlusTreeIndex)) {
+    throw NotImplementedException("bloom filters are only supported on btree indexes with integer keys");
+  }
+
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
-  auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-      txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
-      IntegerHashFunctionType{});
+  IndexInfo *info;
+  if (include_col_ids.empty()) {
+    info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+        txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
+        IntegerHashFunctionType{}, index_type);
+  } else {
+    info = catalog_->CreateIndex<IntegerKeyType, IntegerCoveringValueType, IntegerComparatorType>(
+        txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
+        IntegerHashFunctionType{}, index_type, include_col_ids);
+  }
   l.unlock();
 
   if (info == nullptr) {
     throw bustub::Exception("Failed to create index");
   }
+  if (stmt.bloom_filter_) {
+    if (auto index = dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(info->index_.get()); index != nullptr) {
+      index->EnableBloomFilter();
+    } else {
+      dynamic_cast<CoveringBPlusTreeIndexForTwoIntegerColumn &>(*info->index_).EnableBloomFilter();
+    }
+  }
   WriteOneCell(fmt::format("Index created with id = {}", info->index_oid_), writer);
 }
 
@@ -110,7 +161,7 @@ void BustubInstance::HandleExplainStatement(Transaction *txn, const ExplainState
   }
 
   // Print optimizer result.
-  bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+  bustub::Optimizer optimizer(*catalog_, IsForceStarterRule(), GetIndexScanParallelism());
   auto optimized_plan = optimizer.Optimize(planner.plan_);
 
   l.unlock();
@@ -275,7 +275,7 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
     planner.PlanQuery(*statement);
 
     // Optimize the query.
-    bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
+    bustub::Optimizer optimizer(*catalog_, IsForceStarterRule(), GetIndexScanParallelism());
     auto optimized_plan = optimizer.Optimize(planner.plan_);
 
     l.unlock();
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -24,20 +25,29 @@ namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                         uint32_t header_max_depth)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+  // directories are created the first time a key lands in their slice of the hash space
+  auto header_page = reinterpret_cast<ExtendibleHashTableHeaderPage *>(
+      buffer_pool_manager_->NewPage(&header_page_id_)->GetData());
+  header_page->Init(header_page_id_, header_max_depth);
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
 }
 
 /*****************************************************************************
  * HELPERS
  *****************************************************************************/
 /**
- * Hash - simple helper to downcast MurmurHash's 64-bit hash to 32-bit
- * for extendible hashing.
+ * Hash - truncates the 64-bit hash of hash_fn_ to the 32 bits extendible hashing
+ * works on. With the default FastHashPolicy that is the wyhash-style
+ * HashUtil::HashBytes. Each consumer takes its own bits:
+ *  - the header page picks a directory from the top max_depth bits,
+ *  - the directory page picks a bucket from the low global_depth bits,
+ *  - the bucket page stores bits 12-19 as each slot's fingerprint.
  *
  * @param key the key to hash
- * @return the downcasted 32-bit hash
+ * @return the low 32 bits of the key's hash
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
@@ -46,22 +56,41 @@ auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+  return Hash(key) & dir_page->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
-}
-
-template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+auto HASH_TABLE_TYPE::FetchDirectoryPage(KeyType key, page_id_t *directory_page_id, bool create)
+    -> HashTableDirectoryPage * {
+  auto header_page =
+      reinterpret_cast<ExtendibleHashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_)->GetData());
+  uint32_t directory_idx = header_page->HashToDirectoryIndex(Hash(key));
+  *directory_page_id = header_page->GetDirectoryPageId(directory_idx);
+  bool header_dirty = false;
+  if (*directory_page_id == INVALID_PAGE_ID && create) {
+    // a new directory of global depth 0 pointing at one empty bucket
+    auto dir_page =
+        reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->NewPage(directory_page_id)->GetData());
+    dir_page->SetPageId(*directory_page_id);
+    page_id_t bucket_page_id;
+    buffer_pool_manager_->NewPage(&bucket_page_id);
+    dir_page->SetBucketPageId(0, bucket_page_id);
+    dir_page->SetLocalDepth(0, 0);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+    buffer_pool_manager_->UnpinPage(*directory_page_id, true);
+    header_page->SetDirectoryPageId(directory_idx, *directory_page_id);
+    header_dirty = true;
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, header_dirty);
+  if (*directory_page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  return reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(*directory_page_id)->GetData());
 }
 
 /*****************************************************************************
@@ -69,7 +98,21 @@ auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BU
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  page_id_t directory_page_id;
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage(key, &directory_page_id);
+  if (dir_page == nullptr) {
+    table_latch_.RUnlock();
+    return false;
+  }
+  bool found;
+  {
+    ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(KeyToPageId(key, dir_page));
+    found = guard.As<HASH_TABLE_BUCKET_TYPE>()->GetValue(key, comparator_, Hash(key), result);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  table_latch_.RUnlock();
+  return found;
 }
 
 /*****************************************************************************
@@ -77,12 +120,92 @@ auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.RLock();
+  page_id_t directory_page_id;
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage(key, &directory_page_id);
+  if (dir_page == nullptr) {
+    // creating the directory changes the header, which takes the exclusive path
+    table_latch_.RUnlock();
+    return SplitInsert(transaction, key, value);
+  }
+  bool full;
+  bool inserted = false;
+  {
+    WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(KeyToPageId(key, dir_page));
+    auto bucket = guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+    full = bucket->IsFull();
+    if (!full) {
+      inserted = bucket->Insert(key, value, comparator_, Hash(key));
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  table_latch_.RUnlock();
+
+  if (full) {
+    return SplitInsert(transaction, key, value);
+  }
+  return inserted;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  page_id_t directory_page_id;
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage(key, &directory_page_id, true);
+  bool dir_dirty = false;
+  bool inserted = false;
+  while (true) {
+    uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(bucket_page_id);
+    auto bucket = guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+    if (!bucket->IsFull()) {
+      inserted = bucket->Insert(key, value, comparator_, Hash(key));
+      break;
+    }
+    std::vector<ValueType> values;
+    bucket->GetValue(key, comparator_, Hash(key), &values);
+    if (std::find(values.begin(), values.end(), value) != values.end()) {
+      break;
+    }
+
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == dir_page->GetGlobalDepth()) {
+      if (dir_page->Size() == DIRECTORY_ARRAY_SIZE) {
+        // a directory cannot grow past one page; a deeper header spreads keys over more of them
+        break;
+      }
+      dir_page->IncrGlobalDepth();
+    }
+
+    // every index pointing at the bucket goes one bit deeper; those with that bit set now point at the split image
+    page_id_t image_page_id;
+    WritePageGuard image_guard = buffer_pool_manager_->NewPageGuarded(&image_page_id).UpgradeWrite();
+    auto image = image_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+    uint32_t high_bit = 1U << local_depth;
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      if (dir_page->GetBucketPageId(idx) == bucket_page_id) {
+        dir_page->IncrLocalDepth(idx);
+        if ((idx & high_bit) != 0) {
+          dir_page->SetBucketPageId(idx, image_page_id);
+        }
+      }
+    }
+    dir_dirty = true;
+    for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE; slot++) {
+      if (!bucket->IsReadable(slot)) {
+        continue;
+      }
+      uint32_t slot_hash = Hash(bucket->KeyAt(slot));
+      if ((slot_hash & high_bit) != 0) {
+        image->Insert(bucket->KeyAt(slot), bucket->ValueAt(slot), comparator_, slot_hash);
+        bucket->RemoveAt(slot);
+      }
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id, dir_dirty);
+  table_latch_.WUnlock();
+  return inserted;
 }
 
 /*****************************************************************************
@@ -90,40 +213,130 @@ auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.RLock();
+  page_id_t directory_page_id;
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage(key, &directory_page_id);
+  if (dir_page == nullptr) {
+    table_latch_.RUnlock();
+    return false;
+  }
+  bool removed;
+  bool empty;
+  {
+    WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(KeyToPageId(key, dir_page));
+    auto bucket = guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+    removed = bucket->Remove(key, value, comparator_, Hash(key));
+    empty = bucket->IsEmpty();
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  table_latch_.RUnlock();
+
+  if (removed && empty) {
+    Merge(transaction, key, value);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
+/*
+ * The bucket merges into its split image, and if that leaves an empty bucket of the same depth on the other side of
+ * the next bit up, the merge carries on from there.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  page_id_t directory_page_id;
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage(key, &directory_page_id);
+  bool dir_dirty = false;
+  while (true) {
+    uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == 0) {
+      break;
+    }
+    uint32_t image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    page_id_t image_page_id = dir_page->GetBucketPageId(image_idx);
+    if (dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    // merge whichever of the two is empty into the other
+    bool bucket_empty;
+    bool image_empty;
+    {
+      ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(bucket_page_id);
+      bucket_empty = guard.As<HASH_TABLE_BUCKET_TYPE>()->IsEmpty();
+      ReadPageGuard image_guard = buffer_pool_manager_->FetchPageRead(image_page_id);
+      image_empty = image_guard.As<HASH_TABLE_BUCKET_TYPE>()->IsEmpty();
+    }
+    if (!bucket_empty && !image_empty) {
+      break;
+    }
+    page_id_t kept_page_id = bucket_empty ? image_page_id : bucket_page_id;
+    page_id_t freed_page_id = bucket_empty ? bucket_page_id : image_page_id;
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      page_id_t page_id = dir_page->GetBucketPageId(idx);
+      if (page_id == bucket_page_id || page_id == image_page_id) {
+        dir_page->SetBucketPageId(idx, kept_page_id);
+        dir_page->DecrLocalDepth(idx);
+      }
+    }
+    buffer_pool_manager_->DeletePage(freed_page_id);
+    dir_dirty = true;
+  }
+  while (dir_page->CanShrink()) {
+    dir_page->DecrGlobalDepth();
+    dir_dirty = true;
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id, dir_dirty);
+  table_latch_.WUnlock();
+}
 
 /*****************************************************************************
- * GETGLOBALDEPTH - DO NOT TOUCH
+ * GETGLOBALDEPTH
  *****************************************************************************/
+/*
+ * With more than one directory this reports the deepest of them; a table whose header has depth 0 has exactly one.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetGlobalDepth() -> uint32_t {
   table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  uint32_t global_depth = dir_page->GetGlobalDepth();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
+  uint32_t global_depth = 0;
+  ForEachDirectoryPage([&global_depth](HashTableDirectoryPage *dir_page) {
+    global_depth = std::max(global_depth, dir_page->GetGlobalDepth());
+  });
   table_latch_.RUnlock();
   return global_depth;
 }
 
 /*****************************************************************************
- * VERIFY INTEGRITY - DO NOT TOUCH
+ * VERIFY INTEGRITY
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::VerifyIntegrity() {
   table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  dir_page->VerifyIntegrity();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
+  ForEachDirectoryPage([](HashTableDirectoryPage *dir_page) { dir_page->VerifyIntegrity(); });
   table_latch_.RUnlock();
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+void HASH_TABLE_TYPE::ForEachDirectoryPage(Visitor &&visit) {
+  auto header_page =
+      reinterpret_cast<ExtendibleHashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_)->GetData());
+  for (uint32_t directory_idx = 0; directory_idx < header_page->MaxSize(); directory_idx++) {
+    page_id_t directory_page_id = header_page->GetDirectoryPageId(directory_idx);
+    if (directory_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    visit(reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id)->GetData()));
+    buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+}
+
 /*****************************************************************************
  * TEMPLATE DEFINITIONS - DO NOT TOUCH
  *****************************************************************************/
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -26,21 +27,186 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  auto header_page =
+      reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->NewPage(&header_page_id_)->GetData());
+  header_page->SetPageId(header_page_id_);
+  size_t num_blocks = std::clamp<size_t>((num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE, 1,
+                                         HashTableHeaderPage::MaxNumBlocks());
+  CreateNewBlockPages(header_page, num_blocks);
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetHeaderPage() -> HashTableHeaderPage * {
+  return reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_)->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE * {
+  return reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(buffer_pool_manager_->FetchPage(block_page_id)->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+auto HASH_TABLE_TYPE::Probe(HashTableHeaderPage *header_page, size_t migrated_blocks, const KeyType &key, bool dirty,
+                            Visitor &&visit) -> std::optional<size_t> {
+  size_t size = header_page->GetSize();
+  size_t slot = hash_fn_.GetHash(key) % size;
+  size_t probed = 0;
+  while (probed < size) {
+    size_t block_index = slot / BLOCK_ARRAY_SIZE;
+    if (block_index < migrated_blocks) {
+      // everything here moved to the new set; step over it like a run of tombstones
+      size_t skipped = std::min(BLOCK_ARRAY_SIZE - slot % BLOCK_ARRAY_SIZE, size - probed);
+      probed += skipped;
+      slot = (slot + skipped) % size;
+      continue;
+    }
+    page_id_t block_page_id = header_page->GetBlockPageId(block_index);
+    if (block_page_id == INVALID_PAGE_ID) {
+      return slot;
+    }
+    HASH_TABLE_BLOCK_TYPE *block = GetBlockPage(block_page_id);
+    for (slot_offset_t bucket_ind = slot % BLOCK_ARRAY_SIZE; bucket_ind < BLOCK_ARRAY_SIZE && probed < size;
+         bucket_ind++, slot++, probed++) {
+      if (!block->IsOccupied(bucket_ind)) {
+        buffer_pool_manager_->UnpinPage(block_page_id, dirty);
+        return slot;
+      }
+      if (visit(block, bucket_ind)) {
+        buffer_pool_manager_->UnpinPage(block_page_id, dirty);
+        return std::nullopt;
+      }
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, dirty);
+    slot %= size;
+  }
+  return std::nullopt;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value)
+    -> bool {
+  bool reused = false;
+  auto free_slot = Probe(header_page, 0, key, true, [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t bucket_ind) {
+    reused = block->ReuseTombstone(bucket_ind, key, value);
+    return reused;
+  });
+  if (reused) {
+    return true;
+  }
+  if (!free_slot.has_value()) {
+    return false;
+  }
+  size_t block_index = *free_slot / BLOCK_ARRAY_SIZE;
+  page_id_t block_page_id = header_page->GetBlockPageId(block_index);
+  HASH_TABLE_BLOCK_TYPE *block;
+  if (block_page_id == INVALID_PAGE_ID) {
+    block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(buffer_pool_manager_->NewPage(&block_page_id)->GetData());
+    header_page->SetBlockPageId(block_index, block_page_id);
+  } else {
+    block = GetBlockPage(block_page_id);
+  }
+  bool inserted = block->Insert(*free_slot % BLOCK_ARRAY_SIZE, key, value);
+  buffer_pool_manager_->UnpinPage(block_page_id, true);
+  if (inserted) {
+    num_occupied_++;
+  }
+  return inserted;
+}
+
+/*
+ * Only reserves the blocks in the header; ResizeInsert allocates each page when the first key lands in it.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks) {
+  for (size_t i = 0; i < num_blocks; i++) {
+    header_page->AddBlockPageId(INVALID_PAGE_ID);
+  }
+  header_page->SetSize(header_page->NumBlocks() * BLOCK_ARRAY_SIZE);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::DeleteBlockPages(HashTableHeaderPage *old_header_page) {
+  page_id_t old_header_page_id = old_header_page->GetPageId();
+  for (size_t i = 0; i < old_header_page->NumBlocks(); i++) {
+    if (old_header_page->GetBlockPageId(i) != INVALID_PAGE_ID) {
+      buffer_pool_manager_->DeletePage(old_header_page->GetBlockPageId(i));
+    }
+  }
+  buffer_pool_manager_->UnpinPage(old_header_page_id, false);
+  buffer_pool_manager_->DeletePage(old_header_page_id);
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  bool found = GetValueLatchFree(transaction, key, result);
+  table_latch_.RUnlock();
+  return found;
 }
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result)
+    -> bool {
+  bool found = false;
+  auto collect = [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t bucket_ind) {
+    if (block->IsReadable(bucket_ind) && comparator_(key, block->KeyAt(bucket_ind)) == 0) {
+      result->push_back(block->ValueAt(bucket_ind));
+      found = true;
+    }
+    return false;
+  };
+  // entries not migrated yet are only in the old block set
+  HashTableHeaderPage *header_page = GetHeaderPage();
+  Probe(header_page, 0, key, false, collect);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    auto old_header_page =
+        reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(old_header_page_id_)->GetData());
+    Probe(old_header_page, next_migrate_slot_ / BLOCK_ARRAY_SIZE, key, false, collect);
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  }
+  return found;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  MigrateSlots();
+  std::vector<ValueType> values;
+  GetValueLatchFree(transaction, key, &values);
+  if (std::find(values.begin(), values.end(), value) != values.end()) {
+    table_latch_.WUnlock();
+    return false;
+  }
+
+  HashTableHeaderPage *header_page = GetHeaderPage();
+  bool inserted = ResizeInsert(header_page, key, value);
+  size_t size = header_page->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+  // a migration ends before the current set is half full (see MIGRATE_SLOTS_PER_OP), so a full set has none running
+  BUSTUB_ASSERT(inserted || old_header_page_id_ == INVALID_PAGE_ID, "block set filled up during a migration");
+  if (!inserted || num_occupied_ * 2 > size) {
+    BeginResize(size);
+  }
+  if (!inserted) {
+    header_page = GetHeaderPage();
+    inserted = ResizeInsert(header_page, key, value);
+    buffer_pool_manager_->UnpinPage(header_page_id_, true);
+  }
+  table_latch_.WUnlock();
+  return inserted;
 }
 
 /*****************************************************************************
@@ -48,21 +214,119 @@ auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.WLock();
+  MigrateSlots();
+  bool removed = false;
+  auto remove = [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t bucket_ind) {
+    if (block->IsReadable(bucket_ind) && comparator_(key, block->KeyAt(bucket_ind)) == 0 &&
+        value == block->ValueAt(bucket_ind)) {
+      block->Remove(bucket_ind);
+      removed = true;
+    }
+    return removed;
+  };
+  HashTableHeaderPage *header_page = GetHeaderPage();
+  Probe(header_page, 0, key, true, remove);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (!removed && old_header_page_id_ != INVALID_PAGE_ID) {
+    auto old_header_page =
+        reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(old_header_page_id_)->GetData());
+    Probe(old_header_page, next_migrate_slot_ / BLOCK_ARRAY_SIZE, key, true, remove);
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  }
+  table_latch_.WUnlock();
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  while (old_header_page_id_ != INVALID_PAGE_ID) {
+    MigrateSlots();
+  }
+  BeginResize(initial_size);
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::BeginResize(size_t initial_size) {
+  size_t num_blocks = std::min((2 * initial_size + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE,
+                               HashTableHeaderPage::MaxNumBlocks());
+  HashTableHeaderPage *header_page = GetHeaderPage();
+  bool grows = num_blocks > header_page->NumBlocks();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (old_header_page_id_ != INVALID_PAGE_ID || !grows) {
+    return;
+  }
+
+  page_id_t new_header_page_id;
+  auto new_header_page =
+      reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->NewPage(&new_header_page_id)->GetData());
+  new_header_page->SetPageId(new_header_page_id);
+  CreateNewBlockPages(new_header_page, num_blocks);
+  buffer_pool_manager_->UnpinPage(new_header_page_id, true);
+
+  old_header_page_id_ = header_page_id_;
+  header_page_id_ = new_header_page_id;
+  next_migrate_slot_ = 0;
+  num_occupied_ = 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MigrateSlots() {
+  if (old_header_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  auto old_header_page =
+      reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(old_header_page_id_)->GetData());
+  size_t block_index = next_migrate_slot_ / BLOCK_ARRAY_SIZE;
+  slot_offset_t begin = next_migrate_slot_ % BLOCK_ARRAY_SIZE;
+  slot_offset_t end = std::min(begin + MIGRATE_SLOTS_PER_OP, BLOCK_ARRAY_SIZE);
+  next_migrate_slot_ += end - begin;
+  page_id_t block_page_id = old_header_page->GetBlockPageId(block_index);
+  if (block_page_id != INVALID_PAGE_ID) {
+    HashTableHeaderPage *header_page = GetHeaderPage();
+    HASH_TABLE_BLOCK_TYPE *block = GetBlockPage(block_page_id);
+    for (slot_offset_t bucket_ind = begin; bucket_ind < end; bucket_ind++) {
+      if (block->IsReadable(bucket_ind)) {
+        // the new set is at least twice the old one, so it always has room
+        [[maybe_unused]] bool inserted =
+            ResizeInsert(header_page, block->KeyAt(bucket_ind), block->ValueAt(bucket_ind));
+        BUSTUB_ASSERT(inserted, "resized block set is full");
+        block->Remove(bucket_ind);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(header_page_id_, true);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+    if (end == BLOCK_ARRAY_SIZE) {
+      // probes skip drained blocks without reading them, so the page can go
+      buffer_pool_manager_->DeletePage(block_page_id);
+      old_header_page->SetBlockPageId(block_index, INVALID_PAGE_ID);
+    }
+  }
+
+  if (next_migrate_slot_ < old_header_page->GetSize()) {
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, true);
+    return;
+  }
+  DeleteBlockPages(old_header_page);
+  old_header_page_id_ = INVALID_PAGE_ID;
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetSize() -> size_t {
-  return 0;
+  table_latch_.RLock();
+  HashTableHeaderPage *header_page = GetHeaderPage();
+  size_t size = header_page->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return size;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
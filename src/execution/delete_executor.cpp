@@ -13,15 +13,55 @@
 #include <memory>
 
 #include "execution/executors/delete_executor.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
 DeleteExecutor::DeleteExecutor(ExecutorContext *exec_ctx, const DeletePlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
-void DeleteExecutor::Init() { throw NotImplementedException("DeleteExecutor is not implemented"); }
+void DeleteExecutor::Init() {
+  child_executor_->Init();
+  done_ = false;
+  auto catalog = exec_ctx_->GetCatalog();
+  table_info_ = catalog->GetTable(plan_->TableOid());
+  indexes_ = catalog->GetTableIndexes(table_info_->name_);
+  index_entries_.assign(indexes_.size(), {});
+}
 
-auto DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool { return false; }
+auto DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
+  if (done_) {
+    return false;
+  }
+  int32_t count = 0;
+  Tuple child_tuple;
+  RID child_rid;
+  while (child_executor_->Next(&child_tuple, &child_rid)) {
+    table_info_->table_->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, child_rid);
+    count++;
+    // Index entries are buffered so that each index sees them sorted, a batch at a time.
+    for (size_t i = 0; i < indexes_.size(); i++) {
+      auto index = indexes_[i]->index_.get();
+      index_entries_[i].emplace_back(
+          child_tuple.KeyFromTuple(table_info_->schema_, *index->GetEntrySchema(), index->GetEntryAttrs()), child_rid);
+    }
+    if (!index_entries_.empty() && index_entries_[0].size() >= INDEX_BATCH_SIZE) {
+      FlushIndexEntries();
+    }
+  }
+  FlushIndexEntries();
+
+  *tuple = Tuple({ValueFactory::GetIntegerValue(count)}, &GetOutputSchema());
+  done_ = true;
+  return true;
+}
+
+void DeleteExecutor::FlushIndexEntries() {
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    indexes_[i]->index_->DeleteEntries(index_entries_[i], exec_ctx_->GetTransaction());
+    index_entries_[i].clear();
+  }
+}
 
 }  // namespace bustub
@@ -11,12 +11,307 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <type_traits>
+
+#include "type/value_factory.h"
+
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+IndexScanExecutor::~IndexScanExecutor() { StopWorkers(); }
+
+void IndexScanExecutor::Init() {
+  StopWorkers();
+  auto catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info_->table_name_);
+  batch_.clear();
+  covering_batch_.clear();
+  batch_index_ = 0;
+  covering_ = false;
+  varlen_ = false;
+  parallel_ = false;
+  point_ = false;
+  point_rids_.clear();
+
+  // Any kind of index answers a point lookup through ScanKey; for hash indexes it is the only way to read them
+  if (plan_->IsPointLookup()) {
+    point_ = true;
+    const auto &key_schema = index_info_->key_schema_;
+    Tuple key({plan_->GetPredKey()->Evaluate(nullptr, key_schema)}, &key_schema);
+    index_info_->index_->ScanKey(key, &point_rids_, exec_ctx_->GetTransaction());
+    return;
+  }
+  if (auto varlen_tree = dynamic_cast<VarlenBPlusTreeIndex *>(index_info_->index_.get()); varlen_tree != nullptr) {
+    varlen_ = true;
+    varlen_iter_ = varlen_tree->GetBeginIterator(plan_->IsReverse());
+    return;
+  }
+  if (auto covering_tree = dynamic_cast<CoveringBPlusTreeIndexForTwoIntegerColumn *>(index_info_->index_.get());
+      covering_tree != nullptr) {
+    covering_ = true;
+    if (plan_->GetParallelism() > 1) {
+      StartWorkers(covering_tree);
+      return;
+    }
+    covering_iter_ = plan_->IsReverse() ? covering_tree->GetReverseIterator(nullptr, nullptr)
+                                        : covering_tree->GetRangeIterator(nullptr, nullptr);
+    return;
+  }
+  auto tree = dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(index_info_->index_.get());
+  if (tree == nullptr) {
+    throw NotImplementedException("IndexScanExecutor only supports b+ tree indexes");
+  }
+  if (plan_->GetParallelism() > 1) {
+    StartWorkers(tree);
+    return;
+  }
+  iter_ = plan_->IsReverse() ? tree->GetReverseIterator(nullptr, nullptr) : tree->GetRangeIterator(nullptr, nullptr);
+}
+
+auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (point_) {
+    return NextPoint(tuple, rid);
+  }
+  if (parallel_) {
+    return NextParallel(tuple, rid);
+  }
+  if (covering_) {
+    return NextCovering(tuple, rid);
+  }
+  if (varlen_) {
+    return NextVarlen(tuple, rid);
+  }
+  while (true) {
+    if (batch_index_ == batch_.size()) {
+      batch_.clear();
+      batch_index_ = 0;
+      if (iter_.NextBatch(&batch_, BATCH_SIZE) == 0) {
+        return false;
+      }
+    }
+    const auto &[key, table_rid] = batch_[batch_index_++];
+    if (EmitEntry(key, table_rid, nullptr, tuple, rid)) {
+      return true;
+    }
+  }
+}
+
+auto IndexScanExecutor::NextCovering(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (batch_index_ == covering_batch_.size()) {
+      covering_batch_.clear();
+      batch_index_ = 0;
+      if (covering_iter_.NextBatch(&covering_batch_, BATCH_SIZE) == 0) {
+        return false;
+      }
+    }
+    const auto &[key, value] = covering_batch_[batch_index_++];
+    if (EmitEntry(key, value.rid_, &value, tuple, rid)) {
+      return true;
+    }
+  }
+}
+
+auto IndexScanExecutor::NextVarlen(Tuple *tuple, RID *rid) -> bool {
+  // The iterator already copies a leaf at a time
+  for (; !varlen_iter_.IsEnd(); ++varlen_iter_) {
+    RID table_rid = (*varlen_iter_).second;
+    if (FetchTuple(table_rid, tuple, rid)) {
+      ++varlen_iter_;
+      return true;
+    }
+  }
+  return false;
+}
+
+auto IndexScanExecutor::NextPoint(Tuple *tuple, RID *rid) -> bool {
+  const auto &filter = plan_->GetFilterPredicate();
+  while (batch_index_ < point_rids_.size()) {
+    if (!FetchTuple(point_rids_[batch_index_++], tuple, rid)) {
+      continue;
+    }
+    if (filter == nullptr) {
+      return true;
+    }
+    auto value = filter->Evaluate(tuple, GetOutputSchema());
+    if (!value.IsNull() && value.GetAs<bool>()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto IndexScanExecutor::NextParallel(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (row_index_ < rows_.size()) {
+      auto &[row, row_rid] = rows_[row_index_++];
+      *tuple = std::move(row);
+      *rid = row_rid;
+      return true;
+    }
+    if (queue_index_ == queues_.size()) {
+      return false;
+    }
+    // An ordered scan drains the sub-ranges one after the other, while the later ones fill their queues meanwhile
+    auto &queue = *queues_[queue_index_];
+    std::unique_lock lock(queue.latch_);
+    queue.cv_.wait(lock, [&queue] { return !queue.batches_.empty() || queue.producers_ == 0; });
+    if (queue.batches_.empty()) {
+      queue_index_++;
+      continue;
+    }
+    rows_ = std::move(queue.batches_.front());
+    row_index_ = 0;
+    queue.batches_.pop_front();
+    lock.unlock();
+    queue.cv_.notify_all();
+  }
+}
+
+template <typename TreeIndex>
+void IndexScanExecutor::StartWorkers(TreeIndex *tree) {
+  parallel_ = true;
+  auto boundaries = tree->GetRangePartitions(nullptr, nullptr, plan_->GetParallelism());
+  size_t partitions = boundaries.size() + 1;
+  size_t queue_count = plan_->IsOrdered() ? partitions : 1;
+  for (size_t i = 0; i < queue_count; i++) {
+    queues_.push_back(std::make_unique<RowQueue>());
+  }
+  // Sub-range i goes to queue i, or to queue partitions - 1 - i for a descending scan; count the producers before
+  // any worker can finish
+  auto queue_of = [&](size_t i) {
+    if (!plan_->IsOrdered()) {
+      return queues_[0].get();
+    }
+    return queues_[plan_->IsReverse() ? partitions - 1 - i : i].get();
+  };
+  for (size_t i = 0; i < partitions; i++) {
+    queue_of(i)->producers_++;
+  }
+  for (size_t i = 0; i < partitions; i++) {
+    std::optional<IntegerKeyType> lower;
+    std::optional<IntegerKeyType> upper;
+    if (i > 0) {
+      lower = boundaries[i - 1];
+    }
+    if (i + 1 < partitions) {
+      upper = boundaries[i];
+    }
+    auto *queue = queue_of(i);
+    workers_.emplace_back([this, tree, lower, upper, queue] { ScanPartition(tree, lower, upper, queue); });
+  }
+}
+
+template <typename TreeIndex>
+void IndexScanExecutor::ScanPartition(TreeIndex *tree, std::optional<IntegerKeyType> lower,
+                                      std::optional<IntegerKeyType> upper, RowQueue *queue) {
+  const IntegerKeyType *lower_key = lower.has_value() ? &*lower : nullptr;
+  const IntegerKeyType *upper_key = upper.has_value() ? &*upper : nullptr;
+  const auto &comparator = tree->GetComparator();
+  auto iter = plan_->IsReverse() ? tree->GetReverseIterator(upper_key, lower_key)
+                                 : tree->GetRangeIterator(lower_key, upper_key);
+  using Entry = std::decay_t<decltype(*iter)>;
+  std::vector<Entry> entries;
+  while (!stopping_ && iter.NextBatch(&entries, BATCH_SIZE) > 0) {
+    std::vector<std::pair<Tuple, RID>> rows;
+    rows.reserve(entries.size());
+    for (const auto &[key, value] : entries) {
+      // The iterators include their bounds, but the upper one starts the next sub-range
+      if (upper_key != nullptr && comparator(key, *upper_key) == 0) {
+        continue;
+      }
+      Tuple tuple;
+      RID rid;
+      bool emitted;
+      if constexpr (std::is_same_v<typename Entry::second_type, RID>) {
+        emitted = EmitEntry(key, value, nullptr, &tuple, &rid);
+      } else {
+        emitted = EmitEntry(key, value.rid_, &value, &tuple, &rid);
+      }
+      if (emitted) {
+        rows.emplace_back(std::move(tuple), rid);
+      }
+    }
+    entries.clear();
+    if (rows.empty()) {
+      continue;
+    }
+    std::unique_lock lock(queue->latch_);
+    queue->cv_.wait(lock, [this, queue] { return queue->batches_.size() < MAX_QUEUED_BATCHES || stopping_; });
+    if (stopping_) {
+      break;
+    }
+    queue->batches_.push_back(std::move(rows));
+    lock.unlock();
+    queue->cv_.notify_all();
+  }
+  {
+    std::lock_guard lock(queue->latch_);
+    queue->producers_--;
+  }
+  queue->cv_.notify_all();
+}
+
+void IndexScanExecutor::StopWorkers() {
+  stopping_ = true;
+  for (auto &queue : queues_) {
+    std::lock_guard lock(queue->latch_);
+    queue->cv_.notify_all();
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  queues_.clear();
+  queue_index_ = 0;
+  rows_.clear();
+  row_index_ = 0;
+  stopping_ = false;
+}
+
+auto IndexScanExecutor::EmitEntry(const IntegerKeyType &key, RID table_rid, const IntegerCoveringValueType *value,
+                                  Tuple *tuple, RID *rid) const -> bool {
+  // Deletes remove their index entries right away, so in an index-only scan every entry is a live row
+  if (plan_->IsIndexOnly()) {
+    *tuple = TupleFromEntry(key, value);
+    *rid = table_rid;
+    return true;
+  }
+  return FetchTuple(table_rid, tuple, rid);
+}
 
-void IndexScanExecutor::Init() { throw NotImplementedException("IndexScanExecutor is not implemented"); }
+auto IndexScanExecutor::FetchTuple(RID table_rid, Tuple *tuple, RID *rid) const -> bool {
+  auto [meta, table_tuple] = table_info_->table_->GetTuple(table_rid);
+  if (meta.is_deleted_) {
+    return false;
+  }
+  *tuple = std::move(table_tuple);
+  *rid = table_rid;
+  return true;
+}
 
-auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto IndexScanExecutor::TupleFromEntry(const IntegerKeyType &key, const IntegerCoveringValueType *value) const
+    -> Tuple {
+  const auto &schema = GetOutputSchema();
+  const auto *metadata = index_info_->index_->GetMetadata();
+  std::vector<Value> values;
+  values.reserve(schema.GetColumnCount());
+  for (const auto &column : schema.GetColumns()) {
+    values.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+  }
+  const auto &key_attrs = metadata->GetKeyAttrs();
+  for (uint32_t i = 0; i < key_attrs.size(); i++) {
+    values[key_attrs[i]] = key.ToValue(metadata->GetKeySchema(), i);
+  }
+  if (value != nullptr) {
+    const auto &include_attrs = metadata->GetIncludeAttrs();
+    for (uint32_t i = 0; i < include_attrs.size(); i++) {
+      values[include_attrs[i]] = value->ToValue(metadata->GetIncludeSchema(), i);
+    }
+  }
+  return Tuple(std::move(values), &schema);
+}
 
 }  // namespace bustub
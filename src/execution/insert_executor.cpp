@@ -13,15 +13,58 @@
 #include <memory>
 
 #include "execution/executors/insert_executor.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
 InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
-void InsertExecutor::Init() { throw NotImplementedException("InsertExecutor is not implemented"); }
+void InsertExecutor::Init() {
+  child_executor_->Init();
+  done_ = false;
+  auto catalog = exec_ctx_->GetCatalog();
+  table_info_ = catalog->GetTable(plan_->TableOid());
+  indexes_ = catalog->GetTableIndexes(table_info_->name_);
+  index_entries_.assign(indexes_.size(), {});
+}
 
-auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool { return false; }
+auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
+  if (done_) {
+    return false;
+  }
+  int32_t count = 0;
+  Tuple child_tuple;
+  RID child_rid;
+  while (child_executor_->Next(&child_tuple, &child_rid)) {
+    auto inserted_rid = table_info_->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, child_tuple);
+    if (!inserted_rid.has_value()) {
+      continue;
+    }
+    count++;
+    // Index entries are buffered so that each index sees them sorted, a batch at a time.
+    for (size_t i = 0; i < indexes_.size(); i++) {
+      auto index = indexes_[i]->index_.get();
+      auto entry = child_tuple.KeyFromTuple(table_info_->schema_, *index->GetEntrySchema(), index->GetEntryAttrs());
+      index_entries_[i].emplace_back(std::move(entry), *inserted_rid);
+    }
+    if (!index_entries_.empty() && index_entries_[0].size() >= INDEX_BATCH_SIZE) {
+      FlushIndexEntries();
+    }
+  }
+  FlushIndexEntries();
+
+  *tuple = Tuple({ValueFactory::GetIntegerValue(count)}, &GetOutputSchema());
+  done_ = true;
+  return true;
+}
+
+void InsertExecutor::FlushIndexEntries() {
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    indexes_[i]->index_->InsertEntries(index_entries_[i], exec_ctx_->GetTransaction());
+    index_entries_[i].clear();
+  }
+}
 
 }  // namespace bustub
@@ -12,19 +12,78 @@
 
 #include "execution/executors/nested_index_join_executor.h"
 
+#include "type/value_factory.h"
+
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2023 Spring: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void NestIndexJoinExecutor::Init() { throw NotImplementedException("NestIndexJoinExecutor is not implemented"); }
+void NestIndexJoinExecutor::Init() {
+  child_executor_->Init();
+  auto catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(plan_->GetInnerTableOid());
+  inner_rids_.clear();
+  inner_index_ = 0;
+  has_outer_ = false;
+}
+
+auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (has_outer_) {
+      while (inner_index_ < inner_rids_.size()) {
+        auto [meta, inner_tuple] = table_info_->table_->GetTuple(inner_rids_[inner_index_++]);
+        if (meta.is_deleted_) {
+          continue;
+        }
+        matched_ = true;
+        *tuple = JoinTuples(&inner_tuple);
+        return true;
+      }
+      has_outer_ = false;
+      if (!matched_ && plan_->GetJoinType() == JoinType::LEFT) {
+        *tuple = JoinTuples(nullptr);
+        return true;
+      }
+    }
 
-auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+    RID outer_rid;
+    if (!child_executor_->Next(&outer_tuple_, &outer_rid)) {
+      return false;
+    }
+    has_outer_ = true;
+    matched_ = false;
+    inner_rids_.clear();
+    inner_index_ = 0;
+    // One probe per outer row; a NULL key equals nothing
+    auto key_value = plan_->KeyPredicate()->Evaluate(&outer_tuple_, child_executor_->GetOutputSchema());
+    if (!key_value.IsNull()) {
+      Tuple key({key_value}, &index_info_->key_schema_);
+      index_info_->index_->ScanKey(key, &inner_rids_, exec_ctx_->GetTransaction());
+    }
+  }
+}
+
+auto NestIndexJoinExecutor::JoinTuples(const Tuple *inner_tuple) const -> Tuple {
+  const auto &outer_schema = child_executor_->GetOutputSchema();
+  const auto &inner_schema = plan_->InnerTableSchema();
+  std::vector<Value> values;
+  values.reserve(GetOutputSchema().GetColumnCount());
+  for (uint32_t i = 0; i < outer_schema.GetColumnCount(); i++) {
+    values.push_back(outer_tuple_.GetValue(&outer_schema, i));
+  }
+  for (uint32_t i = 0; i < inner_schema.GetColumnCount(); i++) {
+    values.push_back(inner_tuple == nullptr ? ValueFactory::GetNullValueByType(inner_schema.GetColumn(i).GetType())
+                                            : inner_tuple->GetValue(&inner_schema, i));
+  }
+  return Tuple(std::move(values), &GetOutputSchema());
+}
 
 }  // namespace bustub
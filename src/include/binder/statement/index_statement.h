@@ -21,7 +21,8 @@ namespace bustub {
 class IndexStatement : public BoundStatement {
  public:
   explicit IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                          std::vector<std::unique_ptr<BoundColumnRef>> cols);
+                          std::vector<std::unique_ptr<BoundColumnRef>> cols, std::string index_type,
+                          std::vector<std::unique_ptr<BoundColumnRef>> include_cols = {}, bool bloom_filter = false);
 
   /** Name of the index */
   std::string index_name_;
@@ -32,6 +33,15 @@ class IndexStatement : public BoundStatement {
   /** Name of the columns */
   std::vector<std::unique_ptr<BoundColumnRef>> cols_;
 
+  /** Access method from the `USING` clause, empty if none was given */
+  std::string index_type_;
+
+  /** Columns stored in the index without being part of the key, from `WITH (include = '...')` */
+  std::vector<std::unique_ptr<BoundColumnRef>> include_cols_;
+
+  /** Whether to keep a Bloom filter over the keys, from `WITH (bloom_filter = 'true')` */
+  bool bloom_filter_;
+
   auto ToString() const -> std::string override;
 };
 
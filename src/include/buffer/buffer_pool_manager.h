@@ -190,9 +190,17 @@ class BufferPoolManager {
   std::unique_ptr<LRUKReplacer> replacer_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** This latch protects the page table, the free list and the book-keeping fields of every frame. */
   std::mutex latch_;
 
+  /**
+   * @brief Take a frame from the free list, or evict one through the replacer (writing it back if dirty).
+   * Caller must hold latch_.
+   * @param[out] frame_id the frame that is now free to hold a new page
+   * @return false if every frame is pinned
+   */
+  auto AcquireFrame(frame_id_t *frame_id) -> bool;
+
   /**
    * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
    * @return the id of the allocated page
@@ -206,7 +214,5 @@ class BufferPoolManager {
   void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
     // This is a no-nop right now without a more complex data structure to track deallocated pages
   }
-
-  // TODO(student): You may add additional private members and helper functions
 };
 }  // namespace bustub
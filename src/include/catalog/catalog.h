@@ -24,6 +24,7 @@
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/index/varlen_b_plus_tree_index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -35,6 +36,9 @@ using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
 using index_oid_t = uint32_t;
 
+/** The kind of index backing an IndexInfo */
+enum class IndexType { BPlusTreeIndex, BLinkTreeIndex, HashTableIndex };
+
 /**
  * The TableInfo class maintains metadata about a table.
  */
@@ -70,15 +74,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The kind of index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,6 +97,8 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The kind of index */
+  const IndexType index_type_;
 };
 
 /**
@@ -192,16 +200,21 @@ class Catalog {
    * @param index_name The name of the new index
    * @param table_name The name of the table
    * @param schema The schema of the table
-   * @param key_schema The schema of the key
+   * @param key_schema The schema of the key; if it is not inlined, the index is a VarlenBPlusTreeIndex and the template
+   * arguments are unused. Hash indexes need an inlined key.
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param index_type The kind of index to build
+   * @param include_attrs Columns stored in the leaves next to each key, for a covering ValueType (see CoveringValue);
+   * hash indexes map keys to RIDs and take none
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, IndexType index_type = IndexType::BPlusTreeIndex,
+                   const std::vector<uint32_t> &include_attrs = {}) -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -218,29 +231,55 @@ class Catalog {
     }
 
     // Construct index metdata
-    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs, include_attrs);
 
     // Construct the index, take ownership of metadata
     // TODO(Kyle): We should update the API for CreateIndex
     // to allow specification of the index type itself, not
     // just the key, value, and comparator types
 
-    // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
-
-    // Populate the index with all tuples in table heap
     auto *table_meta = GetTable(table_name);
-    for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
-      auto [meta, tuple] = iter.GetTuple();
-      index->InsertEntry(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid(), txn);
+    std::unique_ptr<Index> index;
+    if (index_type == IndexType::HashTableIndex) {
+      // Only answers point lookups, each with a fixed number of page fetches however large the table grows
+      BUSTUB_ASSERT(key_schema.IsInlined(), "hash indexes need fixed-length keys");
+      index = std::make_unique<ExtendibleHashTableIndex<KeyType, RID, KeyComparator>>(std::move(meta), bpm_,
+                                                                                       hash_function);
+      for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
+        auto [meta, tuple] = iter.GetTuple();
+        index->InsertEntry(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid(), txn);
+      }
+    } else if (!key_schema.IsInlined()) {
+      // Variable-length keys do not fit a fixed-size KeyType, so they go to a tree over slotted pages
+      index = std::make_unique<VarlenBPlusTreeIndex>(std::move(meta), bpm_);
+      for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
+        auto [meta, tuple] = iter.GetTuple();
+        index->InsertEntry(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid(), txn);
+      }
+    } else {
+      auto mode = index_type == IndexType::BLinkTreeIndex ? BPlusTreeMode::B_LINK : BPlusTreeMode::LATCH_CRABBING;
+      auto tree_index =
+          std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_, mode);
+
+      // Populate the index with all tuples in table heap, building the tree bottom-up instead of inserting one by one
+      std::vector<std::pair<KeyType, ValueType>> entries;
+      for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
+        auto [meta, tuple] = iter.GetTuple();
+        auto entry = tuple.KeyFromTuple(schema, *tree_index->GetEntrySchema(), tree_index->GetEntryAttrs());
+        entries.push_back(tree_index->MakeEntry(entry, tuple.GetRid()));
+      }
+      if (!entries.empty()) {
+        tree_index->BulkLoad(std::move(entries));
+      }
+      index = std::move(tree_index);
     }
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
 
     // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
     auto *tmp = index_info.get();
 
     // Update internal tracking
@@ -298,7 +337,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
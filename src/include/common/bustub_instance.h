@@ -275,6 +275,14 @@ class BustubInstance {
     return variable == "1" || variable == "true" || variable == "yes";
   }
 
+  /** @return number of threads an index scan may use, set by `set index_scan_parallelism=N` */
+  auto GetIndexScanParallelism() -> size_t {
+    auto variable = GetSessionVariable("index_scan_parallelism");
+    int parallelism = 1;
+    std::istringstream(variable) >> parallelism;
+    return parallelism > 1 ? parallelism : 1;
+  }
+
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
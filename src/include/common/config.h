@@ -36,6 +36,16 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr double BPLUS_TREE_FILL_FACTOR = 0.9;  // share of each page filled by the b+ tree bulk loader
+static constexpr double BPLUS_TREE_APPEND_SPLIT_KEEP = 0.9;  // share of pairs a rightmost b+ tree leaf keeps on append
+static constexpr size_t BPLUS_TREE_READ_AHEAD_LEAVES = 4;  // leaves pinned ahead of a b+ tree range scan
+static constexpr size_t BPLUS_TREE_CONSOLIDATE_BATCH = 64;  // underfull leaves a lazy-merge b+ tree fixes per round
+static constexpr size_t BPLUS_TREE_CONSOLIDATE_BUSY_LEAVES = 64;  // newly underfull leaves that defer a round
+static constexpr size_t BPLUS_TREE_CONSOLIDATE_MAX_BACKLOG = 4096;  // underfull leaves consolidated even when busy
+static constexpr std::chrono::milliseconds BPLUS_TREE_CONSOLIDATE_INTERVAL{50};  // period of lazy-merge consolidation
+static constexpr size_t INDEX_BATCH_SIZE = 65536;  // index entries insert/delete executors apply as one batch
+static constexpr size_t BLOOM_FILTER_BITS_PER_KEY = 10;  // bits per key of index bloom filters, ~1% false positives
+static constexpr size_t BLOOM_FILTER_MIN_CAPACITY = 1024;  // keys the smallest index bloom filter is sized for
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
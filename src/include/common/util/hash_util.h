@@ -13,7 +13,9 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -28,14 +30,73 @@ class HashUtil {
  private:
   static const hash_t PRIME_FACTOR = 10000019;
 
+  /** Odd 64-bit constants with balanced bits, as used by wyhash */
+  static constexpr uint64_t SECRET[4] = {0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL,
+                                         0x589965cc75374cc3ULL};
+
+  /** @return the 128-bit product of a and b, folded to 64 bits */
+  static inline auto Mum(uint64_t a, uint64_t b) -> uint64_t {
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+  }
+
+  static inline auto Read64(const uint8_t *bytes) -> uint64_t {
+    uint64_t v;
+    std::memcpy(&v, bytes, sizeof(v));
+    return v;
+  }
+
+  static inline auto Read32(const uint8_t *bytes) -> uint64_t {
+    uint32_t v;
+    std::memcpy(&v, bytes, sizeof(v));
+    return v;
+  }
+
  public:
-  static inline auto HashBytes(const char *bytes, size_t length) -> hash_t {
-    // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
-    hash_t hash = length;
-    for (size_t i = 0; i < length; ++i) {
-      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+  /**
+   * Hash a byte string, wyhash-style: keys of up to 16 bytes are read with at most four overlapping loads and mixed
+   * with two 64x64->128-bit multiplications, longer ones 16 or 48 bytes per multiplication. All 64 bits of the result
+   * are usable, so callers may take any of them as bucket or fingerprint bits.
+   */
+  static inline auto HashBytes(const char *bytes, size_t length, uint64_t seed = 0) -> hash_t {
+    const auto *p = reinterpret_cast<const uint8_t *>(bytes);
+    seed ^= Mum(seed ^ SECRET[0], SECRET[1]);
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (length <= 16) {
+      if (length >= 4) {
+        // For 4..16 bytes, the two 8-byte halves are each read as a front and a back 4-byte word
+        size_t middle = (length >> 3) << 2;
+        a = (Read32(p) << 32) | Read32(p + middle);
+        b = (Read32(p + length - 4) << 32) | Read32(p + length - 4 - middle);
+      } else if (length > 0) {
+        a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+      }
+    } else {
+      size_t remaining = length;
+      if (remaining > 48) {
+        uint64_t seed1 = seed;
+        uint64_t seed2 = seed;
+        do {
+          seed = Mum(Read64(p) ^ SECRET[1], Read64(p + 8) ^ seed);
+          seed1 = Mum(Read64(p + 16) ^ SECRET[2], Read64(p + 24) ^ seed1);
+          seed2 = Mum(Read64(p + 32) ^ SECRET[3], Read64(p + 40) ^ seed2);
+          p += 48;
+          remaining -= 48;
+        } while (remaining > 48);
+        seed ^= seed1 ^ seed2;
+      }
+      while (remaining > 16) {
+        seed = Mum(Read64(p) ^ SECRET[1], Read64(p + 8) ^ seed);
+        p += 16;
+        remaining -= 16;
+      }
+      // The last 16 bytes, overlapping the ones already mixed if need be
+      a = Read64(p + remaining - 16);
+      b = Read64(p + remaining - 8);
     }
-    return hash;
+    __uint128_t product = static_cast<__uint128_t>(a ^ SECRET[1]) * (b ^ seed);
+    return Mum(static_cast<uint64_t>(product) ^ SECRET[0] ^ length, static_cast<uint64_t>(product >> 64) ^ SECRET[1]);
   }
 
   static inline auto CombineHashes(hash_t l, hash_t r) -> hash_t {
@@ -19,6 +19,7 @@
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/transaction.h"
 #include "container/hash/hash_function.h"
+#include "storage/page/extendible_hash_table_header_page.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
 
@@ -30,6 +31,15 @@ namespace bustub {
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table grows/shrinks dynamically as buckets become full/empty.
+ *
+ * Pages form a header -> directory -> bucket hierarchy. The header picks a directory by the top bits of the hash and
+ * the directory picks a bucket by the low bits, so a lookup fetches at most three pages however large the table is.
+ * Each directory is one page and holds up to DIRECTORY_ARRAY_SIZE buckets; a header of depth d multiplies that by
+ * 2^d.
+ *
+ * Concurrency: lookups, removals and inserts that fit in their bucket hold table_latch_ in shared mode, which keeps
+ * the directory stable, and latch only the bucket page they touch. Splits and merges restart with table_latch_ held
+ * exclusively and re-check their condition, since the bucket may have changed in between.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class DiskExtendibleHashTable {
@@ -40,9 +50,12 @@ class DiskExtendibleHashTable {
    * @param buffer_pool_manager buffer pool manager to be used
    * @param comparator comparator for keys
    * @param hash_fn the hash function
+   * @param header_max_depth the number of top hash bits used to pick a directory page, at most HEADER_MAX_DEPTH;
+   * the default of 0 keeps the whole table in a single directory
    */
   explicit DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                   uint32_t header_max_depth = 0);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -75,12 +88,12 @@ class DiskExtendibleHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Returns the global depth
+   * Returns the global depth, the largest one over all directories
    */
   auto GetGlobalDepth() -> uint32_t;
 
   /**
-   * Helper function to verify the integrity of the extendible hash table's directory.
+   * Helper function to verify the integrity of each of the extendible hash table's directories.
    */
   void VerifyIntegrity();
 
@@ -122,22 +135,24 @@ class DiskExtendibleHashTable {
   auto KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t;
 
   /**
-   * Fetches the directory page from the buffer pool manager.
+   * Fetches the directory page covering a key from the buffer pool manager, going through the header page.
    *
-   * @return a pointer to the directory page
+   * @param key the key whose directory to fetch
+   * @param[out] directory_page_id the page_id of the directory, which the caller unpins when done
+   * @param create whether to create the directory if it does not exist yet; requires table_latch_ held exclusively
+   * @return a pointer to the directory page, or nullptr if it does not exist and create is false
    */
-  auto FetchDirectoryPage() -> HashTableDirectoryPage *;
+  auto FetchDirectoryPage(KeyType key, page_id_t *directory_page_id, bool create = false) -> HashTableDirectoryPage *;
 
   /**
-   * Fetches the a bucket page from the buffer pool manager using the bucket's page_id.
-   *
-   * @param bucket_page_id the page_id to fetch
-   * @return a pointer to a bucket page
+   * Calls visit on every directory page the header points at. The caller holds table_latch_.
    */
-  auto FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE *;
+  template <typename Visitor>
+  void ForEachDirectoryPage(Visitor &&visit);
 
   /**
-   * Performs insertion with an optional bucket splitting.
+   * Performs insertion with an optional bucket splitting. Called with no latch held once the target bucket was
+   * found full; it takes table_latch_ exclusively and splits until the key's bucket has room.
    *
    * @param transaction a pointer to the current transaction
    * @param key the key to insert
@@ -162,11 +177,11 @@ class DiskExtendibleHashTable {
   void Merge(Transaction *transaction, const KeyType &key, const ValueType &value);
 
   // member variables
-  page_id_t directory_page_id_;
+  page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writers are splits and merges
+  // Readers include lookups, inserts and removes, which also latch their bucket page; writers are splits and merges
   ReaderWriterLatch table_latch_;
   HashFunction<KeyType> hash_fn_;
 };
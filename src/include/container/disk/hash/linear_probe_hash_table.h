@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <queue>
 #include <string>
 #include <vector>
@@ -30,6 +31,12 @@ namespace bustub {
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Growing is incremental. Once half the slots are occupied, the table makes a block set twice the size current and
+ * keeps the old set around. From then on every insert and remove first migrates the next MIGRATE_SLOTS_PER_OP old
+ * slots into the new set, leaving tombstones so the old probe chains stay intact, and deletes each old block page
+ * once it is drained. Lookups probe both sets until the whole old set is drained. Block pages are allocated on first
+ * insert, so no single operation allocates, moves or frees more than a small, fixed amount.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable {
@@ -73,7 +80,8 @@ class LinearProbeHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Resizes the table to at least twice the initial size provided. Entries move over incrementally afterwards; a
+   * migration still in progress from an earlier resize is finished first.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
@@ -87,17 +95,57 @@ class LinearProbeHashTable {
  private:
   auto GetHeaderPage() -> HashTableHeaderPage *;
   auto GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE *;
-  void ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value);
+
+  /**
+   * Walks the probe chain of key in the block set under header_page, calling visit(block, bucket_ind) on each
+   * occupied slot, tombstones included, until visit returns true or an unoccupied slot ends the chain. Blocks without
+   * a page are empty, except the first migrated_blocks of a set being drained, which count as all tombstones.
+   *
+   * @param dirty whether visit may modify the blocks
+   * @return the unoccupied slot that ended the chain, or nothing if visit stopped the walk or the set is full
+   */
+  template <typename Visitor>
+  auto Probe(HashTableHeaderPage *header_page, size_t migrated_blocks, const KeyType &key, bool dirty,
+             Visitor &&visit) -> std::optional<size_t>;
+
+  /**
+   * Inserts into the block set under header_page without checking for duplicates, into the first tombstone on the
+   * key's chain if there is one and otherwise into the unoccupied slot that ends it, allocating the block page if
+   * needed; the caller unpins header_page as dirty.
+   * @return false if every slot in the block set holds an entry
+   */
+  auto ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value) -> bool;
   void DeleteBlockPages(HashTableHeaderPage *old_header_page);
   void CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks);
   auto GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
+  /**
+   * Makes a block set of at least 2 * initial_size slots current and starts draining the old one into it. Does
+   * nothing if a migration is already running or one header page cannot address a bigger set.
+   */
+  void BeginResize(size_t initial_size);
+
+  /** Moves the next MIGRATE_SLOTS_PER_OP old slots, if a migration is running, into the current block set. */
+  void MigrateSlots();
+
+  // Old slots each write migrates. Draining N old slots takes N / MIGRATE_SLOTS_PER_OP writes, which must finish
+  // before the new set of 2N slots is half full again; any value above 2 guarantees that. So the current set never
+  // fills up while a migration is running, and no write has to drain the rest of one.
+  static constexpr size_t MIGRATE_SLOTS_PER_OP = 32;
+
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // Header of the block set being drained by an incremental resize, INVALID_PAGE_ID when none is
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  // Index of the next old slot to migrate; blocks before it have been deleted
+  size_t next_migrate_slot_{0};
+  // Occupied slots, tombstones included, in the current block set; it triggers the next resize
+  size_t num_occupied_{0};
+
+  // Readers are lookups; inserts and removes are writers, since they also migrate blocks during a resize
   ReaderWriterLatch table_latch_;
 
   // Hash function
@@ -12,25 +12,41 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
+#include "common/util/hash_util.h"
 #include "murmur3/MurmurHash3.h"
 
 namespace bustub {
 
-template <typename KeyType>
+/** Hash policy for HashFunction: MurmurHash3 x64-128, keeping the first 64 bits */
+struct MurmurHash3Policy {
+  static auto Hash(const void *data, size_t length) -> uint64_t {
+    uint64_t hash[2];
+    murmur3::MurmurHash3_x64_128(data, static_cast<int>(length), 0, reinterpret_cast<void *>(&hash));
+    return hash[0];
+  }
+};
+
+/**
+ * Hash policy for HashFunction: the 64-bit HashUtil::HashBytes, which mixes a key of up to 16 bytes with two
+ * multiplications instead of computing 128 bits and dropping half.
+ */
+struct FastHashPolicy {
+  static auto Hash(const void *data, size_t length) -> uint64_t {
+    return HashUtil::HashBytes(static_cast<const char *>(data), length);
+  }
+};
+
+template <typename KeyType, typename HashPolicy = FastHashPolicy>
 class HashFunction {
  public:
   /**
    * @param key the key to be hashed
    * @return the hashed value
    */
-  virtual auto GetHash(KeyType key) -> uint64_t {
-    uint64_t hash[2];
-    murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
-                                 reinterpret_cast<void *>(&hash));
-    return hash[0];
-  }
+  virtual auto GetHash(KeyType key) -> uint64_t { return HashPolicy::Hash(&key, sizeof(KeyType)); }
 };
 
 }  // namespace bustub
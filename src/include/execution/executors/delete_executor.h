@@ -56,9 +56,19 @@ class DeleteExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
+  /** Apply the buffered entries of every index as one batch each. */
+  void FlushIndexEntries();
+
   /** The delete plan node to be executed */
   const DeletePlanNode *plan_;
   /** The child executor from which RIDs for deleted tuples are pulled */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The count has been emitted */
+  bool done_{false};
+
+  const TableInfo *table_info_{nullptr};
+  std::vector<IndexInfo *> indexes_;
+  /** Entries waiting to be removed from each of `indexes_`, up to INDEX_BATCH_SIZE rows */
+  std::vector<std::vector<std::pair<Tuple, RID>>> index_entries_;
 };
 }  // namespace bustub
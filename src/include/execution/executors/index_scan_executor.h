@@ -12,18 +12,35 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/index_scan_plan.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/index/varlen_b_plus_tree_index.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * IndexScanExecutor executes an index scan over a table.
+ *
+ * A parallel scan (IndexScanPlanNode::GetParallelism() > 1) splits the key range of a B+ tree index at internal-page
+ * separators and scans each sub-range on its own thread, which also reads the rows from the table heap. Next hands
+ * out the rows sub-range by sub-range for an ordered scan, or as they arrive otherwise.
+ *
+ * A point lookup (IndexScanPlanNode::IsPointLookup()) probes the index once for its key, which works for hash indexes
+ * as well as trees, and filters the rows found with the plan's predicate.
  */
 
 class IndexScanExecutor : public AbstractExecutor {
@@ -35,6 +52,8 @@ class IndexScanExecutor : public AbstractExecutor {
    */
   IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan);
 
+  ~IndexScanExecutor() override;
+
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
   void Init() override;
@@ -42,7 +61,97 @@ class IndexScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Number of (key, rid) pairs taken from the index per leaf latch hold */
+  static constexpr size_t BATCH_SIZE = 128;
+
+  /** Batches of rows a parallel scan worker may have queued before it waits for Next to catch up */
+  static constexpr size_t MAX_QUEUED_BATCHES = 8;
+
+  /** Rows handed from the workers of a parallel scan to Next */
+  struct RowQueue {
+    std::mutex latch_;
+    /** Signalled when a batch is added or taken, and when a worker finishes */
+    std::condition_variable cv_;
+    std::deque<std::vector<std::pair<Tuple, RID>>> batches_;
+    /** Workers still adding to this queue */
+    size_t producers_{0};
+  };
+
+  /** Next for covering indexes */
+  auto NextCovering(Tuple *tuple, RID *rid) -> bool;
+
+  /** Next for indexes with variable-length keys, which always read the rows from the table */
+  auto NextVarlen(Tuple *tuple, RID *rid) -> bool;
+
+  /** Next for point lookups */
+  auto NextPoint(Tuple *tuple, RID *rid) -> bool;
+
+  /** Next for parallel scans */
+  auto NextParallel(Tuple *tuple, RID *rid) -> bool;
+
+  /** Split the key range of `tree` and start one worker per sub-range. */
+  template <typename TreeIndex>
+  void StartWorkers(TreeIndex *tree);
+
+  /**
+   * Worker of a parallel scan: scan the sub-range [lower, upper) of `tree`, either bound unlimited when empty, and
+   * queue the rows.
+   */
+  template <typename TreeIndex>
+  void ScanPartition(TreeIndex *tree, std::optional<IntegerKeyType> lower, std::optional<IntegerKeyType> upper,
+                     RowQueue *queue);
+
+  /** Stop and join the workers of a parallel scan and drop the rows they queued. */
+  void StopWorkers();
+
+  /**
+   * Build the output row for an index entry: from the entry itself for index-only scans (`value` is its covering
+   * value, if any), from the table heap otherwise.
+   * @return false if the row was deleted
+   */
+  auto EmitEntry(const IntegerKeyType &key, RID table_rid, const IntegerCoveringValueType *value, Tuple *tuple,
+                 RID *rid) const -> bool;
+
+  /** Read the row an index entry points to; false if it was deleted */
+  auto FetchTuple(RID table_rid, Tuple *tuple, RID *rid) const -> bool;
+
+  /**
+   * Build an output row from an index entry, for index-only scans: the key columns, plus the included columns when
+   * `value` comes from a covering index. Other columns are NULL.
+   */
+  auto TupleFromEntry(const IntegerKeyType &key, const IntegerCoveringValueType *value) const -> Tuple;
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+
+  const TableInfo *table_info_{nullptr};
+  const IndexInfo *index_info_{nullptr};
+  BPlusTreeIndexIteratorForTwoIntegerColumn iter_;
+  /** Pairs copied out of the current leaf, and the next one to emit */
+  std::vector<std::pair<IntegerKeyType, IntegerValueType>> batch_;
+  size_t batch_index_{0};
+
+  /** Used instead of iter_ and batch_ when the index is a covering one */
+  bool covering_{false};
+  CoveringBPlusTreeIndexIteratorForTwoIntegerColumn covering_iter_;
+  std::vector<std::pair<IntegerKeyType, IntegerCoveringValueType>> covering_batch_;
+
+  /** Used instead of iter_ and batch_ when the index has variable-length keys */
+  bool varlen_{false};
+  VarlenIndexIterator varlen_iter_;
+
+  /** Point lookups: the RIDs the index returned for the key, emitted from batch_index_ on */
+  bool point_{false};
+  std::vector<RID> point_rids_;
+
+  /** Parallel scans: one queue per sub-range in output order when ordered, a single shared one otherwise */
+  bool parallel_{false};
+  std::vector<std::unique_ptr<RowQueue>> queues_;
+  size_t queue_index_{0};
+  /** Batch taken from a queue, and the next row to emit */
+  std::vector<std::pair<Tuple, RID>> rows_;
+  size_t row_index_{0};
+  std::atomic<bool> stopping_{false};
+  std::vector<std::thread> workers_;
 };
 }  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -55,8 +56,20 @@ class InsertExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
+  /** Apply the buffered entries of every index as one batch each. */
+  void FlushIndexEntries();
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
+  /** The child executor from which inserted tuples are pulled */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The count has been emitted */
+  bool done_{false};
+
+  const TableInfo *table_info_{nullptr};
+  std::vector<IndexInfo *> indexes_;
+  /** Entries waiting to go into each of `indexes_`, up to INDEX_BATCH_SIZE rows */
+  std::vector<std::vector<std::pair<Tuple, RID>>> index_entries_;
 };
 
 }  // namespace bustub
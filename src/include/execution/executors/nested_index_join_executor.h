@@ -28,7 +28,8 @@
 namespace bustub {
 
 /**
- * IndexJoinExecutor executes index join operations.
+ * IndexJoinExecutor executes index join operations: for each outer row it probes the inner table's index with the
+ * join key, with a single ScanKey whether the index is a B+ tree or a hash table.
  */
 class NestIndexJoinExecutor : public AbstractExecutor {
  public:
@@ -48,7 +49,21 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
  private:
+  /** Concatenate the current outer row with `inner_tuple`, or with NULLs when it is nullptr */
+  auto JoinTuples(const Tuple *inner_tuple) const -> Tuple;
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  const IndexInfo *index_info_{nullptr};
+  const TableInfo *table_info_{nullptr};
+
+  /** The outer row being joined, the inner RIDs its key matched and the next one to emit */
+  Tuple outer_tuple_;
+  bool has_outer_{false};
+  /** Whether a live inner row matched the outer row, for left joins */
+  bool matched_{false};
+  std::vector<RID> inner_rids_;
+  size_t inner_index_{0};
 };
 }  // namespace bustub
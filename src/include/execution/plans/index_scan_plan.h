@@ -29,25 +29,107 @@ class IndexScanPlanNode : public AbstractPlanNode {
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
    * @param table_oid the identifier of table to be scanned
+   * @param reverse whether to scan the index in descending key order
+   * @param index_only whether to build the output from the index entries alone, without reading the table heap
+   * @param parallelism number of key sub-ranges scanned concurrently
+   * @param ordered whether a parallel scan must still produce its rows in key order
    */
-  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
-      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, bool reverse = false, bool index_only = false,
+                    size_t parallelism = 1, bool ordered = true)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        reverse_(reverse),
+        index_only_(index_only),
+        parallelism_(parallelism),
+        ordered_(ordered) {}
+
+  /**
+   * Creates a point lookup, which probes the index for a single key instead of scanning it.
+   * @param output the output format of this scan plan node
+   * @param index_oid the identifier of the index to probe
+   * @param filter_predicate predicate the rows found must also satisfy, nullptr if none
+   * @param pred_key constant expression giving the key to look up
+   */
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, AbstractExpressionRef filter_predicate,
+                    AbstractExpressionRef pred_key)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        reverse_(false),
+        index_only_(false),
+        parallelism_(1),
+        ordered_(true),
+        filter_predicate_(std::move(filter_predicate)),
+        pred_key_(std::move(pred_key)) {}
 
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
   /** @return the identifier of the table that should be scanned */
   auto GetIndexOid() const -> index_oid_t { return index_oid_; }
 
+  /** @return true if the index is scanned in descending key order */
+  auto IsReverse() const -> bool { return reverse_; }
+
+  /** @return true if the output comes from a covering index alone */
+  auto IsIndexOnly() const -> bool { return index_only_; }
+
+  /** @return number of key sub-ranges scanned concurrently, 1 for a serial scan */
+  auto GetParallelism() const -> size_t { return parallelism_; }
+
+  /** @return true if the rows must come out in key order (always the case for a serial scan) */
+  auto IsOrdered() const -> bool { return ordered_; }
+
+  /** @return true if the scan probes the index for the single key GetPredKey() */
+  auto IsPointLookup() const -> bool { return pred_key_ != nullptr; }
+
+  /** @return the key a point lookup probes for, nullptr for a full scan */
+  auto GetPredKey() const -> const AbstractExpressionRef & { return pred_key_; }
+
+  /** @return the predicate the rows of a point lookup are filtered with, nullptr if none */
+  auto GetFilterPredicate() const -> const AbstractExpressionRef & { return filter_predicate_; }
+
   BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(IndexScanPlanNode);
 
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** Scan from the largest key down, for descending order-bys */
+  bool reverse_;
+
+  /**
+   * Answer the scan from a covering index without touching the table heap. Output columns that are neither key nor
+   * included columns of the index are NULL; the optimizer only sets this when no parent reads them.
+   */
+  bool index_only_;
+
+  /**
+   * Split the key range into this many sub-ranges and scan them on as many threads. An ordered scan emits the
+   * sub-ranges one after the other; an unordered one emits rows as soon as any sub-range produces them.
+   */
+  size_t parallelism_;
+  bool ordered_;
+
+  /**
+   * Point lookups only: the whole predicate the lookup was planned from, re-checked on each row found, and the
+   * constant the indexed column must equal.
+   */
+  AbstractExpressionRef filter_predicate_;
+  AbstractExpressionRef pred_key_;
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    if (IsPointLookup()) {
+      if (filter_predicate_ != nullptr) {
+        return fmt::format("IndexScan {{ index_oid={}, pred_key={}, filter={} }}", index_oid_, pred_key_,
+                           filter_predicate_);
+      }
+      return fmt::format("IndexScan {{ index_oid={}, pred_key={} }}", index_oid_, pred_key_);
+    }
+    std::string parallel;
+    if (parallelism_ > 1) {
+      parallel = fmt::format(", parallelism={}{}", parallelism_, ordered_ ? "" : ", ordered=false");
+    }
+    return fmt::format("IndexScan {{ index_oid={}{}{}{} }}", index_oid_, reverse_ ? ", reverse=true" : "",
+                       index_only_ ? ", index_only=true" : "", parallel);
   }
 };
 
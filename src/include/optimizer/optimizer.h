@@ -19,8 +19,8 @@ namespace bustub {
  */
 class Optimizer {
  public:
-  explicit Optimizer(const Catalog &catalog, bool force_starter_rule)
-      : catalog_(catalog), force_starter_rule_(force_starter_rule) {}
+  explicit Optimizer(const Catalog &catalog, bool force_starter_rule, size_t index_scan_parallelism = 1)
+      : catalog_(catalog), force_starter_rule_(force_starter_rule), index_scan_parallelism_(index_scan_parallelism) {}
 
   auto Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
@@ -49,7 +49,7 @@ class Optimizer {
   auto OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
   /**
-   * @brief optimize nested loop join into index join.
+   * @brief optimize nested loop join into index join, probing a hash index on the inner join column if there is one
    */
   auto OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
@@ -63,6 +63,11 @@ class Optimizer {
    */
   auto OptimizeMergeFilterScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief turn a seq scan filtered on `column = constant` into a point lookup on a hash index over that column
+   */
+  auto OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /**
    * @brief rewrite expression to be used in nested loop joins. e.g., if we have `SELECT * FROM a, b WHERE a.x = b.y`,
    * we will have `#0.x = #0.y` in the filter plan node. We will need to figure out where does `0.x` and `0.y` belong
@@ -79,11 +84,23 @@ class Optimizer {
   auto IsPredicateTrue(const AbstractExpressionRef &expr) -> bool;
 
   /**
-   * @brief optimize order by as index scan if there's an index on a table
+   * @brief optimize order by as index scan if there's an index on a table, scanning it backwards for desc order-bys
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
-  /** @brief check if the index can be matched */
+  /**
+   * @brief answer an index scan from the index entries alone when the projection above it only reads key columns or
+   * columns included in a covering index
+   */
+  auto OptimizeIndexScanAsIndexOnly(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief scan B+ tree indexes on `index_scan_parallelism_` threads, merging the outputs in key order unless an
+   * aggregation above the scan makes the order irrelevant
+   */
+  auto OptimizeIndexScanAsParallel(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /** @brief check if the index can be matched, preferring hash indexes over B+ trees */
   auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
 
@@ -107,6 +124,9 @@ class Optimizer {
   const Catalog &catalog_;
 
   const bool force_starter_rule_;
+
+  /** Threads per index scan, from the `index_scan_parallelism` session variable */
+  const size_t index_scan_parallelism_;
 };
 
 }  // namespace bustub
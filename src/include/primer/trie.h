@@ -2,12 +2,14 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <future>  // NOLINT
 #include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -40,6 +42,96 @@ class MoveBlocked {
   std::future<int> wait_;
 };
 
+class TrieNode;
+
+// The children of a TrieNode, keyed by the next byte of the key. Like the inner nodes of an adaptive radix tree, the
+// layout grows and shrinks with the number of children: up to 4 and up to 16 children keep their bytes in a sorted
+// array (the 16 are compared at once with SSE2), up to 48 go through a 256-entry byte-to-slot index, and beyond that
+// the slots are indexed by the byte itself. A node without children allocates nothing.
+class TrieChildren {
+ public:
+  TrieChildren() = default;
+  TrieChildren(const TrieChildren &other);
+  TrieChildren(TrieChildren &&other) noexcept = default;
+  auto operator=(const TrieChildren &other) -> TrieChildren &;
+  auto operator=(TrieChildren &&other) noexcept -> TrieChildren & = default;
+  ~TrieChildren() = default;
+
+  // Returns the child under the given byte, or nullptr if there is none.
+  auto Find(char c) const -> const std::shared_ptr<const TrieNode> *;
+
+  // Put the child under the given byte, replacing the one already there.
+  void Set(char c, std::shared_ptr<const TrieNode> child);
+
+  // Remove the child under the given byte, if any.
+  void Erase(char c);
+
+  auto Size() const -> size_t { return size_; }
+  auto Empty() const -> bool { return size_ == 0; }
+
+  // Returns the first child whose byte, as an unsigned char, is greater than `byte` (-1 for the first child), along
+  // with its byte, or nullptr if there is none.
+  auto UpperBound(int byte) const -> std::pair<uint8_t, const std::shared_ptr<const TrieNode> *>;
+
+  // Call f(c, child) on every child, in the order of their bytes as unsigned chars (the order of std::string).
+  template <class F>
+  void ForEach(F &&f) const {
+    Visit(*this, [&f](uint8_t byte, const std::shared_ptr<const TrieNode> &child) {
+      f(static_cast<char>(byte), child);
+    });
+  }
+
+ private:
+  enum class Kind : uint8_t { Node4, Node16, Node48, Node256 };
+
+  static auto Capacity(Kind kind) -> size_t;
+
+  // Visit the occupied slots in byte order, as (byte, slot).
+  template <class Self, class F>
+  static void Visit(Self &self, F &&f) {
+    switch (self.kind_) {
+      case Kind::Node4:
+      case Kind::Node16:
+        for (size_t i = 0; i < self.size_; i++) {
+          f(self.keys_[i], self.slots_[i]);
+        }
+        break;
+      case Kind::Node48:
+        for (size_t byte = 0; byte < 256; byte++) {
+          if (self.index_[byte] != 0) {
+            f(static_cast<uint8_t>(byte), self.slots_[self.index_[byte] - 1]);
+          }
+        }
+        break;
+      case Kind::Node256:
+        for (size_t byte = 0; byte < 256; byte++) {
+          if (self.slots_[byte] != nullptr) {
+            f(static_cast<uint8_t>(byte), self.slots_[byte]);
+          }
+        }
+        break;
+    }
+  }
+
+  // Returns the slot of the given byte, or nullptr.
+  auto FindSlot(uint8_t byte) const -> std::shared_ptr<const TrieNode> *;
+
+  // Add a child under a byte that has none yet, when there is room for it.
+  void Insert(uint8_t byte, std::shared_ptr<const TrieNode> child);
+
+  // Move the children into the layout of the given kind.
+  void Resize(Kind kind);
+
+  Kind kind_{Kind::Node4};
+  uint16_t size_{0};
+  // Node4 and Node16: the bytes of slots_[0, size_), in ascending order.
+  uint8_t keys_[16]{};
+  // Node48: the slot of each byte plus one, 0 if the byte has no child.
+  std::unique_ptr<uint8_t[]> index_;
+  // Capacity(kind_) children; Node256 indexes them by byte, the others fill them from the front.
+  std::unique_ptr<std::shared_ptr<const TrieNode>[]> slots_;
+};
+
 // A TrieNode is a node in a Trie.
 class TrieNode {
  public:
@@ -47,7 +139,7 @@ class TrieNode {
   TrieNode() = default;
 
   // Create a TrieNode with some children.
-  explicit TrieNode(std::map<char, std::shared_ptr<const TrieNode>> children) : children_(std::move(children)) {}
+  explicit TrieNode(TrieChildren children) : children_(std::move(children)) {}
 
   virtual ~TrieNode() = default;
 
@@ -58,10 +150,14 @@ class TrieNode {
   // contains a value or not.
   //
   // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
-  virtual auto Clone() const -> std::unique_ptr<TrieNode> { return std::make_unique<TrieNode>(children_); }
+  virtual auto Clone() const -> std::unique_ptr<TrieNode> { return std::make_unique<TrieNode>(*this); }
 
-  // A map of children, where the key is the next character in the key, and the value is the next TrieNode.
-  std::map<char, std::shared_ptr<const TrieNode>> children_;
+  // The children, where the key is the next character in the key, and the value is the next TrieNode.
+  TrieChildren children_;
+
+  // The characters of the key between the edge into this node and the node itself. Chains of nodes that have
+  // neither a value nor a second child are compressed into the prefix of the node they lead to; the root has none.
+  std::string prefix_;
 
   // Indicates if the node is the terminal node.
   bool is_value_node_{false};
@@ -78,7 +174,7 @@ class TrieNodeWithValue : public TrieNode {
   explicit TrieNodeWithValue(std::shared_ptr<T> value) : value_(std::move(value)) { this->is_value_node_ = true; }
 
   // Create a trie node with children and a value.
-  TrieNodeWithValue(std::map<char, std::shared_ptr<const TrieNode>> children, std::shared_ptr<T> value)
+  TrieNodeWithValue(TrieChildren children, std::shared_ptr<T> value)
       : TrieNode(std::move(children)), value_(std::move(value)) {
     this->is_value_node_ = true;
   }
@@ -87,13 +183,61 @@ class TrieNodeWithValue : public TrieNode {
   //
   // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
   auto Clone() const -> std::unique_ptr<TrieNode> override {
-    return std::make_unique<TrieNodeWithValue<T>>(children_, value_);
+    return std::make_unique<TrieNodeWithValue<T>>(*this);
   }
 
   // The value associated with this trie node.
   std::shared_ptr<T> value_;
 };
 
+// Iterates over the keys under a prefix that hold a value of type T, in lexicographic order (as std::string compares
+// them), on the trie it was made from. It keeps that trie alive and copies no nodes: it walks down them with a stack
+// of the nodes it is in.
+template <class T>
+class TrieIterator {
+ public:
+  auto IsEnd() const -> bool { return value_ == nullptr; }
+
+  auto Key() const -> const std::string & { return key_; }
+
+  auto operator*() const -> const T & { return *value_; }
+
+  auto operator++() -> TrieIterator &;
+
+  // Append up to `max_pairs` keys and pointers to their values to `out`, then advance past them. The pointers stay
+  // valid as long as the trie does. Scanning from the last key appended gets the next page.
+  // @return number of pairs appended, 0 only at the end of the scan
+  auto NextBatch(std::vector<std::pair<std::string, const T *>> *out, size_t max_pairs) -> size_t;
+
+ private:
+  friend class Trie;
+
+  // A node the iterator is in, the byte of the last of its children it went into (-1 before the first), and the
+  // length of the key of the node.
+  struct Frame {
+    const TrieNode *node_;
+    int last_byte_;
+    size_t key_length_;
+  };
+
+  TrieIterator(std::shared_ptr<const TrieNode> root, std::string_view prefix, std::optional<std::string_view> after);
+
+  // Position the iterator as if it were at the key `after` below the node of the bottom frame, whose key it starts
+  // with.
+  void Seek(std::string_view after);
+
+  // Move to the next node with a value of type T after the current position, or to the end.
+  void Advance();
+
+  // Returns the value of the node if it holds one of type T.
+  static auto ValueOf(const TrieNode *node) -> const T *;
+
+  std::shared_ptr<const TrieNode> root_;
+  std::vector<Frame> stack_;
+  std::string key_;
+  const T *value_{nullptr};
+};
+
 // A Trie is a data structure that maps strings to values of type T. All operations on a Trie should not
 // modify the trie itself. It should reuse the existing nodes as much as possible, and create new nodes to
 // represent the new trie.
@@ -105,6 +249,24 @@ class Trie {
   // Create a new trie with the given root.
   explicit Trie(std::shared_ptr<const TrieNode> root) : root_(std::move(root)) {}
 
+  // Walk to the node of the given key without touching any reference count. Returns the shared_ptr that owns the
+  // node (root_ itself for an empty key), or nullptr if the key has no node, including when it ends inside the
+  // compressed prefix of one.
+  auto FindNode(std::string_view key) const -> const std::shared_ptr<const TrieNode> *;
+
+  // Put with the value already in a shared_ptr, so that it can be put again into another trie. In place, the nodes
+  // on the path that no other trie shares are modified instead of copied; this trie must not be used afterwards,
+  // other than to be replaced by the result.
+  template <class T>
+  auto PutValue(std::string_view key, std::shared_ptr<T> value, bool in_place = false) const -> Trie;
+
+  // Remove, optionally in place like PutValue.
+  auto RemoveValue(std::string_view key, bool in_place) const -> Trie;
+
+  // TrieStore pins just the node holding a value in its ValueGuards, instead of the whole trie, retries a Put on a
+  // newer root when another writer published first, and applies batches in place.
+  friend class TrieStore;
+
  public:
   // Create an empty trie.
   Trie() {
@@ -127,6 +289,11 @@ class Trie {
   // Remove the key from the trie. If the key does not exist, return the original trie.
   // Otherwise, returns the new trie.
   auto Remove(std::string_view key) const -> Trie;
+
+  // Iterate over the keys that start with the prefix and hold a value of type T, in order. With `after`, the scan
+  // starts at the first such key greater than it, so that a paginated scan resumes from the last key it returned.
+  template <class T>
+  auto Scan(std::string_view prefix, std::optional<std::string_view> after = std::nullopt) const -> TrieIterator<T>;
 };
 
 }  // namespace bustub
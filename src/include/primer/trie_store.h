@@ -1,15 +1,21 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <shared_mutex>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "primer/trie.h"
 
 namespace bustub {
 
 // This class is used to guard the value returned by the trie. It holds a reference to the root so
-// that the reference to the value will not be invalidated.
+// that the reference to the value will not be invalidated. TrieStore roots it at the node holding the
+// value, which is all it needs to keep alive.
 template <class T>
 class ValueGuard {
  public:
@@ -24,8 +30,21 @@ class ValueGuard {
 // This class is a thread-safe wrapper around the Trie class. It provides a simple interface for
 // accessing the trie. It should allow concurrent reads and a single write operation at the same
 // time.
+//
+// Readers take no lock: they load the current root through an atomic pointer, protected from being
+// freed by an epoch scheme. Each reader announces itself in a counter picked by its thread, so
+// readers on different threads rarely write to the same cache line. Writers build the new trie from
+// the root they loaded and publish it with compare-and-swap, retrying on the newer root when another
+// writer published first. Replaced roots are freed once every reader that could have loaded them
+// has left.
 class TrieStore {
  public:
+  TrieStore() = default;
+  ~TrieStore();
+
+  TrieStore(const TrieStore &) = delete;
+  auto operator=(const TrieStore &) -> TrieStore & = delete;
+
   // This function returns a ValueGuard object that holds a reference to the value in the trie. If
   // the key does not exist in the trie, it will return std::nullopt.
   template <class T>
@@ -39,16 +58,85 @@ class TrieStore {
   // This function will remove the key-value pair from the trie.
   void Remove(std::string_view key);
 
+  // Iterate over the keys under the prefix in the current trie, which the iterator keeps alive while writers go on.
+  // See Trie::Scan.
+  template <class T>
+  auto Scan(std::string_view prefix, std::optional<std::string_view> after = std::nullopt) -> TrieIterator<T>;
+
+  // A batch of puts and removes, applied to a private copy of the trie and published together by Commit. Nodes the
+  // batch already copied are modified in place by its later writes instead of being copied again, so loading many
+  // keys costs about as much as on a mutable trie. Readers see either none or all of a committed batch.
+  //
+  // A batch is used by one thread at a time. If other writers published after the batch started, Commit applies the
+  // batch again on top of their trie.
+  class Batch {
+   public:
+    explicit Batch(TrieStore *store);
+
+    template <class T>
+    void Put(std::string_view key, T value);
+
+    void Remove(std::string_view key);
+
+    // Publish the writes so far. The batch can be reused afterwards, starting from the published trie.
+    void Commit();
+
+   private:
+    TrieStore *store_;
+
+    // A put, or a remove if value_ is nullptr, kept to apply it again on a newer root.
+    struct Write {
+      std::string key_;
+      std::shared_ptr<void> value_;
+      Trie (*apply_)(const Trie &root, const Write &write);
+    };
+
+    // The trie the batch started from, and the batch's own copy of it, whose nodes are modified in place once the
+    // batch has copied them.
+    Trie base_;
+    Trie working_;
+
+    std::vector<Write> writes_;
+  };
+
  private:
-  // This mutex protects the root. Everytime you want to access the trie root or modify it, you
-  // will need to take this lock.
-  std::mutex root_lock_;
+  // The current root, held without the epoch.
+  auto Snapshot() -> Trie;
+
+  static constexpr size_t READER_SLOTS = 64;
+
+  // Number of readers that entered in an even and in an odd epoch, on a cache line of its own.
+  struct alignas(64) ReaderSlot {
+    std::atomic<uint64_t> active_[2]{};
+  };
+
+  // Announce a reader in the current epoch, which is returned for ExitEpoch. Roots replaced in or
+  // after that epoch are not freed until the reader exits.
+  auto EnterEpoch() -> uint64_t;
+
+  void ExitEpoch(uint64_t epoch);
+
+  // Replace the root with update(current root), retrying with the newer root if another writer
+  // published in between.
+  template <class Update>
+  void UpdateRoot(Update &&update);
 
-  // This mutex sequences all writes operations and allows only one write operation at a time.
-  std::mutex write_lock_;
+  // Free the replaced root `old_root` later, then advance the epoch if no reader is left in the
+  // previous one and free what no reader can still see.
+  void Retire(const Trie *old_root);
 
   // Stores the current root for the trie.
-  Trie root_;
+  std::atomic<const Trie *> root_{new Trie()};
+
+  std::atomic<uint64_t> epoch_{0};
+
+  ReaderSlot readers_[READER_SLOTS];
+
+  // This mutex protects retired_. Only writers take it, after they published.
+  std::mutex retire_lock_;
+
+  // Replaced roots and the epoch they were replaced in.
+  std::vector<std::pair<uint64_t, const Trie *>> retired_;
 };
 
 }  // namespace bustub
@@ -11,12 +11,18 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
 #include <deque>
 #include <iostream>
+#include <limits>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <queue>
 #include <shared_mutex>
 #include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
 #include <vector>
 
 #include "common/config.h"
@@ -58,6 +64,20 @@ class Context {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
+/**
+ * Concurrency protocol of a B+ tree, fixed when the tree is created.
+ *
+ * LATCH_CRABBING: optimistic latch coupling falling back to top-down write crabbing. Pages are merged and freed
+ * on underflow.
+ * B_LINK: Lehman-Yao B-link tree. Readers hold one latch at a time and follow right links past high keys; splits
+ * propagate bottom-up without holding the parent's latch while the child splits. Pages are never merged or freed,
+ * so removals may leave pages underfull.
+ * LAZY_MERGE: latch crabbing, except that removals only take the leaf's write latch and never merge or borrow. Leaves
+ * left underfull are recorded, and a background thread consolidates them in batches once removals quiet down, so
+ * deletes and inserts alternating around the same keys do not keep merging and splitting the same pages.
+ */
+enum class BPlusTreeMode { LATCH_CRABBING = 0, B_LINK, LAZY_MERGE };
+
 // Main class providing the API for the Interactive B+ Tree.
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -67,7 +87,9 @@ class BPlusTree {
  public:
   explicit BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
                      const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
-                     int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int internal_max_size = INTERNAL_PAGE_SIZE, BPlusTreeMode mode = BPlusTreeMode::LATCH_CRABBING);
+
+  ~BPlusTree();
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
@@ -78,6 +100,34 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *txn);
 
+  /**
+   * Insert a batch of pairs in key order, so that consecutive keys falling in the same leaf go in under one latched
+   * visit. A full leaf is split through the regular insert path and the batch carries on in the two halves. Duplicate
+   * keys keep their first value, as with Insert.
+   * @return number of pairs inserted
+   */
+  auto InsertBatch(std::vector<MappingType> pairs, Transaction *txn = nullptr) -> size_t;
+
+  /** Remove a batch of keys in key order, visiting each leaf once for the keys it holds; see InsertBatch. */
+  void RemoveBatch(std::vector<KeyType> keys, Transaction *txn = nullptr);
+
+  /**
+   * Build the tree bottom-up from a batch of pairs, filling each page to `fill_factor` of its capacity and linking
+   * every level in one pass. The pairs need not be sorted; duplicate keys keep their first value, as with Insert.
+   * @return false if the tree is not empty
+   */
+  auto BulkLoad(std::vector<MappingType> pairs, double fill_factor = BPLUS_TREE_FILL_FACTOR) -> bool;
+
+  /**
+   * Merge or rebalance up to `max_leaves` of the leaves that lazy-merge removals left underfull, skipping those that
+   * inserts have filled again since. The background thread of a LAZY_MERGE tree calls this on its own.
+   * @return number of leaves consolidated
+   */
+  auto Consolidate(size_t max_leaves = std::numeric_limits<size_t>::max()) -> size_t;
+
+  /** @return number of leaves waiting for consolidation */
+  auto GetUnderfullLeafCount() -> size_t;
+
   // Return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
 
@@ -91,6 +141,28 @@ class BPlusTree {
 
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
 
+  /**
+   * Range scan over [lower_key, upper_key], either bound unlimited when null. The iterator keeps the next
+   * `read_ahead_leaves` leaves pinned and stops at the upper bound without visiting the leaves after it.
+   */
+  auto Begin(const KeyType *lower_key, const KeyType *upper_key,
+             size_t read_ahead_leaves = BPLUS_TREE_READ_AHEAD_LEAVES) -> INDEXITERATOR_TYPE;
+
+  /**
+   * Descending scan over [lower_key, upper_key], either bound unlimited when null, from the largest key not above
+   * `upper_key`. It follows the previous page ids of the leaves and ends at End().
+   */
+  auto RBegin(const KeyType *upper_key = nullptr, const KeyType *lower_key = nullptr) -> INDEXITERATOR_TYPE;
+
+  /**
+   * Split [lower_key, upper_key] (either bound unlimited when null) into at most `partitions` sub-ranges holding
+   * roughly the same number of subtrees, for scanning them in parallel. The boundaries are separators of the highest
+   * internal level with a few times `partitions` of them in the range, so the split only reads a few internal pages.
+   * @return the ascending boundaries b_1..b_n (n < partitions); sub-range i is [b_i, b_i+1), the first one starting at
+   * lower_key and the last one ending at upper_key. Empty if the range cannot be split.
+   */
+  auto SplitRange(const KeyType *lower_key, const KeyType *upper_key, size_t partitions) -> std::vector<KeyType>;
+
   // Print the B+ tree
   void Print(BufferPoolManager *bpm);
 
@@ -110,13 +182,111 @@ class BPlusTree {
    */
   auto DrawBPlusTree() -> std::string;
 
-  // read data from file and insert one by one
+  // read data from file and insert one by one, or bulk load it if the tree is empty
   void InsertFromFile(const std::string &file_name, Transaction *txn = nullptr);
 
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *txn = nullptr);
 
  private:
+  // Descending scans descend again through FetchLeafRead when the leaf chain changed under them.
+  friend class IndexIterator<KeyType, ValueType, KeyComparator>;
+
+  /**
+   * Optimistic latch coupling: descend with read latches and take a write latch only on the leaf.
+   * @param[out] leaf the write-latched leaf that may contain `key`
+   * @param[out] upper_bound if given, set to the separator above the leaf (exclusive), or left empty for the rightmost
+   * leaf. It stays valid while the leaf is latched, since changing it takes a split, merge or borrow on the leaf.
+   * @return false if the tree is empty
+   */
+  auto FetchLeafOptimistic(const KeyType &key, WritePageGuard *leaf, std::optional<KeyType> *upper_bound = nullptr)
+      -> bool;
+
+  /**
+   * Descend with read latches to the leaf that may contain `key`, or to the leftmost leaf. In B-link mode only one
+   * page is latched at a time and the descent moves right past high keys.
+   * @param[out] leaf the read-latched leaf
+   * @param[out] path if given, the internal pages the descent went through, root first, one per level
+   * @return false if the tree is empty
+   */
+  auto FetchLeafRead(const KeyType *key, ReadPageGuard *leaf, std::vector<page_id_t> *path = nullptr) -> bool;
+
+  /**
+   * Descend with read latches to the rightmost leaf. In B-link mode the descent also follows the sibling pointers of
+   * splits that have not reached the parent yet.
+   * @return false if the tree is empty
+   */
+  auto FetchRightmostLeafRead(ReadPageGuard *leaf) -> bool;
+
+  /**
+   * Pessimistic latch crabbing: write-latch the header and descend with write latches, releasing all ancestors as
+   * soon as the current page is safe for the operation.
+   * @return false if the tree is empty (the header stays latched in ctx)
+   */
+  auto FetchLeafPessimistic(const KeyType &key, Context &ctx, bool for_insert) -> bool;
+
+  /**
+   * Append to `separators`, in ascending order, the separators within [lower_key, upper_key] of the internal pages
+   * `depth` levels below the latched page `internal`, and of the pages in between. Read latches are coupled
+   * top-down, as in FetchLeafRead.
+   * @return true if the pages below that level are internal pages too
+   */
+  auto CollectSeparators(const InternalPage *internal, int depth, const KeyType *lower_key, const KeyType *upper_key,
+                         std::vector<KeyType> *separators) -> bool;
+
+  // Safety checks for latch crabbing: a safe page absorbs the operation without splitting or merging.
+  auto IsSafeForInsert(const BPlusTreePage *page) const -> bool;
+  auto IsSafeForRemove(const BPlusTreePage *page, bool is_root) const -> bool;
+
+  // Structure modification, run under the write latches collected in ctx.
+  /**
+   * Rightmost-append fast path: insert straight into the cached rightmost leaf when `key` is greater than every key
+   * in it and the leaf has room, without descending from the root.
+   * @return false if the fast path does not apply
+   */
+  auto InsertIntoRightmostLeaf(const KeyType &key, const ValueType &value) -> bool;
+
+  auto StartNewTree(const KeyType &key, const ValueType &value, Context &ctx) -> bool;
+  void InsertIntoParent(const KeyType &key, page_id_t new_page_id, Context &ctx);
+  void HandleUnderflow(Context &ctx);
+
+  /**
+   * Point the previous page id of leaf `page_id` (if any) at `prev_page_id`. The caller holds the write latch on the
+   * new left neighbour, so leaves are always latched left to right here.
+   */
+  void SetPrevPageIdOf(page_id_t page_id, page_id_t prev_page_id);
+
+  // Lazy merge
+  void RemoveLazy(const KeyType &key);
+
+  // Record a leaf that a removal of `key` just made underfull; `key` routes a later descent back to it.
+  void MarkUnderfull(page_id_t page_id, const KeyType &key);
+
+  /** Merge or rebalance the leaf `key` routes to, with latch crabbing, until it is no longer underfull. */
+  void ConsolidateLeaf(const KeyType &key);
+
+  // Body of the background consolidation thread of a LAZY_MERGE tree.
+  void ConsolidateLoop();
+
+  // B-link protocol
+  auto InsertBLink(const KeyType &key, const ValueType &value) -> bool;
+  void RemoveBLink(const KeyType &key);
+
+  /**
+   * Insert the separator of a split page at `level` (leaves are level 0) into the level above, splitting upwards as
+   * needed. No latch is held on entry; `path` holds the internal pages the original descent went through.
+   */
+  void InsertIntoParentBLink(std::vector<page_id_t> *path, int level, page_id_t page_id, KeyType key,
+                             page_id_t new_page_id);
+
+  /**
+   * @return the right sibling to move to if `key` lies beyond the high key of `page`, INVALID_PAGE_ID otherwise
+   */
+  auto RightLink(const BPlusTreePage *page, const KeyType &key) const -> page_id_t;
+
+  // Follow right links with write latches, latching the sibling before releasing the current page.
+  void MoveRightWrite(const KeyType &key, WritePageGuard *guard);
+
   /* Debug Routines for FREE!! */
   void ToGraph(page_id_t page_id, const BPlusTreePage *page, std::ofstream &out);
 
@@ -138,6 +308,17 @@ class BPlusTree {
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+  BPlusTreeMode mode_;
+  // Rightmost leaf for monotonic inserts, or INVALID_PAGE_ID. It is only set while holding that leaf's write latch
+  // and is cleared before any leaf is freed, so a leaf that still matches it once latched is in the tree.
+  std::atomic<page_id_t> rightmost_leaf_page_id_{INVALID_PAGE_ID};
+  // Lazy merge: underfull leaves by page id, with a key in each, and the background thread fixing them
+  std::mutex underfull_latch_;
+  std::unordered_map<page_id_t, KeyType> underfull_leaves_;
+  size_t newly_underfull_{0};
+  std::condition_variable consolidate_cv_;
+  bool stop_consolidation_{false};
+  std::thread consolidation_thread_;
 };
 
 /**
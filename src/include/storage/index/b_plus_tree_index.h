@@ -11,13 +11,18 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <shared_mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/bloom_filter.h"
+#include "storage/index/covering_value.h"
 #include "storage/index/index.h"
 
 namespace bustub {
@@ -27,25 +32,94 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
  public:
-  BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+  BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                 BPlusTreeMode mode = BPlusTreeMode::LATCH_CRABBING);
 
   auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
 
   void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
+  auto InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) -> size_t override;
+
+  void DeleteEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) override;
+
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /**
+   * Turn an index entry (see Index::InsertEntry) into the pair stored in the tree. The included columns of a covering
+   * index go into the value, next to the RID.
+   */
+  auto MakeEntry(const Tuple &entry, RID rid) const -> std::pair<KeyType, ValueType>;
+
+  /**
+   * Build the index bottom-up from (key, rid) pairs in any order; see BPlusTree::BulkLoad.
+   * @return false if the index already has entries
+   */
+  auto BulkLoad(std::vector<std::pair<KeyType, ValueType>> entries, double fill_factor = BPLUS_TREE_FILL_FACTOR)
+      -> bool;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
 
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
+  /** Range scan over [lower_key, upper_key], either bound unlimited when null; see BPlusTree::Begin. */
+  auto GetRangeIterator(const KeyType *lower_key, const KeyType *upper_key) -> INDEXITERATOR_TYPE;
+
+  /** Descending scan over [lower_key, upper_key], either bound unlimited when null; see BPlusTree::RBegin. */
+  auto GetReverseIterator(const KeyType *upper_key, const KeyType *lower_key) -> INDEXITERATOR_TYPE;
+
+  /** Boundaries splitting [lower_key, upper_key] into at most `partitions` sub-ranges; see BPlusTree::SplitRange. */
+  auto GetRangePartitions(const KeyType *lower_key, const KeyType *upper_key, size_t partitions)
+      -> std::vector<KeyType>;
+
+  auto GetComparator() const -> const KeyComparator & { return comparator_; }
+
+  /**
+   * Keep a Bloom filter over the keys, which ScanKey checks before descending the tree so that most lookups of absent
+   * keys skip it. The filter is built from the current keys and kept up to date by inserts and bulk loads. Removed
+   * keys stay in it until it is rebuilt, which happens once removals reach half of the keys it was built with, or
+   * when inserts outgrow its capacity.
+   */
+  void EnableBloomFilter();
+
+  /** @return the lookup counters of the Bloom filter, all zero if it is not enabled */
+  auto GetBloomFilterStats() const -> BloomFilterStats;
+
  protected:
+  /** Rebuild the Bloom filter from the keys in the tree. The caller holds bloom_latch_ in exclusive mode. */
+  void RebuildBloomFilter();
+
+  /** Insert keys into the Bloom filter, if there is one, and rebuild it if it is full. */
+  void AddToBloomFilter(const std::vector<KeyType> &keys);
+
+  /** Count removed keys against the Bloom filter, rebuilding it once enough of its keys are gone. */
+  void RemoveFromBloomFilter(size_t count);
+
   // comparator for key
   KeyComparator comparator_;
   // container
   std::shared_ptr<BPlusTree<KeyType, ValueType, KeyComparator>> container_;
+  // positions of the key and the included columns in an index entry
+  std::vector<uint32_t> key_positions_;
+  std::vector<uint32_t> include_positions_;
+
+  /**
+   * Optional Bloom filter over the keys. Probes and inserts hold bloom_latch_ shared (the filter itself is
+   * thread-safe), rebuilds hold it exclusive. Keys go into the filter after the tree, so a rebuild scanning the tree
+   * cannot miss a key whose insert is still in flight.
+   */
+  std::unique_ptr<BloomFilter> bloom_filter_;
+  mutable std::shared_mutex bloom_latch_;
+  /** Keys inserted and removed since the filter was built */
+  std::atomic<size_t> bloom_inserts_{0};
+  std::atomic<size_t> bloom_removals_{0};
+  /** Number of keys the filter was built with */
+  size_t bloom_built_keys_{0};
+  mutable std::atomic<size_t> bloom_probes_{0};
+  mutable std::atomic<size_t> bloom_skipped_{0};
+  mutable std::atomic<size_t> bloom_false_positives_{0};
 };
 
 /** We only support index table with one integer key for now in BusTub. Hardcode everything here. */
@@ -59,4 +133,12 @@ using BPlusTreeIndexIteratorForTwoIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using IntegerHashFunctionType = HashFunction<IntegerKeyType>;
 
+/** Covering indexes (CREATE INDEX ... WITH (include = '...')) keep up to 16 bytes of included columns per entry. */
+constexpr static const auto COVERING_PAYLOAD_SIZE = 16;
+using IntegerCoveringValueType = CoveringValue<COVERING_PAYLOAD_SIZE>;
+using CoveringBPlusTreeIndexForTwoIntegerColumn =
+    BPlusTreeIndex<IntegerKeyType, IntegerCoveringValueType, IntegerComparatorType>;
+using CoveringBPlusTreeIndexIteratorForTwoIntegerColumn =
+    IndexIterator<IntegerKeyType, IntegerCoveringValueType, IntegerComparatorType>;
+
 }  // namespace bustub
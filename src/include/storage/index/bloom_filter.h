@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/storage/index/bloom_filter.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace bustub {
+
+/** Counters of the Bloom filter of an index (see BPlusTreeIndex::EnableBloomFilter) */
+struct BloomFilterStats {
+  /** Point lookups that checked the filter */
+  size_t probes_{0};
+  /** Lookups the filter answered alone, without descending the tree */
+  size_t skipped_{0};
+  /** Lookups that got past the filter but found no key */
+  size_t false_positives_{0};
+  /** False positive rate expected from the share of filter bits set */
+  double estimated_false_positive_rate_{0};
+
+  /** @return the share of lookups of absent keys that got past the filter */
+  auto FalsePositiveRate() const -> double {
+    size_t negatives = skipped_ + false_positives_;
+    return negatives == 0 ? 0 : static_cast<double>(false_positives_) / static_cast<double>(negatives);
+  }
+};
+
+/**
+ * Split-block Bloom filter over 64-bit key hashes. Each key sets one bit in each of the eight 32-bit words of a single
+ * 256-bit block, so a probe reads one cache line and tests all eight words without branching. With
+ * BLOOM_FILTER_BITS_PER_KEY bits per key, about 1% of absent keys get through.
+ *
+ * Insert and MayContain may run concurrently: the words are atomics, and a key is visible to probes once its
+ * Insert returns. Keys cannot be removed.
+ */
+class BloomFilter {
+ public:
+  /** Create an empty filter sized for `capacity` keys. */
+  explicit BloomFilter(size_t capacity);
+
+  void Insert(uint64_t hash);
+
+  /** @return false if no key with this hash was inserted; true means it probably was */
+  auto MayContain(uint64_t hash) const -> bool;
+
+  /** @return number of keys the filter was sized for; beyond it the false positive rate grows */
+  auto GetCapacity() const -> size_t { return capacity_; }
+
+  /** @return the false positive rate expected from the share of bits set */
+  auto EstimatedFalsePositiveRate() const -> double;
+
+ private:
+  static constexpr size_t WORDS_PER_BLOCK = 8;
+
+  /** Set in `mask` the bit each word of the block holds for `hash`. */
+  static void MakeMask(uint64_t hash, uint32_t mask[WORDS_PER_BLOCK]);
+
+  /** @return the first word of the block of `hash` */
+  auto BlockOf(uint64_t hash) const -> size_t;
+
+  size_t capacity_;
+  size_t num_blocks_;
+  std::unique_ptr<std::atomic<uint32_t>[]> words_;
+};
+
+}  // namespace bustub
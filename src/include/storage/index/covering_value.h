@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// covering_value.h
+//
+// Identification: src/include/storage/index/covering_value.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Leaf value of a covering index: the RID of the row, followed by the row's included (non-key) columns serialized as
+ * a tuple of the include schema. Index-only scans read the included columns from here instead of the table heap.
+ *
+ * Only inlined (fixed-length) columns can be included.
+ */
+template <size_t PayloadSize>
+class CoveringValue {
+ public:
+  CoveringValue() = default;
+
+  // NOTE: the payload stays zero filled, for callers that only have a RID
+  explicit CoveringValue(RID rid) : rid_(rid) {}
+
+  /**
+   * Copy the included columns of a row, given as a tuple of the include schema.
+   * @throw Exception if they do not fit in the payload
+   */
+  inline void SetPayload(const Tuple &tuple) {
+    if (tuple.GetLength() > PayloadSize) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "included columns do not fit in the covering index value");
+    }
+    memset(payload_, 0, PayloadSize);
+    memcpy(payload_, tuple.GetData(), tuple.GetLength());
+  }
+
+  inline auto ToValue(const Schema *schema, uint32_t column_idx) const -> Value {
+    const auto &col = schema->GetColumn(column_idx);
+    return Value::DeserializeFrom(payload_ + col.GetOffset(), col.GetType());
+  }
+
+  /** Row the entry points to */
+  RID rid_;
+  /** Included columns, laid out like a tuple of the include schema */
+  char payload_[PayloadSize]{};
+};
+
+}  // namespace bustub
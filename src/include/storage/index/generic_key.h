@@ -71,7 +71,14 @@ class GenericKey {
 };
 
 /**
- * Function object returns true if lhs < rhs, used for trees
+ * Integer key schemas whose raw bytes map to a single int64_t with the same order, so in-page search can compare keys
+ * without building Values. NULL is stored as the smallest value of its type, so it orders first, as in the comparator.
+ */
+enum class IntegerKeyLayout { NONE = 0, BIGINT, INTEGER, TWO_INTEGER };
+
+/**
+ * Function object returns true if lhs < rhs, used for trees. A NULL column orders before every other value of its
+ * column, so keys with NULLs still have a total order.
  */
 template <size_t KeySize>
 class GenericComparator {
@@ -83,6 +90,12 @@ class GenericComparator {
       Value lhs_value = (lhs.ToValue(key_schema_, i));
       Value rhs_value = (rhs.ToValue(key_schema_, i));
 
+      if (lhs_value.IsNull() || rhs_value.IsNull()) {
+        if (lhs_value.IsNull() != rhs_value.IsNull()) {
+          return lhs_value.IsNull() ? -1 : 1;
+        }
+        continue;
+      }
       if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
         return -1;
       }
@@ -94,13 +107,33 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, integer_key_layout_{other.integer_key_layout_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema)
+      : key_schema_(key_schema), integer_key_layout_(DetectIntegerKeyLayout(key_schema)) {}
+
+  inline auto GetIntegerKeyLayout() const -> IntegerKeyLayout { return integer_key_layout_; }
 
  private:
+  static auto DetectIntegerKeyLayout(Schema *key_schema) -> IntegerKeyLayout {
+    const auto &columns = key_schema->GetColumns();
+    if (columns.size() == 1 && columns[0].GetType() == TypeId::BIGINT && KeySize >= sizeof(int64_t)) {
+      return IntegerKeyLayout::BIGINT;
+    }
+    if (columns.size() == 1 && columns[0].GetType() == TypeId::INTEGER && KeySize >= sizeof(int32_t)) {
+      return IntegerKeyLayout::INTEGER;
+    }
+    if (columns.size() == 2 && columns[0].GetType() == TypeId::INTEGER && columns[1].GetType() == TypeId::INTEGER &&
+        columns[1].GetOffset() == sizeof(int32_t) && KeySize >= sizeof(int64_t)) {
+      return IntegerKeyLayout::TWO_INTEGER;
+    }
+    return IntegerKeyLayout::NONE;
+  }
+
   Schema *key_schema_;
+  IntegerKeyLayout integer_key_layout_;
 };
 
 }  // namespace bustub
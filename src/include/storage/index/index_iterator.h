@@ -13,17 +13,40 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <deque>
+#include <vector>
+
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class BPlusTree;
+
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
  public:
   // you may define your own constructor based on your member variables
   IndexIterator();
+  IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index);
+  /**
+   * Range scan iterator: stops after `upper_key` (inclusive) when it is not null, and keeps the next
+   * `read_ahead_leaves` leaves pinned so that crossing into them does not go to disk.
+   */
+  IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index, const KeyComparator *comparator,
+                const KeyType *upper_key, size_t read_ahead_leaves);
+  /**
+   * Descending scan iterator: moves from `index` towards smaller keys and stops after `lower_key` (inclusive) when it
+   * is not null. `upper_key` is where the scan started, if it was given. There is no read-ahead in this direction.
+   */
+  IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree, BufferPoolManager *bpm, ReadPageGuard guard,
+                int index, const KeyComparator *comparator, const KeyType *upper_key, const KeyType *lower_key);
+  IndexIterator(IndexIterator &&that) noexcept = default;
+  auto operator=(IndexIterator &&that) noexcept -> IndexIterator & = default;
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -32,12 +55,76 @@ class IndexIterator {
 
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  /**
+   * Append up to `max_pairs` pairs from the current leaf to `out` under a single latch hold, then advance past them.
+   * Descending scans append in descending order.
+   * @return number of pairs appended, 0 only at the end of the scan
+   */
+  auto NextBatch(std::vector<MappingType> *out, size_t max_pairs) -> size_t;
+
+  auto operator==(const IndexIterator &itr) const -> bool {
+    return page_id_ == itr.page_id_ && (page_id_ == INVALID_PAGE_ID || index_ == itr.index_);
+  }
 
-  auto operator!=(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  /** A leaf pinned ahead of the scan, with the sibling pointer it had when it was read. */
+  struct ReadAheadLeaf {
+    BasicPageGuard guard_;
+    page_id_t page_id_;
+    page_id_t next_page_id_;
+  };
+
+  /** Step past exhausted leaves so that the iterator either points at a pair or is the end iterator. */
+  void SkipExhaustedLeaves();
+
+  /** @return true if the current leaf has no more pairs to visit in the direction of the scan */
+  auto IsLeafExhausted() const -> bool { return reverse_ ? index_ < end_index_ : index_ >= end_index_; }
+
+  /** Compute where the scan ends in the leaf just latched, given the bound. */
+  void EnterLeaf();
+
+  /**
+   * Release the current leaf and latch the one before it. The previous page id is only trusted if that leaf still
+   * links forward to the current one; otherwise the leaf before `resume_key_` is found again from the root.
+   */
+  void StepBack();
+
+  /**
+   * Make the read-ahead window start at `next_page_id` and pin leaves until it holds `read_ahead_leaves_ + 1` of
+   * them. Must be called with no leaf latched: each new leaf is latched on its own to read its sibling pointer.
+   */
+  void ReadAhead(page_id_t next_page_id);
+
+  /** @return true if the leaf ends at or after the upper bound, so the scan never goes past it */
+  auto ReachesUpperKey(const LeafPage *leaf) const -> bool;
+
+  /** @return true if the leaf starts at or before the lower bound of a descending scan */
+  auto ReachesLowerKey(const LeafPage *leaf) const -> bool;
+
+  BufferPoolManager *bpm_{nullptr};
+  ReadPageGuard guard_;
+  page_id_t page_id_{INVALID_PAGE_ID};
+  int index_{0};
+  /** One past the last index to visit in the current leaf, or the smallest index to visit in a descending scan */
+  int end_index_{0};
+  /** The bound falls inside the current leaf, so the scan ends with it */
+  bool last_leaf_{false};
+
+  const KeyComparator *comparator_{nullptr};
+  /** Upper bound of an ascending scan, lower bound of a descending one */
+  KeyType bound_key_;
+  bool has_bound_key_{false};
+
+  bool reverse_{false};
+  BPlusTree<KeyType, ValueType, KeyComparator> *tree_{nullptr};
+  /** Every key a descending scan has yet to visit is below this one */
+  KeyType resume_key_;
+  bool has_resume_key_{false};
+
+  size_t read_ahead_leaves_{0};
+  std::deque<ReadAheadLeaf> read_ahead_;
 };
 
 }  // namespace bustub
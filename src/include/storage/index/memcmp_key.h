@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memcmp_key.h
+//
+// Identification: src/include/storage/index/memcmp_key.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <string>
+
+#include "catalog/schema.h"
+#include "storage/index/generic_key.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * Order-preserving ("memcomparable") encoding of index keys: comparing two encoded keys with memcmp gives the same
+ * order as comparing their columns one by one.
+ *
+ * Columns are written back to back:
+ *  - integers and booleans: big-endian with the sign bit flipped
+ *  - decimals: big-endian IEEE bits, all bits flipped for negatives and only the sign bit for the rest
+ *  - timestamps: big-endian, shifted by one so the NULL sentinel comes first
+ *  - varchars: a 0x00 (NULL) or 0x01 marker, then the bytes with every 0x00 escaped as 0x00 0xFF, then 0x00 0x00
+ * NULLs are the smallest value of their column. The rest of the key is zero filled.
+ */
+class MemcmpKeyEncoder {
+ public:
+  /**
+   * Encode the key columns of `tuple` into `size` bytes at `data`.
+   * @throw Exception if the encoding does not fit
+   */
+  static void Encode(const Tuple &tuple, const Schema *key_schema, char *data, size_t size);
+
+  /** @return number of bytes the encoding of `tuple` takes, before zero filling */
+  static auto EncodedSize(const Tuple &tuple, const Schema *key_schema) -> size_t;
+
+  /** @return the encoding of `tuple` without any padding, for variable-length keys (see VarlenBPlusTree) */
+  static auto EncodeToString(const Tuple &tuple, const Schema *key_schema) -> std::string;
+
+  template <size_t KeySize>
+  static auto MakeKey(const Tuple &tuple, const Schema *key_schema) -> GenericKey<KeySize> {
+    GenericKey<KeySize> key;
+    Encode(tuple, key_schema, key.data_, KeySize);
+    return key;
+  }
+};
+
+/**
+ * Function object comparing GenericKeys that hold memcomparable encodings (see MemcmpKeyEncoder) with a single memcmp,
+ * without looking at the key schema.
+ */
+template <size_t KeySize>
+class MemcmpComparator {
+ public:
+  inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    return memcmp(lhs.data_, rhs.data_, KeySize);
+  }
+
+  MemcmpComparator() = default;
+
+  // constructor, for symmetry with GenericComparator
+  explicit MemcmpComparator(Schema * /* key_schema */) {}
+};
+
+}  // namespace bustub
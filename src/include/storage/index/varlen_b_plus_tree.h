@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree.h
+//
+// Identification: src/include/storage/index/varlen_b_plus_tree.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/b_plus_tree_header_page.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+class VarlenBPlusTree;
+
+/**
+ * Iterator over a VarlenBPlusTree in ascending or descending key order. It copies one leaf at a time and remembers
+ * the last key it returned and where the leaf linked to, so it holds no latch or pin between steps and stays valid
+ * across concurrent changes.
+ */
+class VarlenIndexIterator {
+ public:
+  VarlenIndexIterator() = default;
+  VarlenIndexIterator(VarlenBPlusTree *tree, bool reverse);
+
+  auto IsEnd() const -> bool { return index_ == entries_.size(); }
+
+  auto operator*() const -> const std::pair<std::string, RID> & { return entries_[index_]; }
+
+  auto operator++() -> VarlenIndexIterator &;
+
+ private:
+  /** Copy the entries of the next leaf past the last returned key. */
+  void Fill(const std::string *bound);
+
+  VarlenBPlusTree *tree_{nullptr};
+  bool reverse_{false};
+  std::vector<std::pair<std::string, RID>> entries_;
+  size_t index_{0};
+  // The leaf copied last and its sibling in scan order when it was copied
+  page_id_t leaf_page_id_{INVALID_PAGE_ID};
+  page_id_t sibling_page_id_{INVALID_PAGE_ID};
+};
+
+/**
+ * B+ tree over variable-length byte string keys, stored in slotted pages (see BPlusTreeSlottedPage) so that short
+ * keys take up only the bytes they need. Keys compare like memcmp, which orders MemcmpKeyEncoder output the same
+ * way as the encoded columns. Keys are unique; the longest accepted key is BPlusTreeSlottedPage::MAX_KEY_SIZE.
+ *
+ * Pages split by bytes rather than by entry count. A page left underfull by a removal merges with a sibling when
+ * their entries fit in one page; otherwise the sibling is nearly full and the page is left as it is.
+ *
+ * Concurrency follows BPlusTree's latch crabbing: an optimistic pass read-latches the path and write-latches only the
+ * leaf, and a pessimistic pass write-latches the path from the highest page that may split or merge. Readers hold at
+ * most one leaf latch at a time and follow the sibling links in both directions.
+ */
+class VarlenBPlusTree {
+ public:
+  explicit VarlenBPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager);
+
+  // Returns true if this B+ tree has no keys and values.
+  auto IsEmpty() -> bool;
+
+  /**
+   * Insert a key-value pair into this B+ tree.
+   * @return false if the key already exists
+   * @throw Exception if the key is longer than BPlusTreeSlottedPage::MAX_KEY_SIZE
+   */
+  auto Insert(std::string_view key, const RID &value) -> bool;
+
+  // Remove a key and its value from this B+ tree.
+  void Remove(std::string_view key);
+
+  // Return the value associated with a given key
+  auto GetValue(std::string_view key, std::vector<RID> *result) -> bool;
+
+  // Index iterator, in descending key order if `reverse` is set
+  auto Begin(bool reverse = false) -> VarlenIndexIterator;
+
+  /**
+   * Copy the entries of the next non-empty leaf of a scan to `entries`, in scan order: keys greater than `bound` in
+   * ascending order, or less than `bound` in descending order; a null bound does not limit the scan. The scan goes on
+   * from leaf `*leaf_page_id` through its sibling `*sibling_page_id`, or descends from the root if the leaf id is
+   * INVALID_PAGE_ID or the sibling no longer links back to it. Both ids are then set for the leaf copied. Used by
+   * VarlenIndexIterator.
+   */
+  void ScanLeaf(const std::string *bound, bool reverse, page_id_t *leaf_page_id, page_id_t *sibling_page_id,
+                std::vector<std::pair<std::string, RID>> *entries);
+
+  // Return the page id of the root node
+  auto GetRootPageId() -> page_id_t;
+
+ private:
+  /**
+   * Read-latch the path down to the parent of the leaf that may contain `key` and write-latch only the leaf.
+   * @return false if the tree is empty
+   */
+  auto FetchLeafOptimistic(std::string_view key, WritePageGuard *leaf) -> bool;
+
+  /**
+   * Write-latch the path down to the leaf that may contain `key` in `ctx`, releasing the pages above each page that
+   * cannot split (for an insert) or underflow (for a removal) in turn.
+   * @return false if the tree is empty, with the header page still latched
+   */
+  auto FetchLeafPessimistic(std::string_view key, Context &ctx, bool for_insert) -> bool;
+
+  /** Read-latch the leaf a scan starting at `bound` begins with; see ScanLeaf. */
+  auto FetchScanLeaf(const std::string *bound, bool reverse, ReadPageGuard *leaf) -> bool;
+
+  static auto IsSafeForInsert(const BPlusTreeSlottedPage *page, std::string_view key) -> bool;
+  static auto IsSafeForRemove(const BPlusTreeSlottedPage *page, bool is_root, std::string_view key) -> bool;
+
+  /**
+   * Add the separator of the page just split at the end of the write set, and its new right sibling, to the parent
+   * latched in front of it, or to a new root if there is none.
+   */
+  void InsertIntoParent(Context &ctx, const std::string &separator, page_id_t right_page_id);
+
+  /**
+   * Fix up the page at the end of the write set after a removal from the subtree of `key`: collapse the root, or merge
+   * an underfull page with a sibling and walk up the latched ancestors as long as they underflow in turn.
+   */
+  void HandleUnderflow(Context &ctx, std::string_view key);
+
+  void SetPrevPageIdOf(page_id_t page_id, page_id_t prev_page_id);
+
+  // member variable
+  std::string index_name_;
+  BufferPoolManager *bpm_;
+  page_id_t header_page_id_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree_index.h
+//
+// Identification: src/include/storage/index/varlen_b_plus_tree_index.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/index/index.h"
+#include "storage/index/varlen_b_plus_tree.h"
+
+namespace bustub {
+
+/**
+ * B+ tree index for key schemas with variable-length (varchar) columns. Keys are stored as their memcomparable
+ * encoding (see MemcmpKeyEncoder) in a VarlenBPlusTree, so they take only as many bytes as their values need and
+ * scan in column order. The catalog picks it whenever the key schema is not inlined.
+ *
+ * Included (covering) columns are not supported.
+ */
+class VarlenBPlusTreeIndex : public Index {
+ public:
+  VarlenBPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+
+  auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  /** @return the tree key of an index key tuple */
+  auto MakeKey(const Tuple &key) const -> std::string;
+
+  /** Full scan, in descending key order if `reverse` is set */
+  auto GetBeginIterator(bool reverse = false) -> VarlenIndexIterator;
+
+ protected:
+  // container
+  std::shared_ptr<VarlenBPlusTree> container_;
+};
+
+}  // namespace bustub
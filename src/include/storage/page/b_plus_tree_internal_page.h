@@ -18,8 +18,8 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 12
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_HEADER_SIZE 16
+#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE - sizeof(KeyType)) / (sizeof(MappingType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -32,6 +32,10 @@ namespace bustub {
  *  --------------------------------------------------------------------------
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ * Like leaves, internal pages keep a link to their right sibling on the same level and a high key bounding their
+ * subtree, after the common header: | NextPageId (4) | HighKey (sizeof(KeyType)) |. The rightmost page of each
+ * level has no next page and is unbounded.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -47,6 +51,12 @@ class BPlusTreeInternalPage : public BPlusTreePage {
    */
   void Init(int max_size = INTERNAL_PAGE_SIZE);
 
+  // Right sibling on the same level, INVALID_PAGE_ID for the rightmost page
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  auto GetHighKey() const -> const KeyType &;
+  void SetHighKey(const KeyType &high_key);
+
   /**
    * @param index The index of the key to get. Index must be non-zero.
    * @return Key at index
@@ -73,6 +83,48 @@ class BPlusTreeInternalPage : public BPlusTreePage {
    */
   auto ValueAt(int index) const -> ValueType;
 
+  void SetValueAt(int index, const ValueType &value);
+
+  /**
+   * @param key the key to route
+   * @return the index of the child whose subtree may contain `key`
+   */
+  auto ChildIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /**
+   * @param key the key to route
+   * @return the child whose subtree may contain `key`
+   */
+  auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType;
+
+  /**
+   * Turn this empty page into a root with exactly two children.
+   */
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+
+  /**
+   * Insert (new_key, new_value) right after the child `old_value`. The page must not be full.
+   * @return the page size after insertion
+   */
+  auto InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value) -> int;
+
+  /**
+   * Remove the key & child at `index`, shifting the rest to the left.
+   */
+  void Remove(int index);
+
+  /**
+   * Split a full page while inserting (new_key, new_value) after `old_value`. The recipient must be empty; after
+   * the call its first key is the separator to push into the parent.
+   */
+  void SplitInsert(BPlusTreeInternalPage *recipient, const ValueType &old_value, const KeyType &new_key,
+                   const ValueType &new_value);
+
+  // Merge / redistribute helpers. `middle_key` is the separator between the two pages in their parent.
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
+  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
+  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
+
   /**
    * @brief For test only, return a string representing all keys in
    * this internal page, formatted as "(key1,key2,key3,...)"
@@ -100,6 +152,8 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   }
 
  private:
+  page_id_t next_page_id_;
+  KeyType high_key_;
   // Flexible array member for page data.
   MappingType array_[0];
 };
@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.h
+//
+// Identification: src/include/storage/page/b_plus_tree_key_search.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/**
+ * Binary search over the sorted (key, value) array of a B+ tree page through the key comparator. Both functions
+ * search entries[begin, end).
+ */
+template <typename KeyType, typename KeyComparator>
+struct ComparatorKeySearch {
+  /** @return the first index whose key is not less than `key`, or `end` if there is none */
+  template <typename Entry>
+  static auto LowerBound(const Entry *entries, int begin, int end, const KeyType &key, const KeyComparator &comparator)
+      -> int {
+    while (begin < end) {
+      int mid = begin + (end - begin) / 2;
+      if (comparator(entries[mid].first, key) < 0) {
+        begin = mid + 1;
+      } else {
+        end = mid;
+      }
+    }
+    return begin;
+  }
+
+  /** @return the first index whose key is greater than `key`, or `end` if there is none */
+  template <typename Entry>
+  static auto UpperBound(const Entry *entries, int begin, int end, const KeyType &key, const KeyComparator &comparator)
+      -> int {
+    while (begin < end) {
+      int mid = begin + (end - begin) / 2;
+      if (comparator(entries[mid].first, key) <= 0) {
+        begin = mid + 1;
+      } else {
+        end = mid;
+      }
+    }
+    return begin;
+  }
+};
+
+/**
+ * In-page search used by the B+ tree pages, picked by key type. Any key type goes through the comparator;
+ * GenericKey with GenericComparator is specialized below.
+ */
+template <typename KeyType, typename KeyComparator>
+struct BPlusTreeKeySearch : public ComparatorKeySearch<KeyType, KeyComparator> {};
+
+/**
+ * Integer keys (see IntegerKeyLayout) are compared as raw bytes with a branchless binary search; other schemas fall
+ * back to the comparator.
+ */
+template <size_t KeySize>
+struct BPlusTreeKeySearch<GenericKey<KeySize>, GenericComparator<KeySize>> {
+  using KeyType = GenericKey<KeySize>;
+  using KeyComparator = GenericComparator<KeySize>;
+  using Generic = ComparatorKeySearch<KeyType, KeyComparator>;
+
+  template <typename Entry>
+  static auto LowerBound(const Entry *entries, int begin, int end, const KeyType &key, const KeyComparator &comparator)
+      -> int {
+    switch (comparator.GetIntegerKeyLayout()) {
+      case IntegerKeyLayout::BIGINT:
+        return Search<IntegerKeyLayout::BIGINT, false>(entries, begin, end, key);
+      case IntegerKeyLayout::INTEGER:
+        return Search<IntegerKeyLayout::INTEGER, false>(entries, begin, end, key);
+      case IntegerKeyLayout::TWO_INTEGER:
+        return Search<IntegerKeyLayout::TWO_INTEGER, false>(entries, begin, end, key);
+      default:
+        return Generic::LowerBound(entries, begin, end, key, comparator);
+    }
+  }
+
+  template <typename Entry>
+  static auto UpperBound(const Entry *entries, int begin, int end, const KeyType &key, const KeyComparator &comparator)
+      -> int {
+    switch (comparator.GetIntegerKeyLayout()) {
+      case IntegerKeyLayout::BIGINT:
+        return Search<IntegerKeyLayout::BIGINT, true>(entries, begin, end, key);
+      case IntegerKeyLayout::INTEGER:
+        return Search<IntegerKeyLayout::INTEGER, true>(entries, begin, end, key);
+      case IntegerKeyLayout::TWO_INTEGER:
+        return Search<IntegerKeyLayout::TWO_INTEGER, true>(entries, begin, end, key);
+      default:
+        return Generic::UpperBound(entries, begin, end, key, comparator);
+    }
+  }
+
+ private:
+  /** Map the raw key bytes to an int64_t that orders like the key. */
+  template <IntegerKeyLayout Layout>
+  static auto Decode(const KeyType &key) -> int64_t {
+    if constexpr (Layout == IntegerKeyLayout::BIGINT) {
+      int64_t value;
+      memcpy(&value, key.data_, sizeof(value));
+      return value;
+    } else if constexpr (Layout == IntegerKeyLayout::INTEGER) {
+      int32_t value;
+      memcpy(&value, key.data_, sizeof(value));
+      return value;
+    } else {
+      int32_t high;
+      int32_t low;
+      memcpy(&high, key.data_, sizeof(high));
+      memcpy(&low, key.data_ + sizeof(high), sizeof(low));
+      // flipping the sign bit makes the second column order as unsigned below the first one
+      return static_cast<int64_t>(static_cast<uint64_t>(static_cast<int64_t>(high)) << 32 |
+                                  (static_cast<uint32_t>(low) ^ 0x80000000U));
+    }
+  }
+
+  /**
+   * Branchless binary search: the window halves on every step whatever the comparison says, so the loop compiles to
+   * conditional moves and both candidate midpoints of the next step are prefetched.
+   */
+  template <IntegerKeyLayout Layout, bool Upper, typename Entry>
+  static auto Search(const Entry *entries, int begin, int end, const KeyType &key) -> int {
+    const int64_t target = Decode<Layout>(key);
+    const Entry *base = entries + begin;
+    int len = end - begin;
+    if (len <= 0) {
+      return begin;
+    }
+    while (len > 1) {
+      int half = len / 2;
+      __builtin_prefetch(base + half / 2);
+      __builtin_prefetch(base + half + half / 2);
+      int64_t probe = Decode<Layout>(base[half].first);
+      base = (Upper ? probe <= target : probe < target) ? base + half : base;
+      len -= half;
+    }
+    int64_t last = Decode<Layout>(base->first);
+    return static_cast<int>(base - entries) + static_cast<int>(Upper ? last <= target : last < target);
+  }
+};
+
+}  // namespace bustub
@@ -19,8 +19,8 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 16
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_HEADER_SIZE 20
+#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - sizeof(KeyType)) / sizeof(MappingType))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
@@ -32,13 +32,21 @@ namespace bustub {
  * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
  *  ----------------------------------------------------------------------
  *
- *  Header format (size in byte, 16 bytes in total):
+ *  Header format (size in byte, 20 bytes plus one key in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * |  NextPageId (4)
- *  -----------------------------------------------
+ *  ----------------------------------------------------------------
+ * |  NextPageId (4) | PrevPageId (4) | HighKey (sizeof(KeyType))
+ *  ----------------------------------------------------------------
+ *
+ * The high key is an upper bound (exclusive) on the keys of this page and is only meaningful when there is a next
+ * page; the rightmost leaf is unbounded. B-link trees use it to detect that a concurrent split moved `key` to the
+ * right sibling.
+ *
+ * The previous page id links the leaves backwards for descending scans. Writers keep it in step with the next page
+ * id of the left sibling, latching leaves left to right; readers still check it against that next page id, since
+ * they hold no latch in between.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
@@ -57,7 +65,44 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
+  auto GetPrevPageId() const -> page_id_t;
+  void SetPrevPageId(page_id_t prev_page_id);
+  auto GetHighKey() const -> const KeyType &;
+  void SetHighKey(const KeyType &high_key);
   auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+  auto PairAt(int index) const -> const MappingType &;
+
+  /**
+   * @return the index of the first key that is not less than `key`, or GetSize() if there is none
+   */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /**
+   * @param[out] value the value stored with `key`, if found
+   * @return true if `key` exists in this page
+   */
+  auto Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const -> bool;
+
+  /**
+   * Insert a pair keeping the keys sorted. Duplicate keys are rejected.
+   * @return the page size after insertion (unchanged if `key` already exists)
+   */
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> int;
+
+  /**
+   * Remove `key` if it exists in this page.
+   * @return the page size after deletion
+   */
+  auto RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) -> int;
+
+  // Structure modification helpers; the caller holds write latches on both pages and maintains the parent.
+  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+  /** Like MoveHalfTo, but keep the first `keep` pairs in this page (used for uneven splits). */
+  void MoveTailTo(BPlusTreeLeafPage *recipient, int keep);
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
   /**
    * @brief for test only return a string representing all keys in
@@ -86,6 +131,8 @@ class BPlusTreeLeafPage : public BPlusTreePage {
 
  private:
   page_id_t next_page_id_;
+  page_id_t prev_page_id_;
+  KeyType high_key_;
   // Flexible array member for page data.
   MappingType array_[0];
 };
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_slotted_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_slotted_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define SLOTTED_PAGE_HEADER_SIZE 28
+
+/**
+ * Slotted B+ tree page for variable-length keys, used by VarlenBPlusTree as both leaf and internal page. Keys are
+ * byte strings ordered like memcmp (e.g. MemcmpKeyEncoder output), so a page never needs the key schema.
+ *
+ * Page format:
+ *  ------------------------------------------------------------------------------
+ * | HEADER | SLOT(0) | SLOT(1) | ... | SLOT(n) | FREE | KEY HEAP (keys in any order) |
+ *  ------------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 28 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | NextPageId (4) | PrevPageId (4) | HeapStart (4) |
+ * | FreedBytes (4) |
+ *  ---------------------------------------------------------------------
+ *
+ * Slots are kept in key order and hold the offset and length of their key in the heap, plus a RID in leaf pages or
+ * a child page id in internal pages. The heap grows down from the end of the page; removing a key leaves a hole
+ * that is counted in FreedBytes and reclaimed by Compact() once an insert needs the room. As in
+ * BPlusTreeInternalPage, the first key of an internal page is empty and ignored by lookups. MaxSize is unused, the
+ * capacity depends on the key lengths, and so does the minimum: a page other than the root is underfull once its
+ * slots and keys take up less than MIN_USED_SPACE bytes. Leaves are linked both ways; internal pages are not linked.
+ */
+class BPlusTreeSlottedPage : public BPlusTreePage {
+ public:
+  // Deleted to disallow initialization
+  BPlusTreeSlottedPage() = delete;
+  BPlusTreeSlottedPage(const BPlusTreeSlottedPage &other) = delete;
+
+  /** Longest key a page accepts. Any four keys fit in one page, so a split always leaves room for the new key. */
+  static constexpr int MAX_KEY_SIZE = (BUSTUB_PAGE_SIZE - SLOTTED_PAGE_HEADER_SIZE) / 4 - 12;
+
+  /** Bytes of slots and keys below which a page other than the root is underfull; a split leaves about twice that. */
+  static constexpr int MIN_USED_SPACE = (BUSTUB_PAGE_SIZE - SLOTTED_PAGE_HEADER_SIZE) / 4;
+
+  /**
+   * Writes the necessary header information to a newly created page, must be called after the creation of a new
+   * page to make a valid BPlusTreeSlottedPage
+   */
+  void Init(IndexPageType page_type);
+
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  auto GetPrevPageId() const -> page_id_t;
+  void SetPrevPageId(page_id_t prev_page_id);
+
+  /** @return the key at `index`; the view is invalidated by any change to the page */
+  auto KeyAt(int index) const -> std::string_view;
+  /** @return the RID at `index` of a leaf page */
+  auto RidAt(int index) const -> RID;
+  /** @return the child page id at `index` of an internal page */
+  auto ChildAt(int index) const -> page_id_t;
+
+  /** @return number of bytes left for new slots and keys, including the holes Compact() would reclaim */
+  auto GetFreeSpace() const -> int;
+
+  /** @return number of bytes taken up by the slots and keys of the entries */
+  auto GetUsedSpace() const -> int;
+
+  /** @return the number of bytes an entry with a `key_size` byte key takes up */
+  static auto EntrySize(int key_size) -> int;
+
+  /** @return the first index whose key is not less than `key`, or GetSize() if there is none */
+  auto KeyIndex(std::string_view key) const -> int;
+
+  /** @return the index of the child of an internal page whose subtree may contain `key` */
+  auto ChildIndex(std::string_view key) const -> int;
+
+  /**
+   * Insert a leaf entry at `index`, keeping the slots in key order.
+   * @return false if the page has no room for it
+   */
+  auto InsertRid(int index, std::string_view key, const RID &rid) -> bool;
+
+  /**
+   * Insert an internal entry at `index`, keeping the slots in key order.
+   * @return false if the page has no room for it
+   */
+  auto InsertChild(int index, std::string_view key, page_id_t child) -> bool;
+
+  /** Remove the entry at `index`; its key bytes become a hole in the heap. */
+  void RemoveAt(int index);
+
+  /** Drop the key of the first entry, which becomes the ignored first key of an internal page. */
+  void ClearFirstKey();
+
+  /** Rewrite the key heap without holes. */
+  void Compact();
+
+  /**
+   * Move the upper half of the entries, by bytes, to the empty page `recipient` of the same type. Both pages end up
+   * compacted and at most a little over half full.
+   */
+  void MoveHalfTo(BPlusTreeSlottedPage *recipient);
+
+  /**
+   * Append all entries to `recipient`, the page of the same type on their left, which must have room for them. The
+   * ignored first key of an internal page is replaced by `middle_key`, the separator of this page in the parent.
+   */
+  void MoveAllTo(BPlusTreeSlottedPage *recipient, std::string_view middle_key);
+
+ private:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t length_;
+    page_id_t page_id_;
+    uint32_t slot_num_;
+  };
+
+  static constexpr int DATA_SIZE = BUSTUB_PAGE_SIZE - SLOTTED_PAGE_HEADER_SIZE;
+
+  auto Slots() const -> const Slot * { return reinterpret_cast<const Slot *>(data_); }
+  auto Slots() -> Slot * { return reinterpret_cast<Slot *>(data_); }
+  auto Insert(int index, std::string_view key, page_id_t page_id, uint32_t slot_num) -> bool;
+
+  page_id_t next_page_id_;
+  page_id_t prev_page_id_;
+  int32_t heap_start_;
+  int32_t freed_bytes_;
+  // Flexible array member for page data.
+  char data_[0];
+};
+
+static_assert(sizeof(BPlusTreeSlottedPage) == SLOTTED_PAGE_HEADER_SIZE);
+
+}  // namespace bustub
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_header_page.h
+//
+// Identification: src/include/storage/page/extendible_hash_table_header_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cassert>
+#include <cstdlib>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ *
+ * Header Page for extendible hash table. It sits above the directory pages and routes a key to one of them by the
+ * top max_depth bits of its hash. Directory pages are created on first use, so unused slots hold INVALID_PAGE_ID.
+ *
+ * Header format (size in byte):
+ * --------------------------------------------------------------------
+ * | LSN (4) | PageId(4) | MaxDepth(4) | DirectoryPageIds(2048) | Free(2036)
+ * --------------------------------------------------------------------
+ */
+class ExtendibleHashTableHeaderPage {
+ public:
+  /**
+   * Initializes a freshly allocated header page with no directories.
+   *
+   * @param page_id the page id of this page
+   * @param max_depth the number of top hash bits used to pick a directory, at most HEADER_MAX_DEPTH
+   */
+  void Init(page_id_t page_id, uint32_t max_depth);
+
+  /**
+   * @return the page ID of this page
+   */
+  auto GetPageId() const -> page_id_t;
+
+  /**
+   * @return the lsn of this page
+   */
+  auto GetLSN() const -> lsn_t;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number to which to set the lsn field
+   */
+  void SetLSN(lsn_t lsn);
+
+  /**
+   * Maps a hash to the index of the directory responsible for it.
+   *
+   * @param hash the 32-bit hash of a key
+   * @return the directory index, taken from the top max_depth bits of hash
+   */
+  auto HashToDirectoryIndex(uint32_t hash) const -> uint32_t;
+
+  /**
+   * @param directory_idx the directory index to look up
+   * @return the directory page_id at directory_idx, or INVALID_PAGE_ID if it has not been created
+   */
+  auto GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t;
+
+  /**
+   * @param directory_idx the directory index to update
+   * @param directory_page_id the directory page_id to store there
+   */
+  void SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id);
+
+  /**
+   * @return the max depth the header was initialized with
+   */
+  auto GetMaxDepth() const -> uint32_t;
+
+  /**
+   * @return the number of directory slots, 2^max_depth
+   */
+  auto MaxSize() const -> uint32_t;
+
+ private:
+  page_id_t page_id_;
+  lsn_t lsn_;
+  uint32_t max_depth_;
+  page_id_t directory_page_ids_[HEADER_ARRAY_SIZE];
+};
+
+static_assert(sizeof(ExtendibleHashTableHeaderPage) <= BUSTUB_PAGE_SIZE);
+
+}  // namespace bustub
@@ -70,6 +70,17 @@ class HashTableBlockPage {
    */
   auto Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) -> bool;
 
+  /**
+   * Writes a key and value over the tombstone at an index and marks it readable again. Unlike Insert, this does not
+   * claim the index atomically, so the caller must keep other writers out of the block.
+   *
+   * @param bucket_ind index of the tombstone
+   * @param key key to insert
+   * @param value value to insert
+   * @return false if the index is not a tombstone
+   */
+  auto ReuseTombstone(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) -> bool;
+
   /**
    * Removes a key and value at index.
    *
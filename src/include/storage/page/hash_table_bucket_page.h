@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -31,7 +32,11 @@ namespace bustub {
  *
  *  Here '+' means concatenation.
  *  The above format omits the space required for the occupied_ and
- *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
+ *  readable_ arrays and the per-slot fingerprints. More information is in storage/page/hash_table_page_defs.h.
+ *
+ *  Every slot also stores one byte of its key's hash. Lookups compare the probe's fingerprint against a group of
+ *  BUCKET_GROUP_SIZE slots at a time and only call the key comparator on the slots that match, so the callers pass
+ *  the key's hash along with the key.
  *
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -43,9 +48,10 @@ class HashTableBucketPage {
   /**
    * Scan the bucket and collect values that have the matching key
    *
+   * @param hash the hash of key
    * @return true if at least one key matched
    */
-  auto GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool;
+  auto GetValue(KeyType key, KeyComparator cmp, uint32_t hash, std::vector<ValueType> *result) const -> bool;
 
   /**
    * Attempts to insert a key and value in the bucket.  Uses the occupied_
@@ -53,16 +59,18 @@ class HashTableBucketPage {
    *
    * @param key key to insert
    * @param value value to insert
+   * @param hash the hash of key, whose fingerprint is stored with the pair
    * @return true if inserted, false if duplicate KV pair or bucket is full
    */
-  auto Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool;
+  auto Insert(KeyType key, ValueType value, KeyComparator cmp, uint32_t hash) -> bool;
 
   /**
    * Removes a key and value.
    *
+   * @param hash the hash of key
    * @return true if removed, false if not found
    */
-  auto Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool;
+  auto Remove(KeyType key, ValueType value, KeyComparator cmp, uint32_t hash) -> bool;
 
   /**
    * Gets the key at an index in the bucket.
@@ -120,28 +128,42 @@ class HashTableBucketPage {
   /**
    * @return the number of readable elements, i.e. current size
    */
-  auto NumReadable() -> uint32_t;
+  auto NumReadable() const -> uint32_t;
 
   /**
    * @return whether the bucket is full
    */
-  auto IsFull() -> bool;
+  auto IsFull() const -> bool;
 
   /**
    * @return whether the bucket is empty
    */
-  auto IsEmpty() -> bool;
+  auto IsEmpty() const -> bool;
 
   /**
    * Prints the bucket's occupancy information
    */
   void PrintBucket();
 
+  /**
+   * @return the fingerprint stored for a key with the given hash. It is taken from bits that neither the directory
+   * (low bits) nor the header (top bits) consumes, so keys sharing a bucket still differ in it.
+   */
+  static auto Fingerprint(uint32_t hash) -> uint8_t { return static_cast<uint8_t>(hash >> 12); }
+
  private:
+  /** @return the bits of a bitmap covering the slots of one group, bit i standing for slot i of the group */
+  static auto GroupBits(const char *bitmap, uint32_t group) -> uint32_t;
+
+  /** @return a mask of the slots in a group whose fingerprint equals fingerprint, readable or not */
+  auto MatchFingerprint(uint32_t group, uint8_t fingerprint) const -> uint32_t;
+
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
-  char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  char occupied_[BUCKET_ARRAY_SIZE / 8];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
-  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  char readable_[BUCKET_ARRAY_SIZE / 8];
+  // Fingerprint of the key in each slot, see Fingerprint().
+  uint8_t fingerprints_[BUCKET_ARRAY_SIZE];
   // Flexible array member for page data.
   MappingType array_[1];
 };
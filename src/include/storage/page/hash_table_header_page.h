@@ -17,6 +17,7 @@
 #include <cstdlib>
 #include <string>
 
+#include "common/config.h"
 #include "storage/index/generic_key.h"
 #include "storage/page/hash_table_page_defs.h"
 
@@ -84,18 +85,31 @@ class HashTableHeaderPage {
    */
   auto GetBlockPageId(size_t index) -> page_id_t;
 
+  /**
+   * Replaces the page_id of the index-th block
+   *
+   * @param index the index of the block
+   * @param page_id the new page_id, INVALID_PAGE_ID if the block has no page
+   */
+  void SetBlockPageId(size_t index, page_id_t page_id);
+
   /**
    * @return the number of blocks currently stored in the header page
    */
   auto NumBlocks() -> size_t;
 
+  /**
+   * @return the number of block page_ids that fit in one header page
+   */
+  static auto MaxNumBlocks() -> size_t;
+
  private:
-  __attribute__((unused)) lsn_t lsn_;
-  __attribute__((unused)) size_t size_;
-  __attribute__((unused)) page_id_t page_id_;
-  __attribute__((unused)) size_t next_ind_;
+  lsn_t lsn_;
+  size_t size_;
+  page_id_t page_id_;
+  size_t next_ind_;
   // Flexible array member for page data.
-  __attribute__((unused)) page_id_t block_page_ids_[1];
+  page_id_t block_page_ids_[1];
 };
 
 }  // namespace bustub
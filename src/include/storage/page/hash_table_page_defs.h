@@ -33,18 +33,32 @@
  */
 #define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
 
+/**
+ * BUCKET_GROUP_SIZE is the number of bucket slots probed together: a bucket page keeps a 1-byte hash fingerprint per
+ * slot and compares a group's fingerprints against the probe in one SIMD instruction.
+ */
+#define BUCKET_GROUP_SIZE 16
+
 /**
  * BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in an extendible hash index bucket page.
- * The computation is the same as the above BLOCK_ARRAY_SIZE, but blocks and buckets have different implementations
- * of search, insertion, removal, and helper methods.
+ * It is a whole number of groups, each taking BUCKET_GROUP_SIZE pairs, BUCKET_GROUP_SIZE fingerprint bytes, and two
+ * bytes apiece of the occupied_ and readable_ bitmaps.
  */
-#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_ARRAY_SIZE \
+  (BUCKET_GROUP_SIZE * (BUSTUB_PAGE_SIZE / (BUCKET_GROUP_SIZE * (sizeof(MappingType) + 1) + BUCKET_GROUP_SIZE / 4)))
 
 /**
  * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
  * This is 512 because the directory array must grow in powers of 2, and 1024 page_ids leaves zero room for
  * storage of the other member variables: page_id_, lsn_, global_depth_, and the array local_depths_.
- * Extending the directory implementation to span multiple pages would be a meaningful improvement to the
- * implementation.
+ * Tables that outgrow one directory spread over several, see HEADER_MAX_DEPTH below.
  */
 #define DIRECTORY_ARRAY_SIZE 512
+
+/**
+ * HEADER_MAX_DEPTH is the largest number of top hash bits an extendible hash table header page can use to pick a
+ * directory page, so a header points at up to HEADER_ARRAY_SIZE directories. Directories index buckets by the low
+ * hash bits, which leaves 32 - HEADER_MAX_DEPTH bits for them, far more than DIRECTORY_ARRAY_SIZE needs.
+ */
+#define HEADER_MAX_DEPTH 9
+#define HEADER_ARRAY_SIZE (1 << HEADER_MAX_DEPTH)
@@ -5,6 +5,8 @@
 namespace bustub {
 
 class BufferPoolManager;
+class ReadPageGuard;
+class WritePageGuard;
 
 class BasicPageGuard {
  public:
@@ -59,6 +61,26 @@ class BasicPageGuard {
    */
   ~BasicPageGuard();
 
+  /**
+   * @brief Upgrade a BasicPageGuard to a ReadPageGuard
+   *
+   * The protected page is not evicted from the buffer pool during the upgrade,
+   * and the basic page guard is made invalid after calling this function.
+   *
+   * @return an upgraded ReadPageGuard
+   */
+  auto UpgradeRead() -> ReadPageGuard;
+
+  /**
+   * @brief Upgrade a BasicPageGuard to a WritePageGuard
+   *
+   * The protected page is not evicted from the buffer pool during the upgrade,
+   * and the basic page guard is made invalid after calling this function.
+   *
+   * @return an upgraded WritePageGuard
+   */
+  auto UpgradeWrite() -> WritePageGuard;
+
   auto PageId() -> page_id_t { return page_->GetPageId(); }
 
   auto GetData() -> const char * { return page_->GetData(); }
@@ -143,6 +165,8 @@ class ReadPageGuard {
   }
 
  private:
+  friend class BasicPageGuard;
+
   // You may choose to get rid of this and add your own private variables.
   BasicPageGuard guard_;
 };
@@ -210,6 +234,8 @@ class WritePageGuard {
   }
 
  private:
+  friend class BasicPageGuard;
+
   // You may choose to get rid of this and add your own private variables.
   BasicPageGuard guard_;
 };
@@ -0,0 +1,83 @@
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return true if the expression only reads columns in `covered` */
+auto ReadsOnlyColumns(const AbstractExpressionRef &expr, const std::unordered_set<uint32_t> &covered) -> bool {
+  if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+      column_value_expr != nullptr) {
+    return column_value_expr->GetTupleIdx() == 0 && covered.count(column_value_expr->GetColIdx()) > 0;
+  }
+  for (const auto &child : expr->GetChildren()) {
+    if (!ReadsOnlyColumns(child, covered)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeIndexScanAsIndexOnly(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeIndexScanAsIndexOnly(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::Projection) {
+    return optimized_plan;
+  }
+  const auto &projection = dynamic_cast<const ProjectionPlanNode &>(*optimized_plan);
+
+  // Limits pass rows through unchanged, so the projection decides which columns are read
+  std::vector<AbstractPlanNodeRef> limits;
+  auto child_plan = optimized_plan->GetChildAt(0);
+  while (child_plan->GetType() == PlanType::Limit) {
+    limits.push_back(child_plan);
+    child_plan = child_plan->GetChildAt(0);
+  }
+  if (child_plan->GetType() != PlanType::IndexScan) {
+    return optimized_plan;
+  }
+  const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*child_plan);
+  // Point lookups read the table to check their predicate
+  if (index_scan.IsIndexOnly() || index_scan.IsPointLookup()) {
+    return optimized_plan;
+  }
+
+  // The key columns and the included columns of a covering index can be read from the index entries. Variable-length
+  // keys are stored encoded and cannot be turned back into values.
+  const auto *index_info = catalog_.GetIndex(index_scan.GetIndexOid());
+  if (!index_info->key_schema_.IsInlined()) {
+    return optimized_plan;
+  }
+  const auto &entry_attrs = index_info->index_->GetEntryAttrs();
+  std::unordered_set<uint32_t> covered(entry_attrs.begin(), entry_attrs.end());
+  for (const auto &expr : projection.GetExpressions()) {
+    if (!ReadsOnlyColumns(expr, covered)) {
+      return optimized_plan;
+    }
+  }
+
+  AbstractPlanNodeRef new_plan = std::make_shared<IndexScanPlanNode>(
+      index_scan.output_schema_, index_scan.GetIndexOid(), index_scan.IsReverse(), /* index_only = */ true,
+      index_scan.GetParallelism(), index_scan.IsOrdered());
+  for (auto limit = limits.rbegin(); limit != limits.rend(); ++limit) {
+    new_plan = (*limit)->CloneWithChildren({new_plan});
+  }
+  return optimized_plan->CloneWithChildren({new_plan});
+}
+
+}  // namespace bustub
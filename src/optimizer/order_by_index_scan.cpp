@@ -32,10 +32,13 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
     const auto &sort_plan = dynamic_cast<const SortPlanNode &>(*optimized_plan);
     const auto &order_bys = sort_plan.GetOrderBy();
 
+    // The index is scanned in one direction, so all order-bys are asc (or default) or all are desc; a desc scan
+    // walks the leaves backwards, and a limit on top of it stops after the first rows.
+    bool reverse = !order_bys.empty() && order_bys[0].first == OrderByType::DESC;
     std::vector<uint32_t> order_by_column_ids;
     for (const auto &[order_type, expr] : order_bys) {
-      // Order type is asc or default
-      if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT)) {
+      bool ascending = order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT;
+      if (reverse ? order_type != OrderByType::DESC : !ascending) {
         return optimized_plan;
       }
 
@@ -50,7 +53,24 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
 
     // Has exactly one child
     BUSTUB_ENSURE(optimized_plan->children_.size() == 1, "Sort with multiple children?? Impossible!");
-    const auto &child_plan = optimized_plan->children_[0];
+    auto child_plan = optimized_plan->children_[0];
+
+    // When the order-by columns are in the select list, the sort sits on top of the projection; map them through it
+    // to the scanned table's columns, and keep the projection above the index scan.
+    AbstractPlanNodeRef projection_plan;
+    if (child_plan->GetType() == PlanType::Projection) {
+      const auto &projection = dynamic_cast<const ProjectionPlanNode &>(*child_plan);
+      for (auto &column_id : order_by_column_ids) {
+        const auto *column_value_expr =
+            dynamic_cast<const ColumnValueExpression *>(projection.GetExpressions()[column_id].get());
+        if (column_value_expr == nullptr) {
+          return optimized_plan;
+        }
+        column_id = column_value_expr->GetColIdx();
+      }
+      projection_plan = child_plan;
+      child_plan = child_plan->GetChildAt(0);
+    }
 
     if (child_plan->GetType() == PlanType::SeqScan) {
       const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
@@ -58,6 +78,10 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
       const auto indices = catalog_.GetTableIndexes(table_info->name_);
 
       for (const auto *index : indices) {
+        // Hash indexes keep no key order
+        if (index->index_type_ == IndexType::HashTableIndex) {
+          continue;
+        }
         const auto &columns = index->key_schema_.GetColumns();
         // check index key schema == order by columns
         bool valid = true;
@@ -69,7 +93,12 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
             }
           }
           if (valid) {
-            return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
+            AbstractPlanNodeRef index_scan =
+                std::make_shared<IndexScanPlanNode>(child_plan->output_schema_, index->index_oid_, reverse);
+            if (projection_plan != nullptr) {
+              return projection_plan->CloneWithChildren({index_scan});
+            }
+            return index_scan;
           }
         }
       }
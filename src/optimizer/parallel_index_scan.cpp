@@ -0,0 +1,64 @@
+#include <memory>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+auto WithParallelism(const IndexScanPlanNode &index_scan, size_t parallelism, bool ordered) -> AbstractPlanNodeRef {
+  return std::make_shared<IndexScanPlanNode>(index_scan.output_schema_, index_scan.GetIndexOid(),
+                                             index_scan.IsReverse(), index_scan.IsIndexOnly(), parallelism, ordered);
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeIndexScanAsParallel(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  if (index_scan_parallelism_ <= 1) {
+    return plan;
+  }
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeIndexScanAsParallel(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::IndexScan) {
+    const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*optimized_plan);
+    // Only fixed-size keys have the typed separators SplitRange works with, and a point lookup has no range to split
+    const auto *index_info = catalog_.GetIndex(index_scan.GetIndexOid());
+    if (index_scan.GetParallelism() == 1 && !index_scan.IsPointLookup() && index_info->key_schema_.IsInlined()) {
+      return WithParallelism(index_scan, index_scan_parallelism_, /* ordered = */ true);
+    }
+    return optimized_plan;
+  }
+
+  // An aggregation does not depend on the order of its input, even through projections
+  if (optimized_plan->GetType() != PlanType::Aggregation) {
+    return optimized_plan;
+  }
+  std::vector<AbstractPlanNodeRef> projections;
+  auto child_plan = optimized_plan->GetChildAt(0);
+  while (child_plan->GetType() == PlanType::Projection) {
+    projections.push_back(child_plan);
+    child_plan = child_plan->GetChildAt(0);
+  }
+  if (child_plan->GetType() != PlanType::IndexScan) {
+    return optimized_plan;
+  }
+  const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*child_plan);
+  if (index_scan.GetParallelism() == 1 || !index_scan.IsOrdered()) {
+    return optimized_plan;
+  }
+  auto new_plan = WithParallelism(index_scan, index_scan.GetParallelism(), /* ordered = */ false);
+  for (auto projection = projections.rbegin(); projection != projections.rend(); ++projection) {
+    new_plan = (*projection)->CloneWithChildren({new_plan});
+  }
+  return optimized_plan->CloneWithChildren({new_plan});
+}
+
+}  // namespace bustub
@@ -0,0 +1,107 @@
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/**
+ * Find a `column = constant` (or `constant = column`) term among the conjuncts of `expr` whose column is a key the
+ * catalog has a hash index for.
+ * @return the index and the constant, or nullopt
+ */
+auto MatchPointLookup(const Catalog &catalog, const std::string &table_name, const AbstractExpressionRef &expr)
+    -> std::optional<std::pair<const IndexInfo *, AbstractExpressionRef>> {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get()); logic_expr != nullptr) {
+    if (logic_expr->logic_type_ != LogicType::And) {
+      return std::nullopt;
+    }
+    for (const auto &child : logic_expr->GetChildren()) {
+      if (auto match = MatchPointLookup(catalog, table_name, child); match.has_value()) {
+        return match;
+      }
+    }
+    return std::nullopt;
+  }
+
+  const auto *comp_expr = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (comp_expr == nullptr || comp_expr->comp_type_ != ComparisonType::Equal) {
+    return std::nullopt;
+  }
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(comp_expr->GetChildAt(0).get());
+  auto constant_expr = comp_expr->GetChildAt(1);
+  if (column_expr == nullptr) {
+    column_expr = dynamic_cast<const ColumnValueExpression *>(comp_expr->GetChildAt(1).get());
+    constant_expr = comp_expr->GetChildAt(0);
+  }
+  // The constant becomes the index key as is, so it must have the column's type
+  if (column_expr == nullptr || dynamic_cast<const ConstantValueExpression *>(constant_expr.get()) == nullptr ||
+      constant_expr->GetReturnType() != column_expr->GetReturnType()) {
+    return std::nullopt;
+  }
+
+  const auto key_attrs = std::vector{column_expr->GetColIdx()};
+  for (const auto *index_info : catalog.GetTableIndexes(table_name)) {
+    if (index_info->index_type_ == IndexType::HashTableIndex && index_info->index_->GetKeyAttrs() == key_attrs) {
+      return std::make_optional(std::make_pair(index_info, constant_expr));
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSeqScanAsIndexScan(child));
+  }
+
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // The predicate is either still in a filter on top of the scan, or already merged into it
+  const SeqScanPlanNode *seq_scan_plan = nullptr;
+  AbstractExpressionRef predicate;
+  if (optimized_plan->GetType() == PlanType::Filter) {
+    const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+    BUSTUB_ASSERT(optimized_plan->children_.size() == 1, "must have exactly one children");
+    const auto &child_plan = *optimized_plan->children_[0];
+    if (child_plan.GetType() == PlanType::SeqScan) {
+      seq_scan_plan = &dynamic_cast<const SeqScanPlanNode &>(child_plan);
+      if (seq_scan_plan->filter_predicate_ != nullptr) {
+        return optimized_plan;
+      }
+      predicate = filter_plan.GetPredicate();
+    }
+  } else if (optimized_plan->GetType() == PlanType::SeqScan) {
+    seq_scan_plan = &dynamic_cast<const SeqScanPlanNode &>(*optimized_plan);
+    predicate = seq_scan_plan->filter_predicate_;
+  }
+  if (predicate == nullptr) {
+    return optimized_plan;
+  }
+
+  // Equality on a hash-indexed column becomes a single probe. The whole predicate is kept and checked on the rows
+  // found, for its other terms.
+  if (auto match = MatchPointLookup(catalog_, seq_scan_plan->table_name_, predicate); match.has_value()) {
+    auto [index_info, pred_key] = *match;
+    return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index_info->index_oid_,
+                                               std::move(predicate), std::move(pred_key));
+  }
+  return optimized_plan;
+}
+
+}  // namespace bustub
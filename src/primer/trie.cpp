@@ -1,192 +1,518 @@
 #include "primer/trie.h"
+#include <iterator>
 #include <string_view>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "common/exception.h"
 
 namespace bustub {
 
+TrieChildren::TrieChildren(const TrieChildren &other) : size_(other.size_) {
+  // An empty copy starts over as an unallocated Node4
+  if (size_ == 0) {
+    return;
+  }
+  kind_ = other.kind_;
+  std::copy(std::begin(other.keys_), std::end(other.keys_), keys_);
+  if (other.index_ != nullptr) {
+    index_ = std::make_unique<uint8_t[]>(256);
+    std::copy(other.index_.get(), other.index_.get() + 256, index_.get());
+  }
+  slots_ = std::make_unique<std::shared_ptr<const TrieNode>[]>(Capacity(kind_));
+  std::copy(other.slots_.get(), other.slots_.get() + (kind_ == Kind::Node256 ? 256 : size_), slots_.get());
+}
+
+auto TrieChildren::operator=(const TrieChildren &other) -> TrieChildren & {
+  *this = TrieChildren(other);
+  return *this;
+}
+
+auto TrieChildren::Capacity(Kind kind) -> size_t {
+  switch (kind) {
+    case Kind::Node4:
+      return 4;
+    case Kind::Node16:
+      return 16;
+    case Kind::Node48:
+      return 48;
+    case Kind::Node256:
+      return 256;
+  }
+  return 0;
+}
+
+auto TrieChildren::FindSlot(uint8_t byte) const -> std::shared_ptr<const TrieNode> * {
+  switch (kind_) {
+    case Kind::Node4:
+      for (size_t i = 0; i < size_; i++) {
+        if (keys_[i] == byte) {
+          return &slots_[i];
+        }
+      }
+      return nullptr;
+    case Kind::Node16: {
+#ifdef __SSE2__
+      __m128i probe = _mm_set1_epi8(static_cast<char>(byte));
+      __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys_));
+      uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(keys, probe))) & ((1U << size_) - 1);
+      return mask == 0 ? nullptr : &slots_[__builtin_ctz(mask)];
+#else
+      auto *key = std::lower_bound(keys_, keys_ + size_, byte);
+      return key == keys_ + size_ || *key != byte ? nullptr : &slots_[key - keys_];
+#endif
+    }
+    case Kind::Node48:
+      return index_[byte] == 0 ? nullptr : &slots_[index_[byte] - 1];
+    case Kind::Node256:
+      return slots_[byte] == nullptr ? nullptr : &slots_[byte];
+  }
+  return nullptr;
+}
+
+auto TrieChildren::Find(char c) const -> const std::shared_ptr<const TrieNode> * {
+  return FindSlot(static_cast<uint8_t>(c));
+}
+
+auto TrieChildren::UpperBound(int byte) const -> std::pair<uint8_t, const std::shared_ptr<const TrieNode> *> {
+  switch (kind_) {
+    case Kind::Node4:
+    case Kind::Node16: {
+      const auto *key = std::upper_bound(keys_, keys_ + size_, byte, [](int b, uint8_t k) { return b < k; });
+      if (key != keys_ + size_) {
+        return {*key, &slots_[key - keys_]};
+      }
+      break;
+    }
+    case Kind::Node48:
+      for (int next = byte + 1; next < 256; next++) {
+        if (index_[next] != 0) {
+          return {next, &slots_[index_[next] - 1]};
+        }
+      }
+      break;
+    case Kind::Node256:
+      for (int next = byte + 1; next < 256; next++) {
+        if (slots_[next] != nullptr) {
+          return {next, &slots_[next]};
+        }
+      }
+      break;
+  }
+  return {0, nullptr};
+}
+
+void TrieChildren::Insert(uint8_t byte, std::shared_ptr<const TrieNode> child) {
+  if (slots_ == nullptr) {
+    slots_ = std::make_unique<std::shared_ptr<const TrieNode>[]>(Capacity(kind_));
+  }
+  switch (kind_) {
+    case Kind::Node4:
+    case Kind::Node16: {
+      size_t pos = std::lower_bound(keys_, keys_ + size_, byte) - keys_;
+      std::move_backward(keys_ + pos, keys_ + size_, keys_ + size_ + 1);
+      std::move_backward(slots_.get() + pos, slots_.get() + size_, slots_.get() + size_ + 1);
+      keys_[pos] = byte;
+      slots_[pos] = std::move(child);
+      break;
+    }
+    case Kind::Node48:
+      slots_[size_] = std::move(child);
+      index_[byte] = size_ + 1;
+      break;
+    case Kind::Node256:
+      slots_[byte] = std::move(child);
+      break;
+  }
+  size_++;
+}
+
+void TrieChildren::Set(char c, std::shared_ptr<const TrieNode> child) {
+  auto byte = static_cast<uint8_t>(c);
+  if (auto *slot = FindSlot(byte); slot != nullptr) {
+    *slot = std::move(child);
+    return;
+  }
+  if (size_ == Capacity(kind_)) {
+    Resize(kind_ == Kind::Node4 ? Kind::Node16 : kind_ == Kind::Node16 ? Kind::Node48 : Kind::Node256);
+  }
+  Insert(byte, std::move(child));
+}
+
+void TrieChildren::Erase(char c) {
+  auto byte = static_cast<uint8_t>(c);
+  switch (kind_) {
+    case Kind::Node4:
+    case Kind::Node16: {
+      auto *key = std::lower_bound(keys_, keys_ + size_, byte);
+      if (key == keys_ + size_ || *key != byte) {
+        return;
+      }
+      size_t pos = key - keys_;
+      std::move(keys_ + pos + 1, keys_ + size_, keys_ + pos);
+      std::move(slots_.get() + pos + 1, slots_.get() + size_, slots_.get() + pos);
+      slots_[size_ - 1].reset();
+      break;
+    }
+    case Kind::Node48: {
+      if (index_[byte] == 0) {
+        return;
+      }
+      // Keep the slots dense: the last one moves into the hole
+      size_t slot = index_[byte] - 1;
+      size_t last = size_ - 1;
+      if (slot != last) {
+        slots_[slot] = std::move(slots_[last]);
+        *std::find(index_.get(), index_.get() + 256, last + 1) = slot + 1;
+      }
+      slots_[last].reset();
+      index_[byte] = 0;
+      break;
+    }
+    case Kind::Node256:
+      if (slots_[byte] == nullptr) {
+        return;
+      }
+      slots_[byte].reset();
+      break;
+  }
+  size_--;
+
+  // Shrink a little below the size the layout grew at, so that a child coming and going does not resize every time
+  if (kind_ == Kind::Node16 && size_ <= 3) {
+    Resize(Kind::Node4);
+  } else if (kind_ == Kind::Node48 && size_ <= 12) {
+    Resize(Kind::Node16);
+  } else if (kind_ == Kind::Node256 && size_ <= 40) {
+    Resize(Kind::Node48);
+  }
+}
+
+void TrieChildren::Resize(Kind kind) {
+  TrieChildren resized;
+  resized.kind_ = kind;
+  resized.slots_ = std::make_unique<std::shared_ptr<const TrieNode>[]>(Capacity(kind));
+  if (kind == Kind::Node48) {
+    resized.index_ = std::make_unique<uint8_t[]>(256);
+  }
+  Visit(*this, [&resized](uint8_t byte, std::shared_ptr<const TrieNode> &child) {
+    resized.Insert(byte, std::move(child));
+  });
+  *this = std::move(resized);
+}
+
+namespace {
+
+// Hands out the nodes a write may modify. A plain write copies every node on its path. A write in place modifies the
+// nodes that nothing but the pointer it reached them through references, which only earlier writes in place to the
+// same, still unshared trie can have created. The pointers passed in are the ones the parents (or the trie) hold.
+class NodeWriter {
+ public:
+  explicit NodeWriter(bool in_place) : in_place_(in_place) {}
+
+  auto Owns(const std::shared_ptr<const TrieNode> &node) const -> bool { return in_place_ && node.use_count() == 1; }
+
+  // Returns the node itself if the write owns it, or else a copy.
+  auto Writable(const std::shared_ptr<const TrieNode> &node) const -> std::shared_ptr<TrieNode> {
+    if (Owns(node)) {
+      return std::const_pointer_cast<TrieNode>(node);
+    }
+    return std::shared_ptr<TrieNode>(node->Clone());
+  }
+
+  // The children for a node that replaces `node`: moved out of it if the write owns it, since it is dropped then.
+  auto TakeChildren(const std::shared_ptr<const TrieNode> &node) const -> TrieChildren {
+    if (Owns(node)) {
+      return std::move(std::const_pointer_cast<TrieNode>(node)->children_);
+    }
+    return node->children_;
+  }
+
+ private:
+  bool in_place_;
+};
+
+// A node that replaces the given one, with its children and prefix, and holding the value (or none, for void).
 template <class T>
-auto Trie::Get(std::string_view key) const -> const T * {
-  // throw NotImplementedException("Trie::Get is not implemented.");
+auto Replace(const std::shared_ptr<const TrieNode> &node, std::shared_ptr<T> value, const NodeWriter &writer)
+    -> std::shared_ptr<TrieNode> {
+  std::shared_ptr<TrieNode> replaced;
+  if constexpr (std::is_void_v<T>) {
+    replaced = std::make_shared<TrieNode>(writer.TakeChildren(node));
+  } else {
+    replaced = std::make_shared<TrieNodeWithValue<T>>(writer.TakeChildren(node), std::move(value));
+  }
+  replaced->prefix_ = node->prefix_;
+  return replaced;
+}
 
-  // You should walk through the trie to find the node corresponding to the key. If the node doesn't exist, return
-  // nullptr. After you find the node, you should use `dynamic_cast` to cast it to `const TrieNodeWithValue<T> *`. If
-  // dynamic_cast returns `nullptr`, it means the type of the value is mismatched, and you should return nullptr.
-  // Otherwise, return the value.
+// A node below the root that has no value is dropped once it has no children, and merged into its child once it
+// has only one, so that chains stay compressed.
+auto Compress(std::shared_ptr<const TrieNode> node, const NodeWriter &writer) -> std::shared_ptr<const TrieNode> {
+  if (node->is_value_node_ || node->children_.Size() > 1) {
+    return node;
+  }
+  std::shared_ptr<TrieNode> merged;
+  node->children_.ForEach([&](char c, const std::shared_ptr<const TrieNode> &child) {
+    merged = writer.Writable(child);
+    merged->prefix_ = node->prefix_ + c + merged->prefix_;
+  });
+  return merged;
+}
+
+// Returns the node with the value put at the key, which is relative to the node. Only the nodes on the way are
+// copied, or modified in place when the writer owns them.
+template <class T>
+auto PutBelow(const std::shared_ptr<const TrieNode> &node, std::string_view key, const std::shared_ptr<T> &value,
+              const NodeWriter &writer) -> std::shared_ptr<const TrieNode> {
+  if (key.empty()) {
+    return Replace<T>(node, value, writer);
+  }
+  auto new_node = writer.Writable(node);
+  auto rest = key.substr(1);
+  const auto *child = new_node->children_.Find(key.front());
+  if (child == nullptr) {
+    // A new leaf takes the rest of the key as its prefix
+    auto leaf = std::make_shared<TrieNodeWithValue<T>>(value);
+    leaf->prefix_ = rest;
+    new_node->children_.Set(key.front(), std::move(leaf));
+    return new_node;
+  }
 
-  // 所有的操作都不应该在原树上进行,尽可能的复用现有存在的节点,并且创建新的节点来代表新树
-  // 智能指针shared_ptr的使用 创建一个新的节点,使用Clone()函数 在新树上复用一个现有的节点,可以拷贝
+  const auto &prefix = (*child)->prefix_;
+  size_t common = std::mismatch(prefix.begin(), prefix.begin() + std::min(prefix.size(), rest.size()), rest.begin())
+                      .first -
+                  prefix.begin();
+  if (common == prefix.size()) {
+    new_node->children_.Set(key.front(), PutBelow<T>(*child, rest.substr(common), value, writer));
+    return new_node;
+  }
 
-  std::shared_ptr<const bustub::TrieNode> temp_root = root_;
-  for (const char &c : key) {
-    if (temp_root->children_.count(c)) {
-      temp_root = temp_root->children_.at(c);
-    } else {
+  // The key ends or turns off inside the child's prefix, so the prefix is split there by a new node
+  std::shared_ptr<TrieNode> split;
+  if (common == rest.size()) {
+    split = std::make_shared<TrieNodeWithValue<T>>(value);
+  } else {
+    split = std::make_shared<TrieNode>();
+    auto leaf = std::make_shared<TrieNodeWithValue<T>>(value);
+    leaf->prefix_ = rest.substr(common + 1);
+    split->children_.Set(rest[common], std::move(leaf));
+  }
+  split->prefix_ = prefix.substr(0, common);
+  char lower_edge = prefix[common];
+  auto lower = writer.Writable(*child);
+  lower->prefix_ = lower->prefix_.substr(common + 1);
+  split->children_.Set(lower_edge, std::move(lower));
+  new_node->children_.Set(key.front(), std::move(split));
+  return new_node;
+}
+
+// Returns the node without the value at the key, which is relative to the node and must have a value. Nodes are
+// copied or modified in place like in PutBelow; each one is made writable before its child is looked at, so that a
+// child only its copy references is not taken for one the write owns.
+auto RemoveBelow(const std::shared_ptr<const TrieNode> &node, std::string_view key, const NodeWriter &writer)
+    -> std::shared_ptr<const TrieNode> {
+  if (key.empty()) {
+    return Replace<void>(node, nullptr, writer);
+  }
+  auto new_node = writer.Writable(node);
+  const auto *child = new_node->children_.Find(key.front());
+  auto new_child = RemoveBelow(*child, key.substr(1 + (*child)->prefix_.size()), writer);
+  if (auto compressed = Compress(std::move(new_child), writer); compressed != nullptr) {
+    new_node->children_.Set(key.front(), std::move(compressed));
+  } else {
+    new_node->children_.Erase(key.front());
+  }
+  return new_node;
+}
+
+}  // namespace
+
+auto Trie::FindNode(std::string_view key) const -> const std::shared_ptr<const TrieNode> * {
+  // Raw pointers all the way down, so that concurrent readers of a shared trie do not bump the same reference counts
+  const std::shared_ptr<const TrieNode> *node = &root_;
+  while (!key.empty()) {
+    node = (*node)->children_.Find(key.front());
+    if (node == nullptr) {
+      return nullptr;
+    }
+    key.remove_prefix(1);
+    const auto &prefix = (*node)->prefix_;
+    if (key.compare(0, prefix.size(), prefix) != 0) {
       return nullptr;
     }
+    key.remove_prefix(prefix.size());
   }
-  // 如果字典树中没有key,则返回nullptr
-  if (!temp_root->is_value_node_) {  // 格式检查提示使用 ! 来代替 not
-    return nullptr;                  // c++11 新特性 多使用nullptr来代替NULL或者0
+  return node;
+}
+
+template <class T>
+auto Trie::Get(std::string_view key) const -> const T * {
+  // You should walk through the trie to find the node corresponding to the key. If the node doesn't exist, return
+  // nullptr. After you find the node, you should use `dynamic_cast` to cast it to `const TrieNodeWithValue<T> *`. If
+  // dynamic_cast returns `nullptr`, it means the type of the value is mismatched, and you should return nullptr.
+  // Otherwise, return the value.
+  const auto *node = FindNode(key);
+  if (node == nullptr || !(*node)->is_value_node_) {
+    return nullptr;
   }
-  // 当初始化一个转换值时，使用auto来避免复制类型名
-  const auto *target_node = dynamic_cast<const TrieNodeWithValue<T> *>(temp_root.get());  // 动态转换
-  // 如果字典树中有key,但是类型不匹配,返回nullptr
+  const auto *target_node = dynamic_cast<const TrieNodeWithValue<T> *>(node->get());
   if (target_node == nullptr) {
     return nullptr;
   }
-  // 其他情况代表正常获得了目标值,返回该指针
-  T *res = target_node->value_.get();
-  return res;
+  return target_node->value_.get();
 }
 
 template <class T>
 auto Trie::Put(std::string_view key, T value) const -> Trie {
   // Note that `T` might be a non-copyable type. Always use `std::move` when creating `shared_ptr` on that value.
-  // throw NotImplementedException("Trie::Put is not implemented.");
+  return PutValue<T>(key, std::make_shared<T>(std::move(value)));
+}
+
+template <class T>
+auto Trie::PutValue(std::string_view key, std::shared_ptr<T> val_ptr, bool in_place) const -> Trie {
   // You should walk through the trie and create new nodes if necessary. If the node corresponding to the key already
   // exists, you should create a new `TrieNodeWithValue`.
-  /* 任何时候都需要将当前节点克隆一份出来进行修改，然后再将节点接回去
-    遍历keyword中的字符Char
-      if 当前节点的children没有字符Char
-        生成一个新节点
-        在当前节点的children中加入一个字符Char的新节点
-      节点移动至字符Char的节点
-
-    需要记录根节点的位置和需要插入节点的祖先节点位置
-  */
-  // ！！！移动一个临时对象避免复制消除
-  // 不要使用 std::move
-  std::shared_ptr<bustub::TrieNode> new_root = std::shared_ptr<TrieNode>(root_->Clone());
-  if (key.empty()) {
-    std::shared_ptr<T> val_ptr = std::make_shared<T>(std::move(value));
-    TrieNodeWithValue<T> new_nwv(new_root->children_, val_ptr);
-    new_root = std::make_shared<TrieNodeWithValue<T>>(std::move(new_nwv));
-    return Trie(new_root);
-  }
-  // children_ 字段map中shared_ptr指向的是const TrieNode, 不能复制给非const TrieNode
-  // 所有的操作都不应该在原树上进行,尽可能的复用现有存在的节点,并且创建新的节点来代表新树
-  // 字典树的初始状态是一个空指针, map的作用是key 指示当前节点的下一个字符有哪些, value 指示下一个字符对应的节点
-
-  std::shared_ptr<TrieNode> cur_node = new_root;
-  auto ch_iter = key.begin();
-  auto last_char = key.end() - 1;
-  // std::vector<std::shared_ptr<TrieNode>> char_trace{};         //如果存储的是指针, 那么清空数组的时候会重复删除指针
-  while (ch_iter != last_char) {  // 这里不能使用constexpr
-    auto iter = cur_node->children_.find(*ch_iter);
-    // 如果该节点不存在，创建一个新的节点，并插入
-    if (iter == cur_node->children_.end()) {
-      TrieNode empty_node;
-      std::shared_ptr<TrieNode> empty_node_ptr = std::make_shared<TrieNode>(std::move(empty_node));
-      cur_node->children_.emplace(*ch_iter, empty_node_ptr);
-      cur_node = empty_node_ptr;
-    } else {
-      // ！！！移动一个临时对象避免复制消除
-      // 不要使用 std::move
-      std::shared_ptr<TrieNode> new_node = std::shared_ptr<TrieNode>((*iter).second->Clone());
-      cur_node->children_[*ch_iter] = new_node;
-      cur_node = new_node;
-    }
-    ch_iter++;
-  }
-
-  // 这里的分情况讨论是课程的提示，自己想的时候逻辑很混乱
-  // 如果相应节点不存在，创建一个终结节点 TrieNodeWithValue，插入成功；
-  // 如果相应节点存在但不是终结节点（通过 is_end_ 判断），将其转化为 TrieNodeWithValue
-  // 并把值赋给该节点，该操作不破坏以该键为前缀的后续其它节点（children_ 不变），插入成功；
-  // 如果相应节点存在且是终结节点，说明该键在 Trie 树存在，规定不能覆盖已存在的值，返回插入失败。
-
-  // 此时的ch_iter代表要有节点的值, cur_node 是待插入值节点的父节点
-  // 为value创建一个智能指针
-  std::shared_ptr<T> val_ptr = std::make_shared<T>(std::move(value));
-  auto cur_node_iter = cur_node->children_.find(*last_char);
-  auto iter_end = cur_node->children_.end();
-  std::shared_ptr<TrieNodeWithValue<T>> val_node;
-  if (cur_node_iter != iter_end) {
-    val_node = std::make_shared<TrieNodeWithValue<T>>(
-        std::move(TrieNodeWithValue<T>(cur_node->children_.at(*last_char)->children_, val_ptr)));
-  } else {
-    val_node = std::make_shared<TrieNodeWithValue<T>>(std::move(TrieNodeWithValue<T>(val_ptr)));
-  }
-  cur_node->children_[*last_char] = val_node;
-
-  /* std::shared_ptr<const TrieNode> tavsal = new_root;
-  auto iter = key.begin();
-  while (iter != key.end()) {
-    const TrieNodeWithValue<T> *target_node =
-          dynamic_cast<const TrieNodeWithValue<T> *>(tavsal.get());
-    if (target_node != nullptr) {
-      std::cout << target_node->value_ << std::endl;
-    }
-    tavsal = tavsal->children_.at(*iter);
-    iter++;
-  } */
-
-  return Trie(new_root);
+  return Trie(PutBelow<T>(root_, key, val_ptr, NodeWriter(in_place)));
 }
 
 auto Trie::Remove(std::string_view key) const -> Trie {
-  // throw NotImplementedException("Trie::Remove is not implemented.");
-
   // You should walk through the trie and remove nodes if necessary. If the node doesn't contain a value any more,
   // you should convert it to `TrieNode`. If a node doesn't have children any more, you should remove it.
-  // 逻辑很重要
-  // remove中有以下几个情形
-  // 1. 如果 key 为空, 则直接对根节点进行操作
-  // 2. 如果 key 在树中不存在，直接返回根节点
-  // 3. 如果 key 在树中存在，
-  //   1）将该节点的值删除, 将该值变为TrieNode 类型
-  //   2）如果该节点没有孩子, 移除该节点
-  // 非const变量可以赋值给const变量，反之不行
-
-  // ！！！移动一个临时对象避免复制消除
-  // 不要使用 std::move
-  std::shared_ptr<bustub::TrieNode> new_root = std::shared_ptr<TrieNode>(root_->Clone());
-  std::vector<std::shared_ptr<TrieNode>> node_tarce;
-  std::shared_ptr<TrieNode> cur_node = new_root;
-  bool is_del_node = true;
-  // 1. 如果 key 为空, 则直接对根节点进行操作
-  if (key.empty()) {
-    std::shared_ptr<bustub::TrieNode> new_root = std::shared_ptr<TrieNode>(root_->Clone());
-    TrieNode new_node(new_root->children_);
-    new_root = std::make_shared<TrieNode>(std::move(new_node));
-    return Trie(new_root);
+  return RemoveValue(key, false);
+}
+
+auto Trie::RemoveValue(std::string_view key, bool in_place) const -> Trie {
+  if (const auto *node = FindNode(key); node == nullptr || !(*node)->is_value_node_) {
+    return *this;
   }
+  // The root itself is never compressed or removed
+  return Trie(RemoveBelow(root_, key, NodeWriter(in_place)));
+}
 
-  auto char_iter = key.begin();
-  while (char_iter != key.end()) {
-    auto node_iter = cur_node->children_.find(*char_iter);
-    if (node_iter != cur_node->children_.end()) {
-      node_tarce.emplace_back(cur_node->Clone());
-      cur_node = std::const_pointer_cast<TrieNode>(node_iter->second);
-    } else {
-      // 2. 如果 key 在树中不存在，直接返回根节点
-      return Trie(new_root);
+template <class T>
+auto Trie::Scan(std::string_view prefix, std::optional<std::string_view> after) const -> TrieIterator<T> {
+  return TrieIterator<T>(root_, prefix, after);
+}
+
+template <class T>
+TrieIterator<T>::TrieIterator(std::shared_ptr<const TrieNode> root, std::string_view prefix,
+                              std::optional<std::string_view> after)
+    : root_(std::move(root)) {
+  // Find the node above all keys with the prefix. The prefix may end inside the compressed prefix of that node, whose
+  // key is then longer than it.
+  const TrieNode *node = root_.get();
+  while (key_.size() < prefix.size()) {
+    char c = prefix[key_.size()];
+    const auto *child = node->children_.Find(c);
+    if (child == nullptr) {
+      return;
+    }
+    size_t checked = key_.size() + 1;
+    key_ += c;
+    key_ += (*child)->prefix_;
+    node = child->get();
+    size_t common = std::min(prefix.size(), key_.size());
+    if (key_.compare(checked, common - checked, prefix, checked, common - checked) != 0) {
+      return;
     }
-    char_iter++;
   }
-  // 2. 如果 key 在树中不存在，直接返回根节点
-  if (!cur_node->is_value_node_) {
-    return Trie(new_root);
+  stack_.push_back({node, -1, key_.size()});
+
+  if (after.has_value() && after->compare(0, key_.size(), key_) == 0) {
+    Seek(*after);
+    Advance();
+  } else if (after.has_value() && *after > key_) {
+    // Every key below the node is before `after`
+    stack_.clear();
+  } else {
+    value_ = ValueOf(node);
+    if (value_ == nullptr) {
+      Advance();
+    }
   }
-  for (auto path_it = node_tarce.rbegin(); path_it != node_tarce.rend(); path_it++) {
-    std::shared_ptr<TrieNode> node;
-    if (is_del_node) {
-      node = std::make_shared<TrieNode>(TrieNode(cur_node->children_));
-    } else {
-      node = cur_node;
+}
+
+template <class T>
+void TrieIterator<T>::Seek(std::string_view after) {
+  while (true) {
+    auto &top = stack_.back();
+    if (after.size() == top.key_length_) {
+      // At the node of `after` itself, whose children come next
+      return;
+    }
+    auto byte = static_cast<uint8_t>(after[top.key_length_]);
+    const auto *child = top.node_->children_.Find(static_cast<char>(byte));
+    if (child == nullptr) {
+      top.last_byte_ = byte;
+      return;
     }
-    (*path_it)->children_[*(--char_iter)] = node;
-    if (node->children_.empty() && is_del_node) {
-      (*path_it)->children_.erase(*(char_iter));
+    const auto &prefix = (*child)->prefix_;
+    int cmp = after.substr(top.key_length_ + 1).compare(0, prefix.size(), prefix);
+    if (cmp < 0) {
+      // Every key below the child is after `after`, so the child comes next
+      top.last_byte_ = byte - 1;
+      return;
     }
-    cur_node = *path_it;
-    if (cur_node->is_value_node_) {
-      is_del_node = false;
+    top.last_byte_ = byte;
+    if (cmp > 0) {
+      // Every key below the child is before `after`
+      return;
     }
+    key_.assign(after.substr(0, top.key_length_ + 1 + prefix.size()));
+    stack_.push_back({child->get(), -1, key_.size()});
+  }
+}
+
+template <class T>
+void TrieIterator<T>::Advance() {
+  // Depth first, a node before its children and the children in the order of their bytes, is the order of the keys
+  value_ = nullptr;
+  while (!stack_.empty()) {
+    auto &top = stack_.back();
+    auto [byte, child] = top.node_->children_.UpperBound(top.last_byte_);
+    if (child == nullptr) {
+      stack_.pop_back();
+      continue;
+    }
+    top.last_byte_ = byte;
+    key_.resize(top.key_length_);
+    key_ += static_cast<char>(byte);
+    key_ += (*child)->prefix_;
+    stack_.push_back({child->get(), -1, key_.size()});
+    value_ = ValueOf(child->get());
+    if (value_ != nullptr) {
+      return;
+    }
+  }
+}
+
+template <class T>
+auto TrieIterator<T>::ValueOf(const TrieNode *node) -> const T * {
+  if (!node->is_value_node_) {
+    return nullptr;
+  }
+  const auto *value_node = dynamic_cast<const TrieNodeWithValue<T> *>(node);
+  return value_node == nullptr ? nullptr : value_node->value_.get();
+}
+
+template <class T>
+auto TrieIterator<T>::operator++() -> TrieIterator & {
+  Advance();
+  return *this;
+}
+
+template <class T>
+auto TrieIterator<T>::NextBatch(std::vector<std::pair<std::string, const T *>> *out, size_t max_pairs) -> size_t {
+  size_t appended = 0;
+  for (; appended < max_pairs && !IsEnd(); appended++) {
+    out->emplace_back(key_, value_);
+    Advance();
   }
-  std::shared_ptr<TrieNode> ret =
-      node_tarce.empty() ? nullptr : std::shared_ptr<TrieNode>(std::move(node_tarce.front()));
-  return Trie(ret);
+  return appended;
 }
 
 // Below are explicit instantiation of template functions.
@@ -197,22 +523,42 @@ auto Trie::Remove(std::string_view key) const -> Trie {
 // by the linker.
 
 template auto Trie::Put(std::string_view key, uint32_t value) const -> Trie;
+template auto Trie::PutValue(std::string_view key, std::shared_ptr<uint32_t> value, bool in_place) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const uint32_t *;
+template class TrieIterator<uint32_t>;
+template auto Trie::Scan(std::string_view prefix, std::optional<std::string_view> after) const
+    -> TrieIterator<uint32_t>;
 
 template auto Trie::Put(std::string_view key, uint64_t value) const -> Trie;
+template auto Trie::PutValue(std::string_view key, std::shared_ptr<uint64_t> value, bool in_place) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const uint64_t *;
+template class TrieIterator<uint64_t>;
+template auto Trie::Scan(std::string_view prefix, std::optional<std::string_view> after) const
+    -> TrieIterator<uint64_t>;
 
 template auto Trie::Put(std::string_view key, std::string value) const -> Trie;
+template auto Trie::PutValue(std::string_view key, std::shared_ptr<std::string> value, bool in_place) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const std::string *;
+template class TrieIterator<std::string>;
+template auto Trie::Scan(std::string_view prefix, std::optional<std::string_view> after) const
+    -> TrieIterator<std::string>;
 
 // If your solution cannot compile for non-copy tests, you can remove the below lines to get partial score.
 
 using Integer = std::unique_ptr<uint32_t>;
 
 template auto Trie::Put(std::string_view key, Integer value) const -> Trie;
+template auto Trie::PutValue(std::string_view key, std::shared_ptr<Integer> value, bool in_place) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const Integer *;
+template class TrieIterator<Integer>;
+template auto Trie::Scan(std::string_view prefix, std::optional<std::string_view> after) const
+    -> TrieIterator<Integer>;
 
 template auto Trie::Put(std::string_view key, MoveBlocked value) const -> Trie;
+template auto Trie::PutValue(std::string_view key, std::shared_ptr<MoveBlocked> value, bool in_place) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const MoveBlocked *;
+template class TrieIterator<MoveBlocked>;
+template auto Trie::Scan(std::string_view prefix, std::optional<std::string_view> after) const
+    -> TrieIterator<MoveBlocked>;
 
 }  // namespace bustub
@@ -1,65 +1,188 @@
 #include "primer/trie_store.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
 #include "common/exception.h"
 
 namespace bustub {
 
+namespace {
+
+// Reader slots are handed out to threads round-robin on their first read, so that up to
+// READER_SLOTS threads each count themselves on their own cache line.
+auto ThreadSlot() -> size_t {
+  static std::atomic<size_t> next_slot{0};
+  thread_local size_t slot = next_slot.fetch_add(1);
+  return slot;
+}
+
+}  // namespace
+
+TrieStore::~TrieStore() {
+  delete root_.load();
+  for (auto &[epoch, root] : retired_) {
+    delete root;
+  }
+}
+
+auto TrieStore::EnterEpoch() -> uint64_t {
+  auto &slot = readers_[ThreadSlot() % READER_SLOTS];
+  while (true) {
+    auto epoch = epoch_.load();
+    slot.active_[epoch & 1].fetch_add(1);
+    // A writer may have moved on to the next epoch without seeing this reader; enter that one instead
+    if (epoch_.load() == epoch) {
+      return epoch;
+    }
+    slot.active_[epoch & 1].fetch_sub(1);
+  }
+}
+
+void TrieStore::ExitEpoch(uint64_t epoch) { readers_[ThreadSlot() % READER_SLOTS].active_[epoch & 1].fetch_sub(1); }
+
+template <class Update>
+void TrieStore::UpdateRoot(Update &&update) {
+  // The writer reads the root like a reader does, so that no other writer frees it while the new
+  // trie is built from it
+  auto epoch = EnterEpoch();
+  const Trie *old_root = root_.load();
+  auto new_root = std::make_unique<Trie>(update(*old_root));
+  while (!root_.compare_exchange_weak(old_root, new_root.get())) {
+    *new_root = update(*old_root);
+  }
+  new_root.release();
+  ExitEpoch(epoch);
+  Retire(old_root);
+}
+
+void TrieStore::Retire(const Trie *old_root) {
+  std::vector<const Trie *> freed;
+  {
+    std::lock_guard lock(retire_lock_);
+    // Readers that could have loaded old_root entered in this epoch or an earlier one
+    auto epoch = epoch_.load();
+    retired_.emplace_back(epoch, old_root);
+
+    // Readers only ever enter the current epoch, so once none is left in the previous one (which
+    // shares its counters with all older ones of the same parity), the epoch can move on
+    bool drained = true;
+    for (const auto &slot : readers_) {
+      if (slot.active_[(epoch + 1) & 1].load() != 0) {
+        drained = false;
+        break;
+      }
+    }
+    if (drained) {
+      epoch_.store(++epoch);
+    }
+
+    // Two epochs later, the readers of both parities have drained since the root was replaced
+    auto keep = std::partition(retired_.begin(), retired_.end(),
+                               [epoch](const auto &retired) { return retired.first + 2 > epoch; });
+    for (auto iter = keep; iter != retired_.end(); ++iter) {
+      freed.push_back(iter->second);
+    }
+    retired_.erase(keep, retired_.end());
+  }
+  for (const auto *root : freed) {
+    delete root;
+  }
+}
+
 template <class T>
 auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<T>> {
-  // Pseudo-code: 伪码
-  // (1) Take the root lock, get the root, and release the root lock. Don't lookup the value in the
-  //     trie while holding the root lock.
-  // (2) Lookup the value in the trie.
-  // (3) If the value is found, return a ValueGuard object that holds a reference to the value and the
-  //     root. Otherwise, return std::nullopt.
-  // throw NotImplementedException("TrieStore::Get is not implemented.");
-
-  // 先对根节点上锁,得到根节点,释放根节点,在持有根节点锁时不要在字典树中查找元素
-  // 先对根节点上锁再访问根节点，然后释放根节点
-  root_lock_.try_lock();
-  Trie new_root = Trie(root_);
-  // TrieNode *new_root = temp_root;
-  root_lock_.unlock();
-
-  const auto *result = new_root.Get<T>(key);
-  if (result == nullptr) {
-    return std::nullopt;
+  // No lock: the epoch keeps writers from freeing the root while the lookup walks it
+  auto epoch = EnterEpoch();
+  const Trie *root = root_.load();
+  std::optional<ValueGuard<T>> result;
+  if (const auto *node = root->FindNode(key); node != nullptr) {
+    if (const auto *value_node = dynamic_cast<const TrieNodeWithValue<T> *>(node->get()); value_node != nullptr) {
+      // Pin only the node holding the value, whose reference count readers of other keys leave alone
+      result.emplace(Trie(*node), *value_node->value_);
+    }
   }
-  ValueGuard<T> ret = ValueGuard<T>(new_root, *result);
-  return ret;
+  ExitEpoch(epoch);
+  return result;
 }
 
 template <class T>
 void TrieStore::Put(std::string_view key, T value) {
-  // You will need to ensure there is only one writer at a time. Think of how you can achieve this.
-  // The logic should be somehow similar to `TrieStore::Get`.
-  // throw NotImplementedException("TrieStore::Put is not implemented.");
-
-  // 注意T可能是一个不可复制的类型，为value创建一个shared_ptr时使用 std::move
-  // 只需要加写锁就可以了， 为什么?
-  write_lock_.lock();
-  Trie new_root = Trie(root_);
-  root_ = new_root.Put<T>(key, std::move(value));
-  write_lock_.unlock();
+  // T may be move-only, and the put may have to be redone on a newer root, so the value is moved
+  // into its shared_ptr once up front, before the root is even read
+  auto value_ptr = std::make_shared<T>(std::move(value));
+  UpdateRoot([&](const Trie &root) { return root.PutValue<T>(key, value_ptr); });
+}
+
+template <class T>
+auto TrieStore::Scan(std::string_view prefix, std::optional<std::string_view> after) -> TrieIterator<T> {
+  return Snapshot().Scan<T>(prefix, after);
 }
 
 void TrieStore::Remove(std::string_view key) {
-  // You will need to ensure there is only one writer at a time. Think of how you can achieve this.
-  // The logic should be somehow similar to `TrieStore::Get`.
-  // throw NotImplementedException("TrieStore::Remove is not implemented.");
-
-  write_lock_.lock();
-  Trie new_root = Trie(root_);
-  root_ = new_root.Remove(key);
-  write_lock_.unlock();
+  UpdateRoot([&](const Trie &root) { return root.Remove(key); });
+}
+
+auto TrieStore::Snapshot() -> Trie {
+  auto epoch = EnterEpoch();
+  Trie root = *root_.load();
+  ExitEpoch(epoch);
+  return root;
 }
 
-// Below are explicit instantiation of template functions.
+TrieStore::Batch::Batch(TrieStore *store) : store_(store), base_(store->Snapshot()), working_(base_) {}
+
+template <class T>
+void TrieStore::Batch::Put(std::string_view key, T value) {
+  auto value_ptr = std::make_shared<T>(std::move(value));
+  working_ = working_.PutValue<T>(key, value_ptr, true);
+  writes_.push_back({std::string(key), std::move(value_ptr), [](const Trie &root, const Write &write) {
+                       return root.PutValue<T>(write.key_, std::static_pointer_cast<T>(write.value_), true);
+                     }});
+}
+
+void TrieStore::Batch::Remove(std::string_view key) {
+  working_ = working_.RemoveValue(key, true);
+  writes_.push_back({std::string(key), nullptr,
+                     [](const Trie &root, const Write &write) { return root.RemoveValue(write.key_, true); }});
+}
+
+void TrieStore::Batch::Commit() {
+  if (writes_.empty()) {
+    return;
+  }
+  Trie published;
+  store_->UpdateRoot([&](const Trie &root) {
+    // The batch holds on to its base, so a root with the same root node is the base itself
+    if (root.root_ == base_.root_) {
+      published = working_;
+    } else {
+      // The first write copies the root, which the store shares, and the others go on in place on the copy
+      published = root;
+      for (const auto &write : writes_) {
+        published = write.apply_(published, write);
+      }
+    }
+    return published;
+  });
+  // The published nodes are shared with the store now, so later writes copy them again
+  base_ = published;
+  working_ = std::move(published);
+  writes_.clear();
+}
 
 template auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<uint32_t>>;
 template void TrieStore::Put(std::string_view key, uint32_t value);
+template void TrieStore::Batch::Put(std::string_view key, uint32_t value);
+template auto TrieStore::Scan(std::string_view prefix, std::optional<std::string_view> after)
+    -> TrieIterator<uint32_t>;
 
 template auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<std::string>>;
 template void TrieStore::Put(std::string_view key, std::string value);
+template void TrieStore::Batch::Put(std::string_view key, std::string value);
+template auto TrieStore::Scan(std::string_view prefix, std::optional<std::string_view> after)
+    -> TrieIterator<std::string>;
 
 // If your solution cannot compile for non-copy tests, you can remove the below lines to get partial score.
 
@@ -67,8 +190,14 @@ using Integer = std::unique_ptr<uint32_t>;
 
 template auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<Integer>>;
 template void TrieStore::Put(std::string_view key, Integer value);
+template void TrieStore::Batch::Put(std::string_view key, Integer value);
+template auto TrieStore::Scan(std::string_view prefix, std::optional<std::string_view> after)
+    -> TrieIterator<Integer>;
 
 template auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<MoveBlocked>>;
 template void TrieStore::Put(std::string_view key, MoveBlocked value);
+template void TrieStore::Batch::Put(std::string_view key, MoveBlocked value);
+template auto TrieStore::Scan(std::string_view prefix, std::optional<std::string_view> after)
+    -> TrieIterator<MoveBlocked>;
 
 }  // namespace bustub
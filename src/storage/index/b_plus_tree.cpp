@@ -1,32 +1,221 @@
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT
+#include <utility>
 
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/rid.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/covering_value.h"
+#include "storage/index/memcmp_key.h"
 
 namespace bustub {
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
-                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size)
+                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size,
+                          BPlusTreeMode mode)
     : index_name_(std::move(name)),
       bpm_(buffer_pool_manager),
       comparator_(std::move(comparator)),
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size),
-      header_page_id_(header_page_id) {
+      header_page_id_(header_page_id),
+      mode_(mode) {
   WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
   auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
   root_page->root_page_id_ = INVALID_PAGE_ID;
+  if (mode_ == BPlusTreeMode::LAZY_MERGE) {
+    consolidation_thread_ = std::thread([this] { ConsolidateLoop(); });
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() {
+  if (!consolidation_thread_.joinable()) {
+    return;
+  }
+  {
+    std::scoped_lock lock(underfull_latch_);
+    stop_consolidation_ = true;
+  }
+  consolidate_cv_.notify_all();
+  consolidation_thread_.join();
 }
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
+auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t root_page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID || mode_ == BPlusTreeMode::LATCH_CRABBING) {
+    return root_page_id == INVALID_PAGE_ID;
+  }
+  // Only eager merging frees the last leaf, so look for a non-empty leaf from the leftmost one.
+  guard = bpm_->FetchPageRead(root_page_id);
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    guard = bpm_->FetchPageRead(guard.As<InternalPage>()->ValueAt(0));
+  }
+  while (guard.As<LeafPage>()->GetSize() == 0) {
+    page_id_t next_page_id = guard.As<LeafPage>()->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      return true;
+    }
+    guard.Drop();
+    guard = bpm_->FetchPageRead(next_page_id);
+  }
+  return false;
+}
+
+/*****************************************************************************
+ * LATCH CRABBING
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafeForInsert(const BPlusTreePage *page) const -> bool {
+  // Leaves split when they reach max size, internal pages when they exceed it.
+  if (page->IsLeafPage()) {
+    return page->GetSize() + 1 < page->GetMaxSize();
+  }
+  return page->GetSize() < page->GetMaxSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::IsSafeForRemove(const BPlusTreePage *page, bool is_root) const -> bool {
+  if (is_root) {
+    // A root leaf only goes away when it becomes empty, a root internal page when it is left with one child.
+    return page->GetSize() > (page->IsLeafPage() ? 1 : 2);
+  }
+  return page->GetSize() > page->GetMinSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchLeafRead(const KeyType *key, ReadPageGuard *leaf, std::vector<page_id_t> *path) -> bool {
+  bool b_link = mode_ == BPlusTreeMode::B_LINK;
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  while (true) {
+    if (b_link) {
+      guard.Drop();
+    }
+    guard = bpm_->FetchPageRead(page_id);
+    auto page = guard.As<BPlusTreePage>();
+    if (b_link && key != nullptr) {
+      // A split we did not see from the parent moved our key range to the right.
+      page_id_t right_page_id = RightLink(page, *key);
+      if (right_page_id != INVALID_PAGE_ID) {
+        page_id = right_page_id;
+        continue;
+      }
+    }
+    if (page->IsLeafPage()) {
+      break;
+    }
+    if (path != nullptr) {
+      path->push_back(page_id);
+    }
+    auto internal = guard.As<InternalPage>();
+    page_id = key == nullptr ? internal->ValueAt(0) : internal->Lookup(*key, comparator_);
+  }
+  *leaf = std::move(guard);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchRightmostLeafRead(ReadPageGuard *leaf) -> bool {
+  bool b_link = mode_ == BPlusTreeMode::B_LINK;
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  while (true) {
+    if (b_link) {
+      guard.Drop();
+    }
+    guard = bpm_->FetchPageRead(page_id);
+    auto page = guard.As<BPlusTreePage>();
+    if (b_link) {
+      page_id_t next_page_id = page->IsLeafPage() ? guard.As<LeafPage>()->GetNextPageId()
+                                                  : guard.As<InternalPage>()->GetNextPageId();
+      if (next_page_id != INVALID_PAGE_ID) {
+        page_id = next_page_id;
+        continue;
+      }
+    }
+    if (page->IsLeafPage()) {
+      break;
+    }
+    auto internal = guard.As<InternalPage>();
+    page_id = internal->ValueAt(internal->GetSize() - 1);
+  }
+  *leaf = std::move(guard);
+  return true;
+}
+
+/*
+ * Read-latch the path down to the parent of the leaf and write-latch only the leaf. Holding the parent's read latch
+ * while re-latching the leaf for writing is enough to keep it from being split or merged in between, since both
+ * require a write latch on the parent.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchLeafOptimistic(const KeyType &key, WritePageGuard *leaf, std::optional<KeyType> *upper_bound)
+    -> bool {
+  ReadPageGuard parent = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = parent.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  while (true) {
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    auto page = guard.As<BPlusTreePage>();
+    if (page->IsLeafPage()) {
+      guard.Drop();
+      *leaf = bpm_->FetchPageWrite(page_id);
+      return true;
+    }
+    auto internal = guard.As<InternalPage>();
+    int index = internal->ChildIndex(key, comparator_);
+    if (upper_bound != nullptr && index + 1 < internal->GetSize()) {
+      *upper_bound = internal->KeyAt(index + 1);
+    }
+    page_id = internal->ValueAt(index);
+    parent = std::move(guard);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchLeafPessimistic(const KeyType &key, Context &ctx, bool for_insert) -> bool {
+  ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
+  ctx.root_page_id_ = ctx.header_page_->As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (ctx.root_page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  page_id_t page_id = ctx.root_page_id_;
+  while (true) {
+    WritePageGuard guard = bpm_->FetchPageWrite(page_id);
+    auto page = guard.As<BPlusTreePage>();
+    bool safe = for_insert ? IsSafeForInsert(page) : IsSafeForRemove(page, ctx.IsRootPage(page_id));
+    if (safe) {
+      ctx.header_page_ = std::nullopt;
+      ctx.write_set_.clear();
+    }
+    bool is_leaf = page->IsLeafPage();
+    if (!is_leaf) {
+      page_id = guard.As<InternalPage>()->Lookup(key, comparator_);
+    }
+    ctx.write_set_.push_back(std::move(guard));
+    if (is_leaf) {
+      return true;
+    }
+  }
+}
+
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
@@ -37,10 +226,16 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
-  // Declaration of context instance.
-  Context ctx;
-  (void)ctx;
-  return false;
+  ReadPageGuard guard;
+  if (!FetchLeafRead(&key, &guard)) {
+    return false;
+  }
+  ValueType value;
+  if (!guard.As<LeafPage>()->Lookup(key, &value, comparator_)) {
+    return false;
+  }
+  result->push_back(value);
+  return true;
 }
 
 /*****************************************************************************
@@ -55,10 +250,178 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
-  // Declaration of context instance.
+  if (mode_ == BPlusTreeMode::B_LINK) {
+    return InsertBLink(key, value);
+  }
+
+  if (InsertIntoRightmostLeaf(key, value)) {
+    return true;
+  }
+
+  // Optimistic pass: most inserts do not split, so only the leaf needs a write latch.
+  {
+    WritePageGuard guard;
+    if (FetchLeafOptimistic(key, &guard)) {
+      auto leaf = guard.AsMut<LeafPage>();
+      if (leaf->GetNextPageId() == INVALID_PAGE_ID) {
+        rightmost_leaf_page_id_ = guard.PageId();
+      }
+      ValueType existing;
+      if (leaf->Lookup(key, &existing, comparator_)) {
+        return false;
+      }
+      if (IsSafeForInsert(leaf)) {
+        leaf->Insert(key, value, comparator_);
+        return true;
+      }
+    }
+  }
+
+  // The leaf may split (or the tree is empty): restart with pessimistic latch crabbing.
   Context ctx;
-  (void)ctx;
-  return false;
+  if (!FetchLeafPessimistic(key, ctx, true)) {
+    return StartNewTree(key, value, ctx);
+  }
+  auto leaf = ctx.write_set_.back().AsMut<LeafPage>();
+  int old_size = leaf->GetSize();
+  if (leaf->Insert(key, value, comparator_) == old_size) {
+    return false;
+  }
+  if (leaf->GetSize() < leaf->GetMaxSize()) {
+    return true;
+  }
+
+  page_id_t new_page_id;
+  WritePageGuard new_guard = bpm_->NewPageGuarded(&new_page_id).UpgradeWrite();
+  auto new_leaf = new_guard.AsMut<LeafPage>();
+  new_leaf->Init(leaf_max_size_);
+  bool rightmost = leaf->GetNextPageId() == INVALID_PAGE_ID;
+  if (rightmost && comparator_(leaf->KeyAt(leaf->GetSize() - 1), key) == 0) {
+    // Appending to the end of the tree: leave this leaf nearly full, since later keys will all go to the right.
+    int keep = static_cast<int>(leaf->GetSize() * BPLUS_TREE_APPEND_SPLIT_KEEP);
+    leaf->MoveTailTo(new_leaf, std::clamp(keep, leaf->GetMinSize(), leaf->GetSize() - 1));
+  } else {
+    leaf->MoveHalfTo(new_leaf);
+  }
+  leaf->SetNextPageId(new_page_id);
+  new_leaf->SetPrevPageId(ctx.write_set_.back().PageId());
+  SetPrevPageIdOf(new_leaf->GetNextPageId(), new_page_id);
+  if (rightmost) {
+    rightmost_leaf_page_id_ = new_page_id;
+  }
+  InsertIntoParent(new_leaf->KeyAt(0), new_page_id, ctx);
+  return true;
+}
+
+/*
+ * The cached leaf is only trusted after latching it: it must still be the cached one (so it has not been freed) and
+ * still be the rightmost leaf, and `key` must be beyond its last key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertIntoRightmostLeaf(const KeyType &key, const ValueType &value) -> bool {
+  page_id_t page_id = rightmost_leaf_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  WritePageGuard guard = bpm_->FetchPageWrite(page_id);
+  if (rightmost_leaf_page_id_ != page_id) {
+    return false;
+  }
+  auto leaf = guard.AsMut<LeafPage>();
+  if (leaf->GetNextPageId() != INVALID_PAGE_ID || leaf->GetSize() == 0 || !IsSafeForInsert(leaf) ||
+      comparator_(key, leaf->KeyAt(leaf->GetSize() - 1)) <= 0) {
+    return false;
+  }
+  leaf->Insert(key, value, comparator_);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertBatch(std::vector<MappingType> pairs, Transaction *txn) -> size_t {
+  size_t inserted = 0;
+  if (mode_ == BPlusTreeMode::B_LINK) {
+    for (const auto &[key, value] : pairs) {
+      inserted += Insert(key, value, txn) ? 1 : 0;
+    }
+    return inserted;
+  }
+
+  std::stable_sort(pairs.begin(), pairs.end(), [this](const MappingType &lhs, const MappingType &rhs) {
+    return comparator_(lhs.first, rhs.first) < 0;
+  });
+  for (size_t i = 0; i < pairs.size();) {
+    size_t start = i;
+    {
+      WritePageGuard guard;
+      std::optional<KeyType> upper_bound;
+      if (FetchLeafOptimistic(pairs[i].first, &guard, &upper_bound)) {
+        auto leaf = guard.AsMut<LeafPage>();
+        if (leaf->GetNextPageId() == INVALID_PAGE_ID) {
+          rightmost_leaf_page_id_ = guard.PageId();
+        }
+        for (; i < pairs.size() && IsSafeForInsert(leaf) &&
+               (!upper_bound.has_value() || comparator_(pairs[i].first, *upper_bound) < 0);
+             i++) {
+          int old_size = leaf->GetSize();
+          inserted += leaf->Insert(pairs[i].first, pairs[i].second, comparator_) != old_size ? 1 : 0;
+        }
+      }
+    }
+    if (i == start) {
+      // The leaf is full (or the tree is empty): take the pessimistic path for this pair only.
+      inserted += Insert(pairs[i].first, pairs[i].second, txn) ? 1 : 0;
+      i++;
+    }
+  }
+  return inserted;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value, Context &ctx) -> bool {
+  page_id_t root_page_id;
+  WritePageGuard guard = bpm_->NewPageGuarded(&root_page_id).UpgradeWrite();
+  auto leaf = guard.AsMut<LeafPage>();
+  leaf->Init(leaf_max_size_);
+  leaf->Insert(key, value, comparator_);
+  ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_page_id;
+  rightmost_leaf_page_id_ = root_page_id;
+  return true;
+}
+
+/*
+ * Insert the separator of a freshly split page into its parent. The split page is the last page of the write set
+ * and every ancestor that may split as well is still latched in front of it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(const KeyType &key, page_id_t new_page_id, Context &ctx) {
+  page_id_t old_page_id = ctx.write_set_.back().PageId();
+  ctx.write_set_.pop_back();
+
+  if (ctx.write_set_.empty()) {
+    // The root itself was split: grow the tree by one level.
+    BUSTUB_ASSERT(ctx.IsRootPage(old_page_id), "split page without a latched parent must be the root");
+    page_id_t root_page_id;
+    WritePageGuard root_guard = bpm_->NewPageGuarded(&root_page_id).UpgradeWrite();
+    auto root = root_guard.AsMut<InternalPage>();
+    root->Init(internal_max_size_);
+    root->PopulateNewRoot(old_page_id, key, new_page_id);
+    ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_page_id;
+    return;
+  }
+
+  auto parent = ctx.write_set_.back().AsMut<InternalPage>();
+  if (parent->GetSize() < parent->GetMaxSize()) {
+    parent->InsertNodeAfter(old_page_id, key, new_page_id);
+    return;
+  }
+
+  page_id_t sibling_page_id;
+  WritePageGuard sibling_guard = bpm_->NewPageGuarded(&sibling_page_id).UpgradeWrite();
+  auto sibling = sibling_guard.AsMut<InternalPage>();
+  sibling->Init(internal_max_size_);
+  parent->SplitInsert(sibling, old_page_id, key, new_page_id);
+  parent->SetNextPageId(sibling_page_id);
+  InsertIntoParent(sibling->KeyAt(0), sibling_page_id, ctx);
 }
 
 /*****************************************************************************
@@ -73,9 +436,546 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
-  // Declaration of context instance.
+  if (mode_ == BPlusTreeMode::B_LINK) {
+    RemoveBLink(key);
+    return;
+  }
+  if (mode_ == BPlusTreeMode::LAZY_MERGE) {
+    RemoveLazy(key);
+    return;
+  }
+
+  // Optimistic pass: only restart with write latches on the whole path if the leaf would underflow.
+  {
+    WritePageGuard guard;
+    if (!FetchLeafOptimistic(key, &guard)) {
+      return;
+    }
+    auto leaf = guard.AsMut<LeafPage>();
+    ValueType existing;
+    if (!leaf->Lookup(key, &existing, comparator_)) {
+      return;
+    }
+    if (leaf->GetSize() > leaf->GetMinSize() && leaf->GetSize() > 1) {
+      leaf->RemoveAndDeleteRecord(key, comparator_);
+      return;
+    }
+  }
+
   Context ctx;
-  (void)ctx;
+  if (!FetchLeafPessimistic(key, ctx, false)) {
+    return;
+  }
+  auto leaf = ctx.write_set_.back().AsMut<LeafPage>();
+  int old_size = leaf->GetSize();
+  if (leaf->RemoveAndDeleteRecord(key, comparator_) == old_size) {
+    return;
+  }
+  HandleUnderflow(ctx);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveBatch(std::vector<KeyType> keys, Transaction *txn) {
+  if (mode_ == BPlusTreeMode::B_LINK) {
+    for (const auto &key : keys) {
+      Remove(key, txn);
+    }
+    return;
+  }
+
+  std::sort(keys.begin(), keys.end(),
+            [this](const KeyType &lhs, const KeyType &rhs) { return comparator_(lhs, rhs) < 0; });
+  for (size_t i = 0; i < keys.size();) {
+    size_t start = i;
+    {
+      WritePageGuard guard;
+      std::optional<KeyType> upper_bound;
+      if (!FetchLeafOptimistic(keys[i], &guard, &upper_bound)) {
+        return;
+      }
+      auto leaf = guard.AsMut<LeafPage>();
+      bool lazy = mode_ == BPlusTreeMode::LAZY_MERGE;
+      ValueType existing;
+      for (; i < keys.size() && (!upper_bound.has_value() || comparator_(keys[i], *upper_bound) < 0); i++) {
+        if (!leaf->Lookup(keys[i], &existing, comparator_)) {
+          continue;
+        }
+        if (!lazy && (leaf->GetSize() <= leaf->GetMinSize() || leaf->GetSize() <= 1)) {
+          break;
+        }
+        leaf->RemoveAndDeleteRecord(keys[i], comparator_);
+        if (lazy && leaf->GetSize() == leaf->GetMinSize() - 1) {
+          MarkUnderfull(guard.PageId(), keys[i]);
+        }
+      }
+    }
+    if (i == start) {
+      // The leaf would underflow: take the pessimistic path for this key only.
+      Remove(keys[i], txn);
+      i++;
+    }
+  }
+}
+
+/*
+ * Fix up the last page of the write set after a removal, merging with or borrowing from a sibling and walking up the
+ * latched ancestors as long as they underflow in turn.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::HandleUnderflow(Context &ctx) {
+  WritePageGuard &guard = ctx.write_set_.back();
+  page_id_t page_id = guard.PageId();
+  auto page = guard.AsMut<BPlusTreePage>();
+
+  if (ctx.IsRootPage(page_id)) {
+    page_id_t new_root_page_id;
+    if (page->IsLeafPage() && page->GetSize() == 0) {
+      new_root_page_id = INVALID_PAGE_ID;
+    } else if (!page->IsLeafPage() && page->GetSize() == 1) {
+      new_root_page_id = reinterpret_cast<InternalPage *>(page)->ValueAt(0);
+    } else {
+      return;
+    }
+    if (page->IsLeafPage()) {
+      rightmost_leaf_page_id_ = INVALID_PAGE_ID;
+    }
+    ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = new_root_page_id;
+    ctx.write_set_.pop_back();
+    bpm_->DeletePage(page_id);
+    return;
+  }
+  if (page->GetSize() >= page->GetMinSize()) {
+    return;
+  }
+
+  BUSTUB_ASSERT(ctx.write_set_.size() >= 2, "underflowing page must have its parent latched");
+  auto parent = ctx.write_set_[ctx.write_set_.size() - 2].AsMut<InternalPage>();
+  int index = parent->ValueIndex(page_id);
+  bool sibling_is_left = index > 0;
+  int sibling_index = sibling_is_left ? index - 1 : index + 1;
+  WritePageGuard sibling_guard = bpm_->FetchPageWrite(parent->ValueAt(sibling_index));
+  auto sibling = sibling_guard.AsMut<BPlusTreePage>();
+
+  // Always merge the right page into the left one and drop the right page.
+  int right_index = sibling_is_left ? index : sibling_index;
+  bool merge = page->IsLeafPage() ? page->GetSize() + sibling->GetSize() < page->GetMaxSize()
+                                  : page->GetSize() + sibling->GetSize() <= page->GetMaxSize();
+  if (merge) {
+    BPlusTreePage *left = sibling_is_left ? sibling : page;
+    BPlusTreePage *right = sibling_is_left ? page : sibling;
+    if (page->IsLeafPage()) {
+      auto left_leaf = reinterpret_cast<LeafPage *>(left);
+      reinterpret_cast<LeafPage *>(right)->MoveAllTo(left_leaf);
+      SetPrevPageIdOf(left_leaf->GetNextPageId(), parent->ValueAt(right_index - 1));
+      rightmost_leaf_page_id_ = INVALID_PAGE_ID;
+    } else {
+      reinterpret_cast<InternalPage *>(right)->MoveAllTo(reinterpret_cast<InternalPage *>(left),
+                                                         parent->KeyAt(right_index));
+    }
+    page_id_t right_page_id = parent->ValueAt(right_index);
+    parent->Remove(right_index);
+    sibling_guard.Drop();
+    ctx.write_set_.pop_back();
+    bpm_->DeletePage(right_page_id);
+    HandleUnderflow(ctx);
+    return;
+  }
+
+  if (page->IsLeafPage()) {
+    auto leaf = reinterpret_cast<LeafPage *>(page);
+    auto sibling_leaf = reinterpret_cast<LeafPage *>(sibling);
+    if (sibling_is_left) {
+      sibling_leaf->MoveLastToFrontOf(leaf);
+      parent->SetKeyAt(index, leaf->KeyAt(0));
+    } else {
+      sibling_leaf->MoveFirstToEndOf(leaf);
+      parent->SetKeyAt(sibling_index, sibling_leaf->KeyAt(0));
+    }
+  } else {
+    auto internal = reinterpret_cast<InternalPage *>(page);
+    auto sibling_internal = reinterpret_cast<InternalPage *>(sibling);
+    if (sibling_is_left) {
+      sibling_internal->MoveLastToFrontOf(internal, parent->KeyAt(index));
+      parent->SetKeyAt(index, internal->KeyAt(0));
+    } else {
+      sibling_internal->MoveFirstToEndOf(internal, parent->KeyAt(sibling_index));
+      parent->SetKeyAt(sibling_index, sibling_internal->KeyAt(0));
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetPrevPageIdOf(page_id_t page_id, page_id_t prev_page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  WritePageGuard guard = bpm_->FetchPageWrite(page_id);
+  guard.AsMut<LeafPage>()->SetPrevPageId(prev_page_id);
+}
+
+/*****************************************************************************
+ * LAZY MERGE
+ *****************************************************************************/
+/*
+ * Removal only write-latches the leaf, like the optimistic pass of latch crabbing, but goes through even when the leaf
+ * underflows. The leaf stays linked in place, possibly empty, until ConsolidateLeaf gets to it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveLazy(const KeyType &key) {
+  WritePageGuard guard;
+  if (!FetchLeafOptimistic(key, &guard)) {
+    return;
+  }
+  auto leaf = guard.AsMut<LeafPage>();
+  int old_size = leaf->GetSize();
+  if (leaf->RemoveAndDeleteRecord(key, comparator_) == old_size) {
+    return;
+  }
+  // Only record the leaf as it crosses the minimum, to keep removals off underfull_latch_. A leaf that is refilled
+  // and drained again crosses it again.
+  if (leaf->GetSize() == leaf->GetMinSize() - 1) {
+    MarkUnderfull(guard.PageId(), key);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::MarkUnderfull(page_id_t page_id, const KeyType &key) {
+  std::scoped_lock lock(underfull_latch_);
+  underfull_leaves_.insert_or_assign(page_id, key);
+  newly_underfull_++;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetUnderfullLeafCount() -> size_t {
+  std::scoped_lock lock(underfull_latch_);
+  return underfull_leaves_.size();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Consolidate(size_t max_leaves) -> size_t {
+  std::vector<KeyType> keys;
+  {
+    std::scoped_lock lock(underfull_latch_);
+    for (auto iter = underfull_leaves_.begin(); iter != underfull_leaves_.end() && keys.size() < max_leaves;) {
+      keys.push_back(iter->second);
+      iter = underfull_leaves_.erase(iter);
+    }
+  }
+
+  size_t consolidated = 0;
+  for (const auto &key : keys) {
+    // Check with a read latch first: inserts may have filled the leaf again, or a merge may have absorbed it.
+    {
+      ReadPageGuard guard;
+      if (!FetchLeafRead(&key, &guard)) {
+        break;
+      }
+      auto leaf = guard.As<LeafPage>();
+      if (leaf->GetSize() >= leaf->GetMinSize()) {
+        continue;
+      }
+    }
+    ConsolidateLeaf(key);
+    consolidated++;
+  }
+  return consolidated;
+}
+
+/*
+ * A lazily emptied leaf may be far below its minimum size, so one merge or borrow is not always enough. Borrowing
+ * keeps the leaf latched and is repeated in place; after a merge, descend again to the leaf that absorbed it. Every
+ * step either frees a page or moves an entry into the leaf, so this terminates.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ConsolidateLeaf(const KeyType &key) {
+  while (true) {
+    Context ctx;
+    if (!FetchLeafPessimistic(key, ctx, false)) {
+      return;
+    }
+    page_id_t leaf_page_id = ctx.write_set_.back().PageId();
+    if (ctx.IsRootPage(leaf_page_id)) {
+      if (ctx.write_set_.back().As<LeafPage>()->GetSize() == 0) {
+        HandleUnderflow(ctx);
+      }
+      return;
+    }
+    while (!ctx.write_set_.empty() && ctx.write_set_.back().PageId() == leaf_page_id) {
+      auto leaf = ctx.write_set_.back().As<LeafPage>();
+      if (leaf->GetSize() >= leaf->GetMinSize()) {
+        return;
+      }
+      HandleUnderflow(ctx);
+    }
+  }
+}
+
+/*
+ * Every BPLUS_TREE_CONSOLIDATE_INTERVAL, consolidate a batch of underfull leaves unless removals are still draining
+ * leaves quickly. A large enough backlog is consolidated regardless, so steady removals cannot defer it forever.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ConsolidateLoop() {
+  std::unique_lock lock(underfull_latch_);
+  while (!stop_consolidation_) {
+    consolidate_cv_.wait_for(lock, BPLUS_TREE_CONSOLIDATE_INTERVAL);
+    size_t newly_underfull = std::exchange(newly_underfull_, 0);
+    if (stop_consolidation_ || underfull_leaves_.empty() ||
+        (newly_underfull > BPLUS_TREE_CONSOLIDATE_BUSY_LEAVES &&
+         underfull_leaves_.size() < BPLUS_TREE_CONSOLIDATE_MAX_BACKLOG)) {
+      continue;
+    }
+    lock.unlock();
+    Consolidate(BPLUS_TREE_CONSOLIDATE_BATCH);
+    lock.lock();
+  }
+}
+
+/*****************************************************************************
+ * B-LINK
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RightLink(const BPlusTreePage *page, const KeyType &key) const -> page_id_t {
+  page_id_t next_page_id;
+  const KeyType *high_key;
+  if (page->IsLeafPage()) {
+    auto leaf = reinterpret_cast<const LeafPage *>(page);
+    next_page_id = leaf->GetNextPageId();
+    high_key = &leaf->GetHighKey();
+  } else {
+    auto internal = reinterpret_cast<const InternalPage *>(page);
+    next_page_id = internal->GetNextPageId();
+    high_key = &internal->GetHighKey();
+  }
+  if (next_page_id == INVALID_PAGE_ID || comparator_(key, *high_key) < 0) {
+    return INVALID_PAGE_ID;
+  }
+  return next_page_id;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::MoveRightWrite(const KeyType &key, WritePageGuard *guard) {
+  // Latches are taken left to right on each level, so coupling here cannot deadlock.
+  page_id_t right_page_id;
+  while ((right_page_id = RightLink(guard->As<BPlusTreePage>(), key)) != INVALID_PAGE_ID) {
+    *guard = bpm_->FetchPageWrite(right_page_id);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertBLink(const KeyType &key, const ValueType &value) -> bool {
+  std::vector<page_id_t> path;
+  page_id_t leaf_page_id;
+  {
+    ReadPageGuard read_guard;
+    if (!FetchLeafRead(&key, &read_guard, &path)) {
+      Context ctx;
+      ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
+      if (ctx.header_page_->As<BPlusTreeHeaderPage>()->root_page_id_ == INVALID_PAGE_ID) {
+        return StartNewTree(key, value, ctx);
+      }
+      // Somebody else planted the root first.
+      ctx.header_page_ = std::nullopt;
+      return InsertBLink(key, value);
+    }
+    leaf_page_id = read_guard.PageId();
+  }
+
+  WritePageGuard guard = bpm_->FetchPageWrite(leaf_page_id);
+  MoveRightWrite(key, &guard);
+  auto leaf = guard.AsMut<LeafPage>();
+  int old_size = leaf->GetSize();
+  if (leaf->Insert(key, value, comparator_) == old_size) {
+    return false;
+  }
+  if (leaf->GetSize() < leaf->GetMaxSize()) {
+    return true;
+  }
+
+  // The new right page is fully linked in before the split page is released, so readers can already reach it.
+  page_id_t new_page_id;
+  WritePageGuard new_guard = bpm_->NewPageGuarded(&new_page_id).UpgradeWrite();
+  auto new_leaf = new_guard.AsMut<LeafPage>();
+  new_leaf->Init(leaf_max_size_);
+  leaf->MoveHalfTo(new_leaf);
+  leaf->SetNextPageId(new_page_id);
+  page_id_t page_id = guard.PageId();
+  new_leaf->SetPrevPageId(page_id);
+  SetPrevPageIdOf(new_leaf->GetNextPageId(), new_page_id);
+  KeyType separator = new_leaf->KeyAt(0);
+  new_guard.Drop();
+  guard.Drop();
+  InsertIntoParentBLink(&path, 0, page_id, separator, new_page_id);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParentBLink(std::vector<page_id_t> *path, int level, page_id_t page_id, KeyType key,
+                                           page_id_t new_page_id) {
+  while (true) {
+    if (path->empty()) {
+      WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+      auto header = header_guard.AsMut<BPlusTreeHeaderPage>();
+      if (header->root_page_id_ == page_id) {
+        page_id_t root_page_id;
+        WritePageGuard root_guard = bpm_->NewPageGuarded(&root_page_id).UpgradeWrite();
+        auto root = root_guard.AsMut<InternalPage>();
+        root->Init(internal_max_size_);
+        root->PopulateNewRoot(page_id, key, new_page_id);
+        header->root_page_id_ = root_page_id;
+        return;
+      }
+      // The split page was not the root, or the root has split and grown the tree meanwhile. Find the pages above
+      // this level again from the current root; if the tree has not grown yet, wait for whoever split the root.
+      header_guard.Drop();
+      ReadPageGuard leaf_guard;
+      FetchLeafRead(&key, &leaf_guard, path);
+      leaf_guard.Drop();
+      if (static_cast<int>(path->size()) <= level) {
+        path->clear();
+        std::this_thread::yield();
+        continue;
+      }
+      path->resize(path->size() - level);
+    }
+
+    WritePageGuard guard = bpm_->FetchPageWrite(path->back());
+    path->pop_back();
+    MoveRightWrite(key, &guard);
+    auto parent = guard.AsMut<InternalPage>();
+    page_id_t left_page_id = parent->ValueAt(parent->ChildIndex(key, comparator_));
+    if (parent->GetSize() < parent->GetMaxSize()) {
+      parent->InsertNodeAfter(left_page_id, key, new_page_id);
+      return;
+    }
+
+    page_id_t sibling_page_id;
+    WritePageGuard sibling_guard = bpm_->NewPageGuarded(&sibling_page_id).UpgradeWrite();
+    auto sibling = sibling_guard.AsMut<InternalPage>();
+    sibling->Init(internal_max_size_);
+    parent->SplitInsert(sibling, left_page_id, key, new_page_id);
+    parent->SetNextPageId(sibling_page_id);
+    key = sibling->KeyAt(0);
+    page_id = guard.PageId();
+    new_page_id = sibling_page_id;
+    level++;
+  }
+}
+
+/*
+ * Removal only touches the leaf. Pages are never merged, since a reader may still hold the id of any page it saw.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveBLink(const KeyType &key) {
+  page_id_t leaf_page_id;
+  {
+    ReadPageGuard read_guard;
+    if (!FetchLeafRead(&key, &read_guard)) {
+      return;
+    }
+    leaf_page_id = read_guard.PageId();
+  }
+  WritePageGuard guard = bpm_->FetchPageWrite(leaf_page_id);
+  MoveRightWrite(key, &guard);
+  guard.AsMut<LeafPage>()->RemoveAndDeleteRecord(key, comparator_);
+}
+
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(std::vector<MappingType> pairs, double fill_factor) -> bool {
+  // Hold the header for the whole build so that nobody sees a partial tree.
+  WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  auto header = header_guard.AsMut<BPlusTreeHeaderPage>();
+  if (header->root_page_id_ != INVALID_PAGE_ID) {
+    return false;
+  }
+
+  std::stable_sort(pairs.begin(), pairs.end(), [this](const MappingType &lhs, const MappingType &rhs) {
+    return comparator_(lhs.first, rhs.first) < 0;
+  });
+  pairs.erase(std::unique(pairs.begin(), pairs.end(),
+                          [this](const MappingType &lhs, const MappingType &rhs) {
+                            return comparator_(lhs.first, rhs.first) == 0;
+                          }),
+              pairs.end());
+  if (pairs.empty()) {
+    return true;
+  }
+
+  // Leaves split when they reach max size and internal pages when they exceed it, so a full leaf holds one pair less.
+  fill_factor = std::clamp(fill_factor, 0.0, 1.0);
+  int leaf_fill = std::clamp(static_cast<int>((leaf_max_size_ - 1) * fill_factor), std::max(leaf_max_size_ / 2, 1),
+                             std::max(leaf_max_size_ - 1, 1));
+  int internal_fill = std::clamp(static_cast<int>(internal_max_size_ * fill_factor),
+                                 std::max((internal_max_size_ + 1) / 2, 2), internal_max_size_);
+
+  // Spread `total` entries evenly over as few pages as the fill allows, so the last page is not left nearly empty. A
+  // page below the minimum size would merge on its first removal, so there are never more pages than can each get
+  // `min_size` entries; the remainder goes to the earlier pages. Such pages hold at most 2 * min_size - 1 entries,
+  // which still fits.
+  auto page_count = [](size_t total, int fill, int min_size) {
+    size_t count = std::min((total + fill - 1) / fill, total / std::max(min_size, 1));
+    return std::max<size_t>(count, 1);
+  };
+  auto page_size = [](size_t total, size_t count, size_t index) {
+    return total / count + (index < total % count ? 1 : 0);
+  };
+
+  // First key and page id of every page on the level just built.
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  size_t count = page_count(pairs.size(), leaf_fill, leaf_max_size_ / 2);
+  level.reserve(count);
+  WritePageGuard prev_guard;
+  for (size_t i = 0, pos = 0; i < count; i++) {
+    page_id_t page_id;
+    WritePageGuard guard = bpm_->NewPageGuarded(&page_id).UpgradeWrite();
+    auto leaf = guard.AsMut<LeafPage>();
+    leaf->Init(leaf_max_size_);
+    for (size_t end = pos + page_size(pairs.size(), count, i); pos < end; pos++) {
+      leaf->Insert(pairs[pos].first, pairs[pos].second, comparator_);
+    }
+    if (i > 0) {
+      auto prev = prev_guard.AsMut<LeafPage>();
+      prev->SetNextPageId(page_id);
+      prev->SetHighKey(leaf->KeyAt(0));
+      leaf->SetPrevPageId(level.back().second);
+    }
+    level.emplace_back(leaf->KeyAt(0), page_id);
+    prev_guard = std::move(guard);
+  }
+
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parents;
+    count = page_count(level.size(), internal_fill, (internal_max_size_ + 1) / 2);
+    parents.reserve(count);
+    prev_guard.Drop();
+    for (size_t i = 0, pos = 0; i < count; i++) {
+      page_id_t page_id;
+      WritePageGuard guard = bpm_->NewPageGuarded(&page_id).UpgradeWrite();
+      auto internal = guard.AsMut<InternalPage>();
+      internal->Init(internal_max_size_);
+      // The first key of each page is not used for routing, but becomes the separator in the parent.
+      for (size_t end = pos + page_size(level.size(), count, i); pos < end; pos++) {
+        int index = internal->GetSize();
+        internal->SetKeyAt(index, level[pos].first);
+        internal->SetValueAt(index, level[pos].second);
+        internal->IncreaseSize(1);
+      }
+      if (i > 0) {
+        auto prev = prev_guard.AsMut<InternalPage>();
+        prev->SetNextPageId(page_id);
+        prev->SetHighKey(internal->KeyAt(0));
+      }
+      parents.emplace_back(internal->KeyAt(0), page_id);
+      prev_guard = std::move(guard);
+    }
+    level = std::move(parents);
+  }
+
+  header->root_page_id_ = level[0].second;
+  return true;
 }
 
 /*****************************************************************************
@@ -87,7 +987,13 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
+  ReadPageGuard guard;
+  if (!FetchLeafRead(nullptr, &guard)) {
+    return End();
+  }
+  return INDEXITERATOR_TYPE(bpm_, std::move(guard), 0);
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -95,7 +1001,106 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE()
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  ReadPageGuard guard;
+  if (!FetchLeafRead(&key, &guard)) {
+    return End();
+  }
+  int index = guard.As<LeafPage>()->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(bpm_, std::move(guard), index);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Begin(const KeyType *lower_key, const KeyType *upper_key, size_t read_ahead_leaves)
+    -> INDEXITERATOR_TYPE {
+  ReadPageGuard guard;
+  if (!FetchLeafRead(lower_key, &guard)) {
+    return End();
+  }
+  int index = lower_key == nullptr ? 0 : guard.As<LeafPage>()->KeyIndex(*lower_key, comparator_);
+  return INDEXITERATOR_TYPE(bpm_, std::move(guard), index, &comparator_, upper_key, read_ahead_leaves);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::RBegin(const KeyType *upper_key, const KeyType *lower_key) -> INDEXITERATOR_TYPE {
+  ReadPageGuard guard;
+  if (!(upper_key == nullptr ? FetchRightmostLeafRead(&guard) : FetchLeafRead(upper_key, &guard))) {
+    return End();
+  }
+  auto leaf = guard.As<LeafPage>();
+  int index = leaf->GetSize() - 1;
+  if (upper_key != nullptr) {
+    index = leaf->KeyIndex(*upper_key, comparator_);
+    if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), *upper_key) != 0) {
+      index--;
+    }
+  }
+  return INDEXITERATOR_TYPE(this, bpm_, std::move(guard), index, &comparator_, upper_key, lower_key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::SplitRange(const KeyType *lower_key, const KeyType *upper_key, size_t partitions)
+    -> std::vector<KeyType> {
+  std::vector<KeyType> separators;
+  if (partitions <= 1) {
+    return separators;
+  }
+  // Go one level deeper at a time until the range spans enough subtrees, or only leaves are left below. The range
+  // rarely starts and ends on separators, so take a few times more subtrees than partitions to even out the ends.
+  const size_t wanted_subtrees = partitions * 4;
+  for (int depth = 0;; depth++) {
+    separators.clear();
+    ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+    page_id_t root_page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+    if (root_page_id == INVALID_PAGE_ID) {
+      return separators;
+    }
+    guard = bpm_->FetchPageRead(root_page_id);
+    if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+      return separators;
+    }
+    bool deeper = CollectSeparators(guard.As<InternalPage>(), depth, lower_key, upper_key, &separators);
+    if (separators.size() + 1 >= wanted_subtrees || !deeper) {
+      break;
+    }
+  }
+  if (separators.size() + 1 <= partitions) {
+    return separators;
+  }
+
+  // n separators cut the range into n + 1 pieces; keep every (n + 1) / partitions-th cut
+  std::vector<KeyType> boundaries;
+  boundaries.reserve(partitions - 1);
+  for (size_t i = 1; i < partitions; i++) {
+    boundaries.push_back(separators[i * (separators.size() + 1) / partitions - 1]);
+  }
+  return boundaries;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::CollectSeparators(const InternalPage *internal, int depth, const KeyType *lower_key,
+                                       const KeyType *upper_key, std::vector<KeyType> *separators) -> bool {
+  int begin = lower_key == nullptr ? 0 : internal->ChildIndex(*lower_key, comparator_);
+  int end = upper_key == nullptr ? internal->GetSize() - 1 : internal->ChildIndex(*upper_key, comparator_);
+  bool deeper = false;
+  for (int i = begin; i <= end; i++) {
+    if (i > begin) {
+      separators->push_back(internal->KeyAt(i));
+    }
+    if (depth == 0 && i > begin) {
+      continue;
+    }
+    // At the last level only one child is looked at, to tell whether there are internal pages below
+    ReadPageGuard child_guard = bpm_->FetchPageRead(internal->ValueAt(i));
+    if (child_guard.As<BPlusTreePage>()->IsLeafPage()) {
+      deeper = false;
+    } else {
+      deeper = depth == 0 ||
+               CollectSeparators(child_guard.As<InternalPage>(), depth - 1, lower_key, upper_key, separators);
+    }
+  }
+  return deeper;
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -109,7 +1114,10 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE();
  * @return Page id of the root of this tree
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+}
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -117,18 +1125,24 @@ auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
 
 /*
  * This method is used for test only
- * Read data from file and insert one by one
+ * Read data from file and insert one by one, or bulk load it if the tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *txn) {
   int64_t key;
   std::ifstream input(file_name);
-  while (input) {
-    input >> key;
-
+  std::vector<MappingType> pairs;
+  while (input >> key) {
     KeyType index_key;
     index_key.SetFromInteger(key);
     RID rid(key);
+    pairs.emplace_back(index_key, rid);
+  }
+  if (GetRootPageId() == INVALID_PAGE_ID) {
+    BulkLoad(std::move(pairs));
+    return;
+  }
+  for (const auto &[index_key, rid] : pairs) {
     Insert(index_key, rid, txn);
   }
 }
@@ -344,4 +1358,16 @@ template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTree<GenericKey<4>, RID, MemcmpComparator<4>>;
+
+template class BPlusTree<GenericKey<8>, RID, MemcmpComparator<8>>;
+
+template class BPlusTree<GenericKey<16>, RID, MemcmpComparator<16>>;
+
+template class BPlusTree<GenericKey<32>, RID, MemcmpComparator<32>>;
+
+template class BPlusTree<GenericKey<64>, RID, MemcmpComparator<64>>;
+
+template class BPlusTree<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>;
+
 }  // namespace bustub
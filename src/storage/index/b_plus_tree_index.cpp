@@ -11,35 +11,107 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+
 namespace bustub {
+
+namespace {
+
+/** Project an index entry onto `schema`, taking the entry columns at `positions`. */
+auto ProjectEntry(const Tuple &entry, const Schema *entry_schema, const Schema *schema,
+                  const std::vector<uint32_t> &positions) -> Tuple {
+  std::vector<Value> values;
+  values.reserve(positions.size());
+  for (auto position : positions) {
+    values.push_back(entry.GetValue(entry_schema, position));
+  }
+  return Tuple(std::move(values), schema);
+}
+
+}  // namespace
+
 /*
  * Constructor
  */
 INDEX_TEMPLATE_ARGUMENTS
-BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
+BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                                     BPlusTreeMode mode)
     : Index(std::move(metadata)), comparator_(GetMetadata()->GetKeySchema()) {
   page_id_t header_page_id;
   buffer_pool_manager->NewPage(&header_page_id);
-  container_ = std::make_shared<BPlusTree<KeyType, ValueType, KeyComparator>>(GetMetadata()->GetName(), header_page_id,
-                                                                              buffer_pool_manager, comparator_);
+  container_ = std::make_shared<BPlusTree<KeyType, ValueType, KeyComparator>>(
+      GetMetadata()->GetName(), header_page_id, buffer_pool_manager, comparator_, LEAF_PAGE_SIZE, INTERNAL_PAGE_SIZE,
+      mode);
+  key_positions_.resize(GetMetadata()->GetKeyAttrs().size());
+  std::iota(key_positions_.begin(), key_positions_.end(), 0);
+  include_positions_.resize(GetMetadata()->GetIncludeAttrs().size());
+  std::iota(include_positions_.begin(), include_positions_.end(), static_cast<uint32_t>(key_positions_.size()));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::MakeEntry(const Tuple &entry, RID rid) const -> std::pair<KeyType, ValueType> {
+  std::pair<KeyType, ValueType> pair{KeyType{}, ValueType{rid}};
+  if (include_positions_.empty()) {
+    pair.first.SetFromKey(entry);
+    return pair;
+  }
+  if constexpr (std::is_same_v<ValueType, RID>) {
+    throw NotImplementedException("included columns need a covering index value type");
+  } else {
+    const auto *metadata = GetMetadata();
+    pair.first.SetFromKey(ProjectEntry(entry, metadata->GetEntrySchema(), metadata->GetKeySchema(), key_positions_));
+    pair.second.SetPayload(
+        ProjectEntry(entry, metadata->GetEntrySchema(), metadata->GetIncludeSchema(), include_positions_));
+  }
+  return pair;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
   // construct insert index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+  auto [index_key, value] = MakeEntry(key, rid);
 
-  return container_->Insert(index_key, rid, transaction);
+  if (!container_->Insert(index_key, value, transaction)) {
+    return false;
+  }
+  AddToBloomFilter({index_key});
+  return true;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+  container_->Remove(MakeEntry(key, rid).first, transaction);
+  RemoveFromBloomFilter(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction)
+    -> size_t {
+  std::vector<std::pair<KeyType, ValueType>> pairs;
+  std::vector<KeyType> keys;
+  pairs.reserve(entries.size());
+  keys.reserve(entries.size());
+  for (const auto &[entry, rid] : entries) {
+    pairs.push_back(MakeEntry(entry, rid));
+    keys.push_back(pairs.back().first);
+  }
+  size_t inserted = container_->InsertBatch(std::move(pairs), transaction);
+  AddToBloomFilter(keys);
+  return inserted;
+}
 
-  container_->Remove(index_key, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::DeleteEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+  std::vector<KeyType> keys;
+  keys.reserve(entries.size());
+  for (const auto &[entry, rid] : entries) {
+    keys.push_back(MakeEntry(entry, rid).first);
+  }
+  container_->RemoveBatch(std::move(keys), transaction);
+  RemoveFromBloomFilter(entries.size());
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -48,7 +120,125 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_->GetValue(index_key, result, transaction);
+  bool filtered = false;
+  {
+    std::shared_lock lock(bloom_latch_);
+    if (bloom_filter_ != nullptr) {
+      bloom_probes_++;
+      if (!bloom_filter_->MayContain(HashFunction<KeyType>{}.GetHash(index_key))) {
+        bloom_skipped_++;
+        return;
+      }
+      filtered = true;
+    }
+  }
+
+  size_t old_size = result->size();
+  if constexpr (std::is_same_v<ValueType, RID>) {
+    container_->GetValue(index_key, result, transaction);
+  } else {
+    std::vector<ValueType> values;
+    container_->GetValue(index_key, &values, transaction);
+    for (const auto &value : values) {
+      result->push_back(value.rid_);
+    }
+  }
+  if (filtered && result->size() == old_size) {
+    bloom_false_positives_++;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> entries, double fill_factor) -> bool {
+  if (!container_->BulkLoad(std::move(entries), fill_factor)) {
+    return false;
+  }
+  std::unique_lock lock(bloom_latch_);
+  if (bloom_filter_ != nullptr) {
+    RebuildBloomFilter();
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * BLOOM FILTER
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::EnableBloomFilter() {
+  std::unique_lock lock(bloom_latch_);
+  RebuildBloomFilter();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::RebuildBloomFilter() {
+  HashFunction<KeyType> hash_fn;
+  std::vector<uint64_t> hashes;
+  std::vector<std::pair<KeyType, ValueType>> batch;
+  auto iter = container_->Begin(nullptr, nullptr);
+  while (iter.NextBatch(&batch, INDEX_BATCH_SIZE) > 0) {
+    for (const auto &[key, value] : batch) {
+      hashes.push_back(hash_fn.GetHash(key));
+    }
+    batch.clear();
+  }
+
+  // Leave room for as many inserts again before the next rebuild
+  bloom_filter_ = std::make_unique<BloomFilter>(std::max<size_t>(hashes.size() * 2, BLOOM_FILTER_MIN_CAPACITY));
+  for (auto hash : hashes) {
+    bloom_filter_->Insert(hash);
+  }
+  bloom_built_keys_ = hashes.size();
+  bloom_inserts_ = 0;
+  bloom_removals_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::AddToBloomFilter(const std::vector<KeyType> &keys) {
+  {
+    std::shared_lock lock(bloom_latch_);
+    if (bloom_filter_ == nullptr) {
+      return;
+    }
+    HashFunction<KeyType> hash_fn;
+    for (const auto &key : keys) {
+      bloom_filter_->Insert(hash_fn.GetHash(key));
+    }
+    if (bloom_built_keys_ + (bloom_inserts_ += keys.size()) <= bloom_filter_->GetCapacity()) {
+      return;
+    }
+  }
+  std::unique_lock lock(bloom_latch_);
+  if (bloom_built_keys_ + bloom_inserts_ > bloom_filter_->GetCapacity()) {
+    RebuildBloomFilter();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::RemoveFromBloomFilter(size_t count) {
+  {
+    std::shared_lock lock(bloom_latch_);
+    if (bloom_filter_ == nullptr || (bloom_removals_ += count) * 2 < bloom_built_keys_ + bloom_inserts_) {
+      return;
+    }
+  }
+  std::unique_lock lock(bloom_latch_);
+  if (bloom_removals_ * 2 >= bloom_built_keys_ + bloom_inserts_) {
+    RebuildBloomFilter();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetBloomFilterStats() const -> BloomFilterStats {
+  std::shared_lock lock(bloom_latch_);
+  BloomFilterStats stats;
+  if (bloom_filter_ == nullptr) {
+    return stats;
+  }
+  stats.probes_ = bloom_probes_;
+  stats.skipped_ = bloom_skipped_;
+  stats.false_positives_ = bloom_false_positives_;
+  stats.estimated_false_positive_rate_ = bloom_filter_->EstimatedFalsePositiveRate();
+  return stats;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -60,10 +250,30 @@ auto BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) -> INDEXITERATOR
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetEndIterator() -> INDEXITERATOR_TYPE { return container_->End(); }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetRangeIterator(const KeyType *lower_key, const KeyType *upper_key)
+    -> INDEXITERATOR_TYPE {
+  return container_->Begin(lower_key, upper_key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetReverseIterator(const KeyType *upper_key, const KeyType *lower_key)
+    -> INDEXITERATOR_TYPE {
+  return container_->RBegin(upper_key, lower_key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetRangePartitions(const KeyType *lower_key, const KeyType *upper_key, size_t partitions)
+    -> std::vector<KeyType> {
+  return container_->SplitRange(lower_key, upper_key, partitions);
+}
+
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTreeIndex<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>;
+
 }  // namespace bustub
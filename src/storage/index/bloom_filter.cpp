@@ -0,0 +1,70 @@
+#include "storage/index/bloom_filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/config.h"
+
+namespace bustub {
+
+namespace {
+
+/** Odd multipliers picking the bit of each word from the low half of the hash, as in the Parquet Bloom filter */
+constexpr uint32_t SALT[] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                             0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+}  // namespace
+
+BloomFilter::BloomFilter(size_t capacity)
+    : capacity_(capacity),
+      num_blocks_(std::max<size_t>(1, (capacity * BLOOM_FILTER_BITS_PER_KEY + 255) / 256)),
+      words_(new std::atomic<uint32_t>[num_blocks_ * WORDS_PER_BLOCK]) {
+  for (size_t i = 0; i < num_blocks_ * WORDS_PER_BLOCK; i++) {
+    words_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void BloomFilter::MakeMask(uint64_t hash, uint32_t mask[WORDS_PER_BLOCK]) {
+  auto key = static_cast<uint32_t>(hash);
+  for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+    mask[i] = 1U << ((key * SALT[i]) >> 27);
+  }
+}
+
+auto BloomFilter::BlockOf(uint64_t hash) const -> size_t {
+  // the high half of the hash, scaled to the number of blocks without a division
+  return static_cast<size_t>(((hash >> 32) * num_blocks_) >> 32) * WORDS_PER_BLOCK;
+}
+
+void BloomFilter::Insert(uint64_t hash) {
+  uint32_t mask[WORDS_PER_BLOCK];
+  MakeMask(hash, mask);
+  size_t block = BlockOf(hash);
+  for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+    words_[block + i].fetch_or(mask[i], std::memory_order_release);
+  }
+}
+
+auto BloomFilter::MayContain(uint64_t hash) const -> bool {
+  uint32_t mask[WORDS_PER_BLOCK];
+  MakeMask(hash, mask);
+  size_t block = BlockOf(hash);
+  uint32_t missing = 0;
+  for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+    missing |= mask[i] & ~words_[block + i].load(std::memory_order_acquire);
+  }
+  return missing == 0;
+}
+
+auto BloomFilter::EstimatedFalsePositiveRate() const -> double {
+  size_t bits_set = 0;
+  size_t num_words = num_blocks_ * WORDS_PER_BLOCK;
+  for (size_t i = 0; i < num_words; i++) {
+    bits_set += __builtin_popcount(words_[i].load(std::memory_order_relaxed));
+  }
+  // an absent key gets through if the bit it tests is set in all eight words of its block
+  double share_set = static_cast<double>(bits_set) / static_cast<double>(num_words * 32);
+  return std::pow(share_set, WORDS_PER_BLOCK);
+}
+
+}  // namespace bustub
@@ -1,9 +1,13 @@
 /**
  * index_iterator.cpp
  */
+#include <algorithm>
 #include <cassert>
 
+#include "storage/index/b_plus_tree.h"
 #include "storage/index/index_iterator.h"
+#include "storage/index/covering_value.h"
+#include "storage/index/memcmp_key.h"
 
 namespace bustub {
 
@@ -14,17 +18,204 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index)
+    : bpm_(bpm), guard_(std::move(guard)), page_id_(guard_.PageId()), index_(index) {
+  EnterLeaf();
+  SkipExhaustedLeaves();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index,
+                                  const KeyComparator *comparator, const KeyType *upper_key, size_t read_ahead_leaves)
+    : bpm_(bpm),
+      guard_(std::move(guard)),
+      page_id_(guard_.PageId()),
+      index_(index),
+      comparator_(comparator),
+      has_bound_key_(upper_key != nullptr),
+      read_ahead_leaves_(read_ahead_leaves) {
+  if (has_bound_key_) {
+    bound_key_ = *upper_key;
+  }
+  EnterLeaf();
+  SkipExhaustedLeaves();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree, BufferPoolManager *bpm,
+                                  ReadPageGuard guard, int index, const KeyComparator *comparator,
+                                  const KeyType *upper_key, const KeyType *lower_key)
+    : bpm_(bpm),
+      guard_(std::move(guard)),
+      page_id_(guard_.PageId()),
+      index_(index),
+      comparator_(comparator),
+      has_bound_key_(lower_key != nullptr),
+      reverse_(true),
+      tree_(tree),
+      has_resume_key_(upper_key != nullptr) {
+  if (has_bound_key_) {
+    bound_key_ = *lower_key;
+  }
+  if (has_resume_key_) {
+    resume_key_ = *upper_key;
+  }
+  EnterLeaf();
+  SkipExhaustedLeaves();
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return page_id_ == INVALID_PAGE_ID; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
+  return guard_.template As<LeafPage>()->PairAt(index_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  index_ += reverse_ ? -1 : 1;
+  SkipExhaustedLeaves();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::NextBatch(std::vector<MappingType> *out, size_t max_pairs) -> size_t {
+  if (page_id_ == INVALID_PAGE_ID) {
+    return 0;
+  }
+  auto leaf = guard_.template As<LeafPage>();
+  int step = reverse_ ? -1 : 1;
+  size_t count = std::min(max_pairs, static_cast<size_t>(reverse_ ? index_ - end_index_ + 1 : end_index_ - index_));
+  for (size_t i = 0; i < count; i++, index_ += step) {
+    out->push_back(leaf->PairAt(index_));
+  }
+  SkipExhaustedLeaves();
+  return count;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+  while (page_id_ != INVALID_PAGE_ID) {
+    if (!IsLeafExhausted()) {
+      return;
+    }
+    if (reverse_) {
+      StepBack();
+      continue;
+    }
+    // Release the current leaf before latching the next one, so that we never hold two leaf latches while a writer
+    // works on the same pair of siblings from the other direction.
+    page_id_t next_page_id = last_leaf_ ? INVALID_PAGE_ID : guard_.template As<LeafPage>()->GetNextPageId();
+    guard_.Drop();
+    index_ = 0;
+    page_id_ = next_page_id;
+    if (page_id_ == INVALID_PAGE_ID) {
+      read_ahead_.clear();
+      return;
+    }
+    ReadAhead(page_id_);
+    guard_ = bpm_->FetchPageRead(page_id_);
+    if (!read_ahead_.empty()) {
+      // guard_ holds its own pin now
+      read_ahead_.pop_front();
+    }
+    EnterLeaf();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::EnterLeaf() {
+  auto leaf = guard_.template As<LeafPage>();
+  last_leaf_ = false;
+  if (reverse_) {
+    end_index_ = 0;
+    if (has_bound_key_ && ReachesLowerKey(leaf)) {
+      end_index_ = leaf->KeyIndex(bound_key_, *comparator_);
+      last_leaf_ = true;
+    }
+    return;
+  }
+  end_index_ = leaf->GetSize();
+  if (!has_bound_key_ || !ReachesUpperKey(leaf)) {
+    return;
+  }
+  // keys are unique, so the first key not below the upper bound is the only one that can equal it
+  end_index_ = leaf->KeyIndex(bound_key_, *comparator_);
+  if (end_index_ < leaf->GetSize() && (*comparator_)(leaf->KeyAt(end_index_), bound_key_) == 0) {
+    end_index_++;
+  }
+  last_leaf_ = true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::StepBack() {
+  auto leaf = guard_.template As<LeafPage>();
+  if (leaf->GetSize() > 0 && (!has_resume_key_ || (*comparator_)(leaf->KeyAt(0), resume_key_) < 0)) {
+    resume_key_ = leaf->KeyAt(0);
+    has_resume_key_ = true;
+  }
+  // As going forward, only one leaf is latched at a time.
+  page_id_t page_id = page_id_;
+  page_id_t prev_page_id = last_leaf_ ? INVALID_PAGE_ID : leaf->GetPrevPageId();
+  guard_.Drop();
+  page_id_ = prev_page_id;
+  if (page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  guard_ = bpm_->FetchPageRead(page_id_);
+  if (guard_.template As<LeafPage>()->GetNextPageId() != page_id && has_resume_key_) {
+    // A split or merge got in between: this is no longer the leaf right before the one we left.
+    guard_.Drop();
+    if (!tree_->FetchLeafRead(&resume_key_, &guard_)) {
+      page_id_ = INVALID_PAGE_ID;
+      return;
+    }
+    page_id_ = guard_.PageId();
+  }
+  auto prev_leaf = guard_.template As<LeafPage>();
+  index_ = has_resume_key_ ? prev_leaf->KeyIndex(resume_key_, *comparator_) - 1 : prev_leaf->GetSize() - 1;
+  EnterLeaf();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::ReadAhead(page_id_t next_page_id) {
+  if (read_ahead_leaves_ == 0) {
+    return;
+  }
+  // A split or merge since the window was read changes the sibling chain; start over from the real next leaf.
+  if (!read_ahead_.empty() && read_ahead_.front().page_id_ != next_page_id) {
+    read_ahead_.clear();
+  }
+  page_id_t page_id = read_ahead_.empty() ? next_page_id : read_ahead_.back().next_page_id_;
+  while (page_id != INVALID_PAGE_ID && read_ahead_.size() <= read_ahead_leaves_) {
+    // best effort: stop when the buffer pool has no frame to spare
+    Page *page = bpm_->FetchPage(page_id);
+    if (page == nullptr) {
+      return;
+    }
+    page->RLatch();
+    auto leaf = reinterpret_cast<const LeafPage *>(page->GetData());
+    page_id_t next_page_id = has_bound_key_ && ReachesUpperKey(leaf) ? INVALID_PAGE_ID : leaf->GetNextPageId();
+    page->RUnlatch();
+    read_ahead_.push_back({BasicPageGuard(bpm_, page), page_id, next_page_id});
+    page_id = next_page_id;
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::ReachesUpperKey(const LeafPage *leaf) const -> bool {
+  return leaf->GetSize() > 0 && (*comparator_)(leaf->KeyAt(leaf->GetSize() - 1), bound_key_) >= 0;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::ReachesLowerKey(const LeafPage *leaf) const -> bool {
+  return leaf->GetSize() > 0 && (*comparator_)(leaf->KeyAt(0), bound_key_) <= 0;
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
@@ -36,4 +227,16 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<GenericKey<4>, RID, MemcmpComparator<4>>;
+
+template class IndexIterator<GenericKey<8>, RID, MemcmpComparator<8>>;
+
+template class IndexIterator<GenericKey<16>, RID, MemcmpComparator<16>>;
+
+template class IndexIterator<GenericKey<32>, RID, MemcmpComparator<32>>;
+
+template class IndexIterator<GenericKey<64>, RID, MemcmpComparator<64>>;
+
+template class IndexIterator<GenericKey<8>, CoveringValue<16>, GenericComparator<8>>;
+
 }  // namespace bustub
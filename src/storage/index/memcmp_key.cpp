@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memcmp_key.cpp
+//
+// Identification: src/storage/index/memcmp_key.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/memcmp_key.h"
+
+#include <cstdint>
+#include <string>
+
+#include "common/exception.h"
+#include "type/limits.h"
+#include "type/value.h"
+
+namespace bustub {
+
+namespace {
+
+/** Appends encoded bytes to a buffer, or only counts them when the buffer is null. */
+class KeyWriter {
+ public:
+  KeyWriter(char *data, size_t size) : data_(data), size_(size) {}
+
+  void PutByte(uint8_t byte) {
+    if (data_ != nullptr) {
+      if (offset_ >= size_) {
+        throw Exception(ExceptionType::OUT_OF_RANGE, "memcomparable key does not fit in the index key");
+      }
+      data_[offset_] = static_cast<char>(byte);
+    }
+    offset_++;
+  }
+
+  /** Write the low `bytes` bytes of `bits`, most significant first. */
+  void PutBigEndian(uint64_t bits, size_t bytes) {
+    for (size_t i = bytes; i > 0; i--) {
+      PutByte(static_cast<uint8_t>(bits >> ((i - 1) * 8)));
+    }
+  }
+
+  /** Integers of `bytes` bytes: flipping the sign bit makes negative values sort below positive ones. */
+  void PutSigned(int64_t value, size_t bytes) {
+    PutBigEndian(static_cast<uint64_t>(value) ^ (uint64_t{1} << (bytes * 8 - 1)), bytes);
+  }
+
+  auto GetOffset() const -> size_t { return offset_; }
+
+ private:
+  char *data_;
+  size_t size_;
+  size_t offset_{0};
+};
+
+void EncodeValue(const Value &value, KeyWriter *writer) {
+  switch (value.GetTypeId()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      writer->PutSigned(value.GetAs<int8_t>(), sizeof(int8_t));
+      break;
+    case TypeId::SMALLINT:
+      writer->PutSigned(value.GetAs<int16_t>(), sizeof(int16_t));
+      break;
+    case TypeId::INTEGER:
+      writer->PutSigned(value.GetAs<int32_t>(), sizeof(int32_t));
+      break;
+    case TypeId::BIGINT:
+      writer->PutSigned(value.GetAs<int64_t>(), sizeof(int64_t));
+      break;
+    case TypeId::DECIMAL: {
+      auto decimal = value.GetAs<double>();
+      uint64_t bits;
+      memcpy(&bits, &decimal, sizeof(bits));
+      bits = (bits >> 63) != 0 ? ~bits : bits ^ (uint64_t{1} << 63);
+      writer->PutBigEndian(bits, sizeof(bits));
+      break;
+    }
+    case TypeId::TIMESTAMP:
+      // BUSTUB_TIMESTAMP_NULL is the largest value, so shifting by one wraps it around to zero
+      writer->PutBigEndian(value.GetAs<uint64_t>() + 1, sizeof(uint64_t));
+      break;
+    case TypeId::VARCHAR: {
+      if (value.IsNull()) {
+        writer->PutByte(0x00);
+        break;
+      }
+      writer->PutByte(0x01);
+      // the stored length counts the terminating '\0'
+      uint32_t length = value.GetLength() == 0 ? 0 : value.GetLength() - 1;
+      const char *data = value.GetData();
+      for (uint32_t i = 0; i < length; i++) {
+        writer->PutByte(static_cast<uint8_t>(data[i]));
+        if (data[i] == '\0') {
+          writer->PutByte(0xFF);
+        }
+      }
+      writer->PutByte(0x00);
+      writer->PutByte(0x00);
+      break;
+    }
+    default:
+      throw NotImplementedException("memcomparable encoding for this type");
+  }
+}
+
+}  // namespace
+
+void MemcmpKeyEncoder::Encode(const Tuple &tuple, const Schema *key_schema, char *data, size_t size) {
+  KeyWriter writer(data, size);
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    EncodeValue(tuple.GetValue(key_schema, i), &writer);
+  }
+  memset(data + writer.GetOffset(), 0, size - writer.GetOffset());
+}
+
+auto MemcmpKeyEncoder::EncodedSize(const Tuple &tuple, const Schema *key_schema) -> size_t {
+  KeyWriter writer(nullptr, 0);
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    EncodeValue(tuple.GetValue(key_schema, i), &writer);
+  }
+  return writer.GetOffset();
+}
+
+auto MemcmpKeyEncoder::EncodeToString(const Tuple &tuple, const Schema *key_schema) -> std::string {
+  std::string bytes(EncodedSize(tuple, key_schema), '\0');
+  Encode(tuple, key_schema, bytes.data(), bytes.size());
+  return bytes;
+}
+
+}  // namespace bustub
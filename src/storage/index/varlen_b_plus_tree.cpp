@@ -0,0 +1,441 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree.cpp
+//
+// Identification: src/storage/index/varlen_b_plus_tree.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+
+#include "common/exception.h"
+#include "storage/index/varlen_b_plus_tree.h"
+
+namespace bustub {
+
+namespace {
+
+/**
+ * Shortest key that sorts after `left` and not after `right`, given left < right. Internal pages only need to tell
+ * the two leaves apart, so a truncated separator leaves more room for children.
+ */
+auto ShortestSeparator(std::string_view left, std::string_view right) -> std::string {
+  size_t common = 0;
+  size_t limit = std::min(left.size(), right.size());
+  while (common < limit && left[common] == right[common]) {
+    common++;
+  }
+  return std::string(right.substr(0, common + 1));
+}
+
+}  // namespace
+
+VarlenBPlusTree::VarlenBPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager)
+    : index_name_(std::move(name)), bpm_(buffer_pool_manager), header_page_id_(header_page_id) {
+  WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
+  auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
+  root_page->root_page_id_ = INVALID_PAGE_ID;
+}
+
+/*
+ * Helper function to decide whether current b+tree is empty. Only the root can be left without entries, and it is
+ * freed then.
+ */
+auto VarlenBPlusTree::IsEmpty() -> bool { return GetRootPageId() == INVALID_PAGE_ID; }
+
+/*****************************************************************************
+ * LATCHING
+ *****************************************************************************/
+auto VarlenBPlusTree::FetchLeafOptimistic(std::string_view key, WritePageGuard *leaf) -> bool {
+  ReadPageGuard parent = bpm_->FetchPageRead(header_page_id_);
+  page_id_t page_id = parent.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  while (true) {
+    ReadPageGuard guard = bpm_->FetchPageRead(page_id);
+    const auto *page = guard.As<BPlusTreeSlottedPage>();
+    if (page->IsLeafPage()) {
+      // the parent's read latch keeps the leaf from being split or merged until it is write-latched
+      guard.Drop();
+      *leaf = bpm_->FetchPageWrite(page_id);
+      return true;
+    }
+    page_id = page->ChildAt(page->ChildIndex(key));
+    parent = std::move(guard);
+  }
+}
+
+auto VarlenBPlusTree::FetchLeafPessimistic(std::string_view key, Context &ctx, bool for_insert) -> bool {
+  ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
+  ctx.root_page_id_ = ctx.header_page_->As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (ctx.root_page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  page_id_t page_id = ctx.root_page_id_;
+  while (true) {
+    WritePageGuard guard = bpm_->FetchPageWrite(page_id);
+    const auto *page = guard.As<BPlusTreeSlottedPage>();
+    bool safe = for_insert ? IsSafeForInsert(page, key) : IsSafeForRemove(page, ctx.IsRootPage(page_id), key);
+    if (safe) {
+      ctx.header_page_ = std::nullopt;
+      ctx.write_set_.clear();
+    }
+    bool is_leaf = page->IsLeafPage();
+    if (!is_leaf) {
+      page_id = page->ChildAt(page->ChildIndex(key));
+    }
+    ctx.write_set_.push_back(std::move(guard));
+    if (is_leaf) {
+      return true;
+    }
+  }
+}
+
+/*
+ * A page is safe if the change below it cannot reach it. Leaves gain or lose `key`; internal pages gain or lose a
+ * separator, which may be as long as any key.
+ */
+auto VarlenBPlusTree::IsSafeForInsert(const BPlusTreeSlottedPage *page, std::string_view key) -> bool {
+  int key_size = page->IsLeafPage() ? static_cast<int>(key.size()) : BPlusTreeSlottedPage::MAX_KEY_SIZE;
+  return page->GetFreeSpace() >= BPlusTreeSlottedPage::EntrySize(key_size);
+}
+
+auto VarlenBPlusTree::IsSafeForRemove(const BPlusTreeSlottedPage *page, bool is_root, std::string_view key) -> bool {
+  if (is_root) {
+    return page->GetSize() > (page->IsLeafPage() ? 1 : 2);
+  }
+  int key_size = page->IsLeafPage() ? static_cast<int>(key.size()) : BPlusTreeSlottedPage::MAX_KEY_SIZE;
+  return page->GetUsedSpace() - BPlusTreeSlottedPage::EntrySize(key_size) >= BPlusTreeSlottedPage::MIN_USED_SPACE;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+auto VarlenBPlusTree::GetValue(std::string_view key, std::vector<RID> *result) -> bool {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t root_page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  guard = bpm_->FetchPageRead(root_page_id);
+  while (!guard.As<BPlusTreeSlottedPage>()->IsLeafPage()) {
+    const auto *page = guard.As<BPlusTreeSlottedPage>();
+    guard = bpm_->FetchPageRead(page->ChildAt(page->ChildIndex(key)));
+  }
+  const auto *leaf = guard.As<BPlusTreeSlottedPage>();
+  int index = leaf->KeyIndex(key);
+  if (index == leaf->GetSize() || leaf->KeyAt(index) != key) {
+    return false;
+  }
+  result->push_back(leaf->RidAt(index));
+  return true;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+auto VarlenBPlusTree::Insert(std::string_view key, const RID &value) -> bool {
+  if (static_cast<int>(key.size()) > BPlusTreeSlottedPage::MAX_KEY_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "index key is too long");
+  }
+
+  // Optimistic pass: most inserts fit in their leaf, so only the leaf needs a write latch.
+  {
+    WritePageGuard guard;
+    if (FetchLeafOptimistic(key, &guard)) {
+      auto *leaf = guard.AsMut<BPlusTreeSlottedPage>();
+      int index = leaf->KeyIndex(key);
+      if (index < leaf->GetSize() && leaf->KeyAt(index) == key) {
+        return false;
+      }
+      if (leaf->InsertRid(index, key, value)) {
+        return true;
+      }
+    }
+  }
+
+  // The leaf has to split (or the tree is empty): restart with pessimistic latch crabbing.
+  Context ctx;
+  if (!FetchLeafPessimistic(key, ctx, true)) {
+    page_id_t root_page_id;
+    WritePageGuard root_guard = bpm_->NewPageGuarded(&root_page_id).UpgradeWrite();
+    auto *root = root_guard.AsMut<BPlusTreeSlottedPage>();
+    root->Init(IndexPageType::LEAF_PAGE);
+    root->InsertRid(0, key, value);
+    ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_page_id;
+    return true;
+  }
+  auto *leaf = ctx.write_set_.back().AsMut<BPlusTreeSlottedPage>();
+  int index = leaf->KeyIndex(key);
+  if (index < leaf->GetSize() && leaf->KeyAt(index) == key) {
+    return false;
+  }
+  if (leaf->InsertRid(index, key, value)) {
+    return true;
+  }
+
+  // Split by bytes, then add the key to the half it belongs to; MAX_KEY_SIZE guarantees it fits there.
+  page_id_t new_page_id;
+  WritePageGuard new_guard = bpm_->NewPageGuarded(&new_page_id).UpgradeWrite();
+  auto *new_leaf = new_guard.AsMut<BPlusTreeSlottedPage>();
+  new_leaf->Init(IndexPageType::LEAF_PAGE);
+  leaf->MoveHalfTo(new_leaf);
+  new_leaf->SetNextPageId(leaf->GetNextPageId());
+  new_leaf->SetPrevPageId(ctx.write_set_.back().PageId());
+  SetPrevPageIdOf(new_leaf->GetNextPageId(), new_page_id);
+  leaf->SetNextPageId(new_page_id);
+
+  auto *target = key < new_leaf->KeyAt(0) ? leaf : new_leaf;
+  target->InsertRid(target->KeyIndex(key), key, value);
+  std::string separator = ShortestSeparator(leaf->KeyAt(leaf->GetSize() - 1), new_leaf->KeyAt(0));
+  new_guard.Drop();
+  InsertIntoParent(ctx, separator, new_page_id);
+  return true;
+}
+
+void VarlenBPlusTree::InsertIntoParent(Context &ctx, const std::string &separator, page_id_t right_page_id) {
+  page_id_t left_page_id = ctx.write_set_.back().PageId();
+  ctx.write_set_.pop_back();
+
+  if (ctx.write_set_.empty()) {
+    // The root itself was split: grow the tree by one level.
+    BUSTUB_ASSERT(ctx.IsRootPage(left_page_id), "split page without a latched parent must be the root");
+    page_id_t root_page_id;
+    WritePageGuard root_guard = bpm_->NewPageGuarded(&root_page_id).UpgradeWrite();
+    auto *root = root_guard.AsMut<BPlusTreeSlottedPage>();
+    root->Init(IndexPageType::INTERNAL_PAGE);
+    root->InsertChild(0, "", left_page_id);
+    root->InsertChild(1, separator, right_page_id);
+    ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_page_id;
+    return;
+  }
+
+  auto *parent = ctx.write_set_.back().AsMut<BPlusTreeSlottedPage>();
+  if (parent->InsertChild(parent->ChildIndex(separator) + 1, separator, right_page_id)) {
+    return;
+  }
+
+  // The first key of the new page moves up to the grandparent and becomes the ignored first key here.
+  page_id_t new_page_id;
+  WritePageGuard new_guard = bpm_->NewPageGuarded(&new_page_id).UpgradeWrite();
+  auto *new_internal = new_guard.AsMut<BPlusTreeSlottedPage>();
+  new_internal->Init(IndexPageType::INTERNAL_PAGE);
+  parent->MoveHalfTo(new_internal);
+  std::string push_up(new_internal->KeyAt(0));
+  new_internal->ClearFirstKey();
+
+  auto *target = separator < push_up ? parent : new_internal;
+  target->InsertChild(target->ChildIndex(separator) + 1, separator, right_page_id);
+  new_guard.Drop();
+  InsertIntoParent(ctx, push_up, new_page_id);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+void VarlenBPlusTree::Remove(std::string_view key) {
+  // Optimistic pass: only restart with write latches on the whole path if the leaf would underflow.
+  {
+    WritePageGuard guard;
+    if (!FetchLeafOptimistic(key, &guard)) {
+      return;
+    }
+    auto *leaf = guard.AsMut<BPlusTreeSlottedPage>();
+    int index = leaf->KeyIndex(key);
+    if (index == leaf->GetSize() || leaf->KeyAt(index) != key) {
+      return;
+    }
+    if (leaf->GetSize() > 1 && IsSafeForRemove(leaf, false, key)) {
+      leaf->RemoveAt(index);
+      return;
+    }
+  }
+
+  Context ctx;
+  if (!FetchLeafPessimistic(key, ctx, false)) {
+    return;
+  }
+  auto *leaf = ctx.write_set_.back().AsMut<BPlusTreeSlottedPage>();
+  int index = leaf->KeyIndex(key);
+  if (index == leaf->GetSize() || leaf->KeyAt(index) != key) {
+    return;
+  }
+  leaf->RemoveAt(index);
+  HandleUnderflow(ctx, key);
+}
+
+void VarlenBPlusTree::HandleUnderflow(Context &ctx, std::string_view key) {
+  WritePageGuard &guard = ctx.write_set_.back();
+  page_id_t page_id = guard.PageId();
+  auto *page = guard.AsMut<BPlusTreeSlottedPage>();
+
+  if (ctx.IsRootPage(page_id)) {
+    page_id_t new_root_page_id;
+    if (page->IsLeafPage() && page->GetSize() == 0) {
+      new_root_page_id = INVALID_PAGE_ID;
+    } else if (!page->IsLeafPage() && page->GetSize() == 1) {
+      new_root_page_id = page->ChildAt(0);
+    } else {
+      return;
+    }
+    ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = new_root_page_id;
+    ctx.write_set_.pop_back();
+    bpm_->DeletePage(page_id);
+    return;
+  }
+  if (page->GetUsedSpace() >= BPlusTreeSlottedPage::MIN_USED_SPACE) {
+    return;
+  }
+
+  BUSTUB_ASSERT(ctx.write_set_.size() >= 2, "underflowing page must have its parent latched");
+  auto *parent = ctx.write_set_[ctx.write_set_.size() - 2].AsMut<BPlusTreeSlottedPage>();
+  if (parent->GetSize() < 2) {
+    // the parent is an underfull internal page left with this one child
+    return;
+  }
+  int index = parent->ChildIndex(key);
+  bool sibling_is_left = index > 0;
+  int sibling_index = sibling_is_left ? index - 1 : index + 1;
+  WritePageGuard sibling_guard = bpm_->FetchPageWrite(parent->ChildAt(sibling_index));
+  auto *sibling = sibling_guard.AsMut<BPlusTreeSlottedPage>();
+
+  // Always merge the right page into the left one and drop the right page. Without room for that, the sibling is
+  // nearly full and keeps the page from being empty, so it is left underfull rather than rebalanced.
+  int right_index = sibling_is_left ? index : sibling_index;
+  auto *left = sibling_is_left ? sibling : page;
+  auto *right = sibling_is_left ? page : sibling;
+  std::string_view middle_key = parent->KeyAt(right_index);
+  int needed = right->GetUsedSpace() + (page->IsLeafPage() ? 0 : static_cast<int>(middle_key.size()));
+  if (left->GetFreeSpace() < needed) {
+    return;
+  }
+  right->MoveAllTo(left, middle_key);
+  if (page->IsLeafPage()) {
+    left->SetNextPageId(right->GetNextPageId());
+    SetPrevPageIdOf(left->GetNextPageId(), parent->ChildAt(right_index - 1));
+  }
+  page_id_t right_page_id = parent->ChildAt(right_index);
+  parent->RemoveAt(right_index);
+  sibling_guard.Drop();
+  ctx.write_set_.pop_back();
+  bpm_->DeletePage(right_page_id);
+  HandleUnderflow(ctx, key);
+}
+
+void VarlenBPlusTree::SetPrevPageIdOf(page_id_t page_id, page_id_t prev_page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  WritePageGuard guard = bpm_->FetchPageWrite(page_id);
+  guard.AsMut<BPlusTreeSlottedPage>()->SetPrevPageId(prev_page_id);
+}
+
+/*****************************************************************************
+ * INDEX ITERATOR
+ *****************************************************************************/
+auto VarlenBPlusTree::Begin(bool reverse) -> VarlenIndexIterator { return {this, reverse}; }
+
+auto VarlenBPlusTree::FetchScanLeaf(const std::string *bound, bool reverse, ReadPageGuard *leaf) -> bool {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  page_id_t root_page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (root_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  guard = bpm_->FetchPageRead(root_page_id);
+  while (!guard.As<BPlusTreeSlottedPage>()->IsLeafPage()) {
+    const auto *page = guard.As<BPlusTreeSlottedPage>();
+    int index;
+    if (reverse) {
+      // the last child holding keys less than `bound`; the empty first key is less than any bound but ""
+      index = bound == nullptr ? page->GetSize() - 1 : std::max(page->KeyIndex(*bound) - 1, 0);
+    } else {
+      index = bound == nullptr ? 0 : page->ChildIndex(*bound);
+    }
+    guard = bpm_->FetchPageRead(page->ChildAt(index));
+  }
+  *leaf = std::move(guard);
+  return true;
+}
+
+void VarlenBPlusTree::ScanLeaf(const std::string *bound, bool reverse, page_id_t *leaf_page_id,
+                               page_id_t *sibling_page_id, std::vector<std::pair<std::string, RID>> *entries) {
+  bool linked = *leaf_page_id != INVALID_PAGE_ID;
+  while (true) {
+    ReadPageGuard guard;
+    if (linked) {
+      // As in IndexIterator, only one leaf is latched at a time, so check that the sibling still links back.
+      if (*sibling_page_id == INVALID_PAGE_ID) {
+        return;
+      }
+      guard = bpm_->FetchPageRead(*sibling_page_id);
+      const auto *leaf = guard.As<BPlusTreeSlottedPage>();
+      if (!leaf->IsLeafPage() || (reverse ? leaf->GetNextPageId() : leaf->GetPrevPageId()) != *leaf_page_id) {
+        guard.Drop();
+        linked = false;
+      }
+    }
+    if (!linked && !FetchScanLeaf(bound, reverse, &guard)) {
+      return;
+    }
+
+    const auto *leaf = guard.As<BPlusTreeSlottedPage>();
+    if (reverse) {
+      int end = bound == nullptr ? leaf->GetSize() : leaf->KeyIndex(*bound);
+      for (int i = end - 1; i >= 0; i--) {
+        entries->emplace_back(std::string(leaf->KeyAt(i)), leaf->RidAt(i));
+      }
+    } else {
+      int start = 0;
+      if (bound != nullptr) {
+        start = leaf->KeyIndex(*bound);
+        if (start < leaf->GetSize() && leaf->KeyAt(start) == *bound) {
+          start++;
+        }
+      }
+      for (int i = start; i < leaf->GetSize(); i++) {
+        entries->emplace_back(std::string(leaf->KeyAt(i)), leaf->RidAt(i));
+      }
+    }
+    *leaf_page_id = guard.PageId();
+    *sibling_page_id = reverse ? leaf->GetPrevPageId() : leaf->GetNextPageId();
+    if (!entries->empty()) {
+      return;
+    }
+    linked = true;
+  }
+}
+
+auto VarlenBPlusTree::GetRootPageId() -> page_id_t {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+}
+
+/*****************************************************************************
+ * VARLEN INDEX ITERATOR
+ *****************************************************************************/
+VarlenIndexIterator::VarlenIndexIterator(VarlenBPlusTree *tree, bool reverse) : tree_(tree), reverse_(reverse) {
+  Fill(nullptr);
+}
+
+void VarlenIndexIterator::Fill(const std::string *bound) {
+  entries_.clear();
+  index_ = 0;
+  tree_->ScanLeaf(bound, reverse_, &leaf_page_id_, &sibling_page_id_, &entries_);
+}
+
+auto VarlenIndexIterator::operator++() -> VarlenIndexIterator & {
+  index_++;
+  if (index_ == entries_.size() && !entries_.empty()) {
+    std::string last = std::move(entries_.back().first);
+    Fill(&last);
+  }
+  return *this;
+}
+
+}  // namespace bustub
@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree_index.cpp
+//
+// Identification: src/storage/index/varlen_b_plus_tree_index.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/varlen_b_plus_tree_index.h"
+
+#include "common/exception.h"
+#include "storage/index/memcmp_key.h"
+
+namespace bustub {
+
+/*
+ * Constructor
+ */
+VarlenBPlusTreeIndex::VarlenBPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
+                                           BufferPoolManager *buffer_pool_manager)
+    : Index(std::move(metadata)) {
+  if (!GetMetadata()->GetIncludeAttrs().empty()) {
+    throw NotImplementedException("variable-length index keys do not support included columns");
+  }
+  page_id_t header_page_id;
+  buffer_pool_manager->NewPage(&header_page_id);
+  container_ = std::make_shared<VarlenBPlusTree>(GetMetadata()->GetName(), header_page_id, buffer_pool_manager);
+}
+
+auto VarlenBPlusTreeIndex::MakeKey(const Tuple &key) const -> std::string {
+  return MemcmpKeyEncoder::EncodeToString(key, GetMetadata()->GetKeySchema());
+}
+
+auto VarlenBPlusTreeIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool {
+  return container_->Insert(MakeKey(key), rid);
+}
+
+void VarlenBPlusTreeIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_->Remove(MakeKey(key));
+}
+
+void VarlenBPlusTreeIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  container_->GetValue(MakeKey(key), result);
+}
+
+auto VarlenBPlusTreeIndex::GetBeginIterator(bool reverse) -> VarlenIndexIterator {
+  return container_->Begin(reverse);
+}
+
+}  // namespace bustub
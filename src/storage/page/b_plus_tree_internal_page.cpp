@@ -9,11 +9,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
 #include "common/exception.h"
+#include "storage/index/memcmp_key.h"
 #include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_key_search.h"
 
 namespace bustub {
 /*****************************************************************************
@@ -26,44 +29,44 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
   SetPageType(IndexPageType::INTERNAL_PAGE);
-  SetSize(max_size / 2);
+  SetSize(0);
   SetMaxSize(max_size);
+  SetNextPageId(INVALID_PAGE_ID);
 }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetHighKey() const -> const KeyType & { return high_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetHighKey(const KeyType &high_key) { high_key_ = high_key; }
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  // replace with your own code
-  if (index < 1) {
-    throw Exception("Index must be non-zero");
-  }
-  if (index > GetMaxSize()) {
-    throw Exception(ExceptionType::OUT_OF_RANGE, "index > max size");
-  }
-  auto tmp = array_;
-  for (int i = 1; i < index; ++i) {
-    ++tmp;
-  }
-  KeyType key = tmp->first;
-  return key;
-}
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
-  // replace with your own code
-  if (index < 1) {
-    throw Exception("Index must be non-zero");
-  }
-  if (index > GetMaxSize()) {
-    throw Exception(ExceptionType::OUT_OF_RANGE, "index > max size");
-  }
-  auto tmp = array_;
-  for (int i = 1; i < index; ++i) {
-    ++tmp;
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+
+/*
+ * Helper method to find and return array index(or offset), so that its value
+ * equals to input "value"
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  for (int i = 0; i < GetSize(); i++) {
+    if (array_[i].second == value) {
+      return i;
+    }
   }
-  tmp->first = key;
+  return -1;
 }
 
 /*
@@ -71,18 +74,124 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { 
-  if (index < 1) {
-    throw Exception("Index must be non-zero");
-  }
-  if (index > GetMaxSize()) {
-    throw Exception(ExceptionType::OUT_OF_RANGE, "index > max size");
-  }
-  auto tmp = array_;
-  for (int i = 1; i < index; ++i) {
-    ++tmp;
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+/*
+ * Find the last key that is not greater than `key`, skipping the invalid first key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ChildIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  return BPlusTreeKeySearch<KeyType, KeyComparator>::UpperBound(array_, 1, GetSize(), key, comparator) - 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType {
+  return array_[ChildIndex(key, comparator)].second;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) {
+  array_[0].second = old_value;
+  array_[1] = MappingType(new_key, new_value);
+  SetSize(2);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) -> int {
+  int index = ValueIndex(old_value) + 1;
+  std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[index] = MappingType(new_key, new_value);
+  IncreaseSize(1);
+  return GetSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SplitInsert(BPlusTreeInternalPage *recipient, const ValueType &old_value,
+                                                 const KeyType &new_key, const ValueType &new_value) {
+  // The page has no room for max_size + 1 entries, so move the tail out first and insert into whichever half the
+  // new entry belongs to. The left half ends up with ceil((size + 1) / 2) children.
+  int size = GetSize();
+  int pos = ValueIndex(old_value) + 1;
+  int keep = (size + 2) / 2;
+  if (pos < keep) {
+    std::copy(array_ + keep - 1, array_ + size, recipient->array_);
+    recipient->SetSize(size - keep + 1);
+    SetSize(keep - 1);
+    InsertNodeAfter(old_value, new_key, new_value);
+  } else {
+    std::copy(array_ + keep, array_ + size, recipient->array_);
+    recipient->SetSize(size - keep);
+    SetSize(keep);
+    int index = pos - keep;
+    std::move_backward(recipient->array_ + index, recipient->array_ + recipient->GetSize(),
+                       recipient->array_ + recipient->GetSize() + 1);
+    recipient->array_[index] = MappingType(new_key, new_value);
+    recipient->IncreaseSize(1);
   }
-  return tmp->second; 
+  // The recipient takes over this page's place in the sibling chain; the caller links this page to it.
+  recipient->SetNextPageId(next_page_id_);
+  recipient->SetHighKey(high_key_);
+  SetHighKey(recipient->array_[0].first);
+}
+
+/*****************************************************************************
+ * REMOVE / MERGE / REDISTRIBUTE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
+  std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
+  IncreaseSize(-1);
+}
+
+/*
+ * Append every child to the recipient (the left sibling). The separator comes down from the parent and becomes the
+ * key of this page's first child.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key) {
+  array_[0].first = middle_key;
+  std::copy(array_, array_ + GetSize(), recipient->array_ + recipient->GetSize());
+  recipient->IncreaseSize(GetSize());
+  recipient->SetNextPageId(next_page_id_);
+  recipient->SetHighKey(high_key_);
+  SetSize(0);
+}
+
+/*
+ * Rotate the first child into the left sibling. Afterwards KeyAt(0) of this page holds the new separator.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key) {
+  recipient->array_[recipient->GetSize()] = MappingType(middle_key, array_[0].second);
+  recipient->IncreaseSize(1);
+  std::move(array_ + 1, array_ + GetSize(), array_);
+  IncreaseSize(-1);
+  recipient->SetHighKey(array_[0].first);
+}
+
+/*
+ * Rotate the last child into the right sibling. Afterwards KeyAt(0) of the recipient holds the new separator.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key) {
+  std::move_backward(recipient->array_, recipient->array_ + recipient->GetSize(),
+                     recipient->array_ + recipient->GetSize() + 1);
+  recipient->array_[1].first = middle_key;
+  recipient->array_[0] = array_[GetSize() - 1];
+  recipient->IncreaseSize(1);
+  IncreaseSize(-1);
+  SetHighKey(recipient->array_[0].first);
 }
 
 // valuetype for internalNode should be page id_t
@@ -91,4 +200,9 @@ template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, MemcmpComparator<4>>;
+template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, MemcmpComparator<8>>;
+template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, MemcmpComparator<16>>;
+template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, MemcmpComparator<32>>;
+template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, MemcmpComparator<64>>;
 }  // namespace bustub
@@ -18,7 +18,7 @@ namespace bustub {
  * Page type enum class is defined in b_plus_tree_page.h
  */
 auto BPlusTreePage::IsLeafPage() const -> bool { return IndexPageType::LEAF_PAGE == page_type_; }
-void BPlusTreePage::SetPageType(IndexPageType page_type) {  page_type_ = page_type; }
+void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_type; }
 
 /*
  * Helper methods to get/set size (number of key/value pairs stored in that
@@ -26,21 +26,19 @@ void BPlusTreePage::SetPageType(IndexPageType page_type) {  page_type_ = page_ty
  */
 auto BPlusTreePage::GetSize() const -> int { return size_; }
 void BPlusTreePage::SetSize(int size) { size_ = size; }
-void BPlusTreePage::IncreaseSize(int amount) {
-    size_ += amount;
-    size_ = (size_ > max_size_) ? max_size_ : size_;
-}
+void BPlusTreePage::IncreaseSize(int amount) { size_ += amount; }
 
 /*
  * Helper methods to get/set max size (capacity) of the page
  */
 auto BPlusTreePage::GetMaxSize() const -> int { return max_size_; }
-void BPlusTreePage::SetMaxSize(int size) {  max_size_ = size; }
+void BPlusTreePage::SetMaxSize(int size) { max_size_ = size; }
 
 /*
  * Helper method to get min page size
- * Generally, min page size == max page size / 2
+ * A leaf splits as soon as it reaches max size, so it keeps at least max / 2 pairs. An internal page splits only when
+ * it overflows max size, so it keeps at least ceil(max / 2) children.
  */
-auto BPlusTreePage::GetMinSize() const -> int { return max_size_ >> 1; }
+auto BPlusTreePage::GetMinSize() const -> int { return IsLeafPage() ? max_size_ / 2 : (max_size_ + 1) / 2; }
 
 }  // namespace bustub
@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_slotted_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_slotted_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+
+#include "common/exception.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+
+namespace bustub {
+
+void BPlusTreeSlottedPage::Init(IndexPageType page_type) {
+  SetPageType(page_type);
+  SetSize(0);
+  SetMaxSize(0);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
+  heap_start_ = DATA_SIZE;
+  freed_bytes_ = 0;
+}
+
+auto BPlusTreeSlottedPage::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+void BPlusTreeSlottedPage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+auto BPlusTreeSlottedPage::GetPrevPageId() const -> page_id_t { return prev_page_id_; }
+
+void BPlusTreeSlottedPage::SetPrevPageId(page_id_t prev_page_id) { prev_page_id_ = prev_page_id; }
+
+auto BPlusTreeSlottedPage::KeyAt(int index) const -> std::string_view {
+  const auto &slot = Slots()[index];
+  return {data_ + slot.offset_, slot.length_};
+}
+
+auto BPlusTreeSlottedPage::RidAt(int index) const -> RID {
+  const auto &slot = Slots()[index];
+  return {slot.page_id_, slot.slot_num_};
+}
+
+auto BPlusTreeSlottedPage::ChildAt(int index) const -> page_id_t { return Slots()[index].page_id_; }
+
+auto BPlusTreeSlottedPage::GetFreeSpace() const -> int {
+  return heap_start_ - GetSize() * static_cast<int>(sizeof(Slot)) + freed_bytes_;
+}
+
+auto BPlusTreeSlottedPage::GetUsedSpace() const -> int { return DATA_SIZE - GetFreeSpace(); }
+
+auto BPlusTreeSlottedPage::EntrySize(int key_size) -> int { return key_size + static_cast<int>(sizeof(Slot)); }
+
+auto BPlusTreeSlottedPage::KeyIndex(std::string_view key) const -> int {
+  int lo = 0;
+  int hi = GetSize();
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (KeyAt(mid) < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+auto BPlusTreeSlottedPage::ChildIndex(std::string_view key) const -> int {
+  // the last child whose separator is not greater than `key`; the first key is ignored
+  int lo = 1;
+  int hi = GetSize();
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (KeyAt(mid) <= key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo - 1;
+}
+
+auto BPlusTreeSlottedPage::InsertRid(int index, std::string_view key, const RID &rid) -> bool {
+  return Insert(index, key, rid.GetPageId(), rid.GetSlotNum());
+}
+
+auto BPlusTreeSlottedPage::InsertChild(int index, std::string_view key, page_id_t child) -> bool {
+  return Insert(index, key, child, 0);
+}
+
+auto BPlusTreeSlottedPage::Insert(int index, std::string_view key, page_id_t page_id, uint32_t slot_num) -> bool {
+  if (static_cast<int>(key.size()) > MAX_KEY_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "index key is too long");
+  }
+  int needed = EntrySize(static_cast<int>(key.size()));
+  if (GetFreeSpace() < needed) {
+    return false;
+  }
+  int size = GetSize();
+  if (heap_start_ - size * static_cast<int>(sizeof(Slot)) < needed) {
+    Compact();
+  }
+  heap_start_ -= static_cast<int>(key.size());
+  memcpy(data_ + heap_start_, key.data(), key.size());
+  Slot *slots = Slots();
+  memmove(slots + index + 1, slots + index, (size - index) * sizeof(Slot));
+  slots[index] = {static_cast<uint16_t>(heap_start_), static_cast<uint16_t>(key.size()), page_id, slot_num};
+  IncreaseSize(1);
+  return true;
+}
+
+void BPlusTreeSlottedPage::RemoveAt(int index) {
+  Slot *slots = Slots();
+  if (slots[index].offset_ == heap_start_) {
+    heap_start_ += slots[index].length_;
+  } else {
+    freed_bytes_ += slots[index].length_;
+  }
+  memmove(slots + index, slots + index + 1, (GetSize() - index - 1) * sizeof(Slot));
+  IncreaseSize(-1);
+}
+
+void BPlusTreeSlottedPage::ClearFirstKey() {
+  Slot &slot = Slots()[0];
+  freed_bytes_ += slot.length_;
+  slot.length_ = 0;
+}
+
+void BPlusTreeSlottedPage::Compact() {
+  char heap[DATA_SIZE];
+  int heap_start = DATA_SIZE;
+  Slot *slots = Slots();
+  for (int i = 0; i < GetSize(); i++) {
+    heap_start -= slots[i].length_;
+    memcpy(heap + heap_start, data_ + slots[i].offset_, slots[i].length_);
+    slots[i].offset_ = static_cast<uint16_t>(heap_start);
+  }
+  memcpy(data_ + heap_start, heap + heap_start, DATA_SIZE - heap_start);
+  heap_start_ = heap_start;
+  freed_bytes_ = 0;
+}
+
+void BPlusTreeSlottedPage::MoveHalfTo(BPlusTreeSlottedPage *recipient) {
+  int size = GetSize();
+  int total = 0;
+  for (int i = 0; i < size; i++) {
+    total += static_cast<int>(KeyAt(i).size() + sizeof(Slot));
+  }
+  // keep at least one entry here and move at least one
+  int split = size - 1;
+  int moved = static_cast<int>(KeyAt(split).size() + sizeof(Slot));
+  while (split > 1 && moved < total / 2) {
+    split--;
+    moved += static_cast<int>(KeyAt(split).size() + sizeof(Slot));
+  }
+  for (int i = split; i < size; i++) {
+    const auto &slot = Slots()[i];
+    recipient->Insert(i - split, KeyAt(i), slot.page_id_, slot.slot_num_);
+  }
+  SetSize(split);
+  Compact();
+}
+
+void BPlusTreeSlottedPage::MoveAllTo(BPlusTreeSlottedPage *recipient, std::string_view middle_key) {
+  int base = recipient->GetSize();
+  for (int i = 0; i < GetSize(); i++) {
+    const auto &slot = Slots()[i];
+    recipient->Insert(base + i, i == 0 && !IsLeafPage() ? middle_key : KeyAt(i), slot.page_id_, slot.slot_num_);
+  }
+  SetSize(0);
+  Compact();
+}
+
+}  // namespace bustub
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_header_page.cpp
+//
+// Identification: src/storage/page/extendible_hash_table_header_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/extendible_hash_table_header_page.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void ExtendibleHashTableHeaderPage::Init(page_id_t page_id, uint32_t max_depth) {
+  assert(max_depth <= HEADER_MAX_DEPTH);
+  page_id_ = page_id;
+  lsn_ = INVALID_LSN;
+  max_depth_ = max_depth;
+  std::fill(directory_page_ids_, directory_page_ids_ + HEADER_ARRAY_SIZE, INVALID_PAGE_ID);
+}
+
+auto ExtendibleHashTableHeaderPage::GetPageId() const -> page_id_t { return page_id_; }
+
+auto ExtendibleHashTableHeaderPage::GetLSN() const -> lsn_t { return lsn_; }
+
+void ExtendibleHashTableHeaderPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+auto ExtendibleHashTableHeaderPage::HashToDirectoryIndex(uint32_t hash) const -> uint32_t {
+  // shifting a 32-bit value by 32 is undefined, so depth 0 is its own case
+  return max_depth_ == 0 ? 0 : hash >> (32 - max_depth_);
+}
+
+auto ExtendibleHashTableHeaderPage::GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t {
+  return directory_page_ids_[directory_idx];
+}
+
+void ExtendibleHashTableHeaderPage::SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id) {
+  directory_page_ids_[directory_idx] = directory_page_id;
+}
+
+auto ExtendibleHashTableHeaderPage::GetMaxDepth() const -> uint32_t { return max_depth_; }
+
+auto ExtendibleHashTableHeaderPage::MaxSize() const -> uint32_t { return 1U << max_depth_; }
+
+}  // namespace bustub
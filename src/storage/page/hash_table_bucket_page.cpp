@@ -10,6 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <iterator>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "storage/page/hash_table_bucket_page.h"
 #include "common/logger.h"
 #include "common/util/hash_util.h"
@@ -20,62 +27,148 @@
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::GroupBits(const char *bitmap, uint32_t group) -> uint32_t {
+  static_assert(BUCKET_GROUP_SIZE == 16, "a group spans two bitmap bytes");
+  return static_cast<uint8_t>(bitmap[group * 2]) | static_cast<uint32_t>(static_cast<uint8_t>(bitmap[group * 2 + 1]))
+                                                       << 8;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::MatchFingerprint(uint32_t group, uint8_t fingerprint) const -> uint32_t {
+  const uint8_t *fingerprints = fingerprints_ + group * BUCKET_GROUP_SIZE;
+#ifdef __SSE2__
+  __m128i probe = _mm_set1_epi8(static_cast<char>(fingerprint));
+  __m128i stored = _mm_loadu_si128(reinterpret_cast<const __m128i *>(fingerprints));
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(stored, probe)));
+#else
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < BUCKET_GROUP_SIZE; i++) {
+    mask |= static_cast<uint32_t>(fingerprints[i] == fingerprint) << i;
+  }
+  return mask;
+#endif
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, uint32_t hash,
+                                      std::vector<ValueType> *result) const -> bool {
+  uint8_t fingerprint = Fingerprint(hash);
+  bool found = false;
+  // slots are taken in order and never freed, so the first group with nothing occupied ends the scan
+  for (uint32_t group = 0; group < BUCKET_ARRAY_SIZE / BUCKET_GROUP_SIZE && GroupBits(occupied_, group) != 0;
+       group++) {
+    uint32_t candidates = MatchFingerprint(group, fingerprint) & GroupBits(readable_, group);
+    for (; candidates != 0; candidates &= candidates - 1) {
+      uint32_t bucket_idx = group * BUCKET_GROUP_SIZE + __builtin_ctz(candidates);
+      if (cmp(key, array_[bucket_idx].first) == 0) {
+        result->push_back(array_[bucket_idx].second);
+        found = true;
+      }
+    }
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp, uint32_t hash) -> bool {
+  uint8_t fingerprint = Fingerprint(hash);
+  uint32_t free_idx = BUCKET_ARRAY_SIZE;
+  for (uint32_t group = 0; group < BUCKET_ARRAY_SIZE / BUCKET_GROUP_SIZE; group++) {
+    uint32_t readable = GroupBits(readable_, group);
+    if (free_idx == BUCKET_ARRAY_SIZE && readable != 0xFFFF) {
+      // the first unreadable slot is either a tombstone or the first never-occupied slot
+      free_idx = group * BUCKET_GROUP_SIZE + __builtin_ctz(~readable);
+    }
+    if (GroupBits(occupied_, group) == 0) {
+      break;
+    }
+    uint32_t candidates = MatchFingerprint(group, fingerprint) & readable;
+    for (; candidates != 0; candidates &= candidates - 1) {
+      uint32_t bucket_idx = group * BUCKET_GROUP_SIZE + __builtin_ctz(candidates);
+      if (cmp(key, array_[bucket_idx].first) == 0 && value == array_[bucket_idx].second) {
+        return false;
+      }
+    }
+  }
+  if (free_idx == BUCKET_ARRAY_SIZE) {
+    return false;
+  }
+  array_[free_idx] = MappingType(key, value);
+  fingerprints_[free_idx] = fingerprint;
+  SetOccupied(free_idx);
+  SetReadable(free_idx);
   return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp, uint32_t hash) -> bool {
+  uint8_t fingerprint = Fingerprint(hash);
+  for (uint32_t group = 0; group < BUCKET_ARRAY_SIZE / BUCKET_GROUP_SIZE && GroupBits(occupied_, group) != 0;
+       group++) {
+    uint32_t candidates = MatchFingerprint(group, fingerprint) & GroupBits(readable_, group);
+    for (; candidates != 0; candidates &= candidates - 1) {
+      uint32_t bucket_idx = group * BUCKET_GROUP_SIZE + __builtin_ctz(candidates);
+      if (cmp(key, array_[bucket_idx].first) == 0 && value == array_[bucket_idx].second) {
+        RemoveAt(bucket_idx);
+        return true;
+      }
+    }
+  }
   return false;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::KeyAt(uint32_t bucket_idx) const -> KeyType {
-  return {};
+  return array_[bucket_idx].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::ValueAt(uint32_t bucket_idx) const -> ValueType {
-  return {};
+  return array_[bucket_idx].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] &= static_cast<char>(~(1 << (bucket_idx % 8)));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsOccupied(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (occupied_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {
+  occupied_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsReadable(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (readable_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::IsFull() -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::IsFull() const -> bool {
+  return NumReadable() == BUCKET_ARRAY_SIZE;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::NumReadable() -> uint32_t {
-  return 0;
+auto HASH_TABLE_BUCKET_TYPE::NumReadable() const -> uint32_t {
+  uint32_t count = 0;
+  for (char bits : readable_) {
+    count += __builtin_popcount(static_cast<uint8_t>(bits));
+  }
+  return count;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_BUCKET_TYPE::IsEmpty() -> bool {
-  return false;
+auto HASH_TABLE_BUCKET_TYPE::IsEmpty() const -> bool {
+  return std::all_of(std::begin(readable_), std::end(readable_), [](char bits) { return bits == 0; });
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -3,92 +3,92 @@
 
 namespace bustub {
 
-BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept 
-  :bpm_(nullptr), page_(nullptr) {
-  bpm_ = that.bpm_;
-  page_ = that.page_;
+BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept
+    : bpm_(that.bpm_), page_(that.page_), is_dirty_(that.is_dirty_) {
   that.bpm_ = nullptr;
   that.page_ = nullptr;
+  that.is_dirty_ = false;
 }
 
 void BasicPageGuard::Drop() {
-  bpm_->UnpinPage(page_->GetPageId(), page_->IsDirty());
+  if (bpm_ != nullptr && page_ != nullptr) {
+    bpm_->UnpinPage(page_->GetPageId(), is_dirty_);
+  }
   bpm_ = nullptr;
   page_ = nullptr;
+  is_dirty_ = false;
 }
 
 auto BasicPageGuard::operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard & {
-  // NOTE: !!! avoid self assignment
   if (this != &that) {
-    this->Drop();
+    Drop();
     bpm_ = that.bpm_;
     page_ = that.page_;
-    that.Drop();
+    is_dirty_ = that.is_dirty_;
+    that.bpm_ = nullptr;
+    that.page_ = nullptr;
+    that.is_dirty_ = false;
   }
   return *this;
 }
 
-BasicPageGuard::~BasicPageGuard() {
+BasicPageGuard::~BasicPageGuard() { Drop(); }  // NOLINT
+
+auto BasicPageGuard::UpgradeRead() -> ReadPageGuard {
   if (page_ != nullptr) {
-    Drop();
+    page_->RLatch();
+  }
+  ReadPageGuard guard;
+  guard.guard_ = std::move(*this);
+  return guard;
+}
+
+auto BasicPageGuard::UpgradeWrite() -> WritePageGuard {
+  if (page_ != nullptr) {
+    page_->WLatch();
   }
-}  // NOLINT
-
-ReadPageGuard::ReadPageGuard(ReadPageGuard &&that) noexcept 
-  : guard_() {
-  guard_.bpm_ = that.guard_.bpm_;
-  guard_.page_ = that.guard_.page_;
-  that.guard_.bpm_ = nullptr;
-  that.guard_.page_ = nullptr;
+  WritePageGuard guard;
+  guard.guard_ = std::move(*this);
+  return guard;
 }
 
+ReadPageGuard::ReadPageGuard(ReadPageGuard &&that) noexcept = default;
+
 auto ReadPageGuard::operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard & {
   if (this != &that) {
-    guard_.Drop();
-    guard_.bpm_ = that.guard_.bpm_;
-    guard_.page_ = that.guard_.page_;
-    that.Drop();
+    Drop();
+    guard_ = std::move(that.guard_);
   }
   return *this;
 }
 
 void ReadPageGuard::Drop() {
-  guard_.page_->RUnlatch();
+  // Release the latch before the pin: once unpinned the frame may be reused for another page.
+  if (guard_.page_ != nullptr) {
+    guard_.page_->RUnlatch();
+  }
   guard_.Drop();
 }
 
-ReadPageGuard::~ReadPageGuard() {
-  if (guard_.page_ != nullptr) {
-    guard_.Drop();
-  }
-}  // NOLINT
+ReadPageGuard::~ReadPageGuard() { Drop(); }  // NOLINT
 
-WritePageGuard::WritePageGuard(WritePageGuard &&that) noexcept {
-  guard_.bpm_ = that.guard_.bpm_;
-  guard_.page_ = that.guard_.page_;
-  that.guard_.bpm_ = nullptr;
-  that.guard_.page_ = nullptr;
-}
+WritePageGuard::WritePageGuard(WritePageGuard &&that) noexcept = default;
 
 auto WritePageGuard::operator=(WritePageGuard &&that) noexcept -> WritePageGuard & {
   if (this != &that) {
-    this->Drop();
-    guard_.bpm_ = that.guard_.bpm_;
-    guard_.page_ = that.guard_.page_;
-    that.Drop();
+    Drop();
+    guard_ = std::move(that.guard_);
   }
   return *this;
 }
 
 void WritePageGuard::Drop() {
-  guard_.page_->WUnlatch();
+  if (guard_.page_ != nullptr) {
+    guard_.page_->WUnlatch();
+  }
   guard_.Drop();
 }
 
-WritePageGuard::~WritePageGuard() {
-  if (guard_.page_ != nullptr) {
-    guard_.Drop();
-  }
-}  // NOLINT
+WritePageGuard::~WritePageGuard() { Drop(); }  // NOLINT
 
 }  // namespace bustub
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util_test.cpp
+//
+// Identification: test/common/hash_util_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "container/hash/hash_function.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, HashBytesTest) {
+  std::string bytes(300, 'x');
+  std::unordered_set<hash_t> hashes;
+  // Every prefix length goes through a different mix of the short and long paths
+  for (size_t length = 0; length <= bytes.size(); length++) {
+    auto hash = HashUtil::HashBytes(bytes.data(), length);
+    EXPECT_EQ(hash, HashUtil::HashBytes(bytes.data(), length));
+    EXPECT_TRUE(hashes.insert(hash).second) << "length " << length;
+  }
+
+  // Flipping any single byte changes the hash
+  for (size_t length : {1, 3, 4, 7, 8, 15, 16, 17, 48, 49, 100}) {
+    auto original = HashUtil::HashBytes(bytes.data(), length);
+    for (size_t i = 0; i < length; i++) {
+      auto flipped = bytes;
+      flipped[i] = 'y';
+      EXPECT_NE(original, HashUtil::HashBytes(flipped.data(), length)) << "length " << length << ", byte " << i;
+    }
+  }
+
+  auto varchar = ValueFactory::GetVarcharValue("bustub");
+  auto same_varchar = ValueFactory::GetVarcharValue(std::string("bustub"));
+  auto other_varchar = ValueFactory::GetVarcharValue("bustuc");
+  EXPECT_EQ(HashUtil::HashValue(&varchar), HashUtil::HashValue(&same_varchar));
+  EXPECT_NE(HashUtil::HashValue(&varchar), HashUtil::HashValue(&other_varchar));
+  auto integer = ValueFactory::GetIntegerValue(42);
+  auto bigint = ValueFactory::GetBigIntValue(42);
+  EXPECT_EQ(HashUtil::HashValue(&integer), HashUtil::HashValue(&bigint));
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, HashFunctionSpreadTest) {
+  // Hash tables take their bucket bits from either end of the hash; sequential keys must spread over both
+  const int num_keys = 1 << 16;
+  const int num_buckets = 256;
+  HashFunction<int> fast;
+  HashFunction<int, MurmurHash3Policy> murmur;
+  std::vector<int> low_buckets(num_buckets);
+  std::vector<int> high_buckets(num_buckets);
+  for (int key = 0; key < num_keys; key++) {
+    auto hash = fast.GetHash(key);
+    EXPECT_EQ(hash, HashUtil::HashBytes(reinterpret_cast<const char *>(&key), sizeof(key)));
+    EXPECT_NE(hash, murmur.GetHash(key));
+    low_buckets[hash % num_buckets]++;
+    high_buckets[hash >> 56]++;
+  }
+  const int expected = num_keys / num_buckets;
+  for (int i = 0; i < num_buckets; i++) {
+    EXPECT_GT(low_buckets[i], expected / 2);
+    EXPECT_LT(low_buckets[i], expected * 2);
+    EXPECT_GT(high_buckets[i], expected / 2);
+    EXPECT_LT(high_buckets[i], expected * 2);
+  }
+}
+
+}  // namespace bustub
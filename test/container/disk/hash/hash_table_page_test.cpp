@@ -17,13 +17,14 @@
 #include "common/logger.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/page/extendible_hash_table_header_page.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
+TEST(HashTablePageTest, DirectoryPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -56,7 +57,47 @@ TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
+TEST(HashTablePageTest, HeaderPageSampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  // get a header page from the BufferPoolManager
+  page_id_t header_page_id = INVALID_PAGE_ID;
+  auto header_page = reinterpret_cast<ExtendibleHashTableHeaderPage *>(bpm->NewPage(&header_page_id)->GetData());
+  header_page->Init(header_page_id, 2);
+  EXPECT_EQ(header_page_id, header_page->GetPageId());
+  EXPECT_EQ(4, header_page->MaxSize());
+
+  // the top two hash bits pick the directory
+  EXPECT_EQ(0, header_page->HashToDirectoryIndex(0x00000000));
+  EXPECT_EQ(0, header_page->HashToDirectoryIndex(0x3FFFFFFF));
+  EXPECT_EQ(1, header_page->HashToDirectoryIndex(0x40000000));
+  EXPECT_EQ(2, header_page->HashToDirectoryIndex(0x80000001));
+  EXPECT_EQ(3, header_page->HashToDirectoryIndex(0xFFFFFFFF));
+
+  for (unsigned i = 0; i < header_page->MaxSize(); i++) {
+    EXPECT_EQ(INVALID_PAGE_ID, header_page->GetDirectoryPageId(i));
+    header_page->SetDirectoryPageId(i, i + 10);
+  }
+  for (unsigned i = 0; i < header_page->MaxSize(); i++) {
+    EXPECT_EQ(i + 10, header_page->GetDirectoryPageId(i));
+  }
+
+  // a header of depth 0 sends everything to one directory
+  header_page->Init(header_page_id, 0);
+  EXPECT_EQ(1, header_page->MaxSize());
+  EXPECT_EQ(0, header_page->HashToDirectoryIndex(0xFFFFFFFF));
+
+  // unpin the header page now that we are done
+  bpm->UnpinPage(header_page_id, true);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -68,7 +109,7 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
 
   // insert a few (key, value) pairs
   for (unsigned i = 0; i < 10; i++) {
-    assert(bucket_page->Insert(i, i, IntComparator()));
+    assert(bucket_page->Insert(i, i, IntComparator(), i));
   }
 
   // check for the inserted pairs
@@ -80,7 +121,7 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   // remove a few pairs
   for (unsigned i = 0; i < 10; i++) {
     if (i % 2 == 1) {
-      assert(bucket_page->Remove(i, i, IntComparator()));
+      assert(bucket_page->Remove(i, i, IntComparator(), i));
     }
   }
 
@@ -101,7 +142,7 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   // try to remove the already-removed pairs
   for (unsigned i = 0; i < 10; i++) {
     if (i % 2 == 1) {
-      assert(!bucket_page->Remove(i, i, IntComparator()));
+      assert(!bucket_page->Remove(i, i, IntComparator(), i));
     }
   }
 
@@ -113,4 +154,50 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageFingerprintTest) {
+  // BUCKET_ARRAY_SIZE is sized from these
+  using KeyType = int;
+  using ValueType = int;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  auto bucket_page =
+      reinterpret_cast<HashTableBucketPage<int, int, IntComparator> *>(bpm->NewPage(&bucket_page_id)->GetData());
+
+  // fill the bucket; every even key shares one fingerprint, so only the comparator tells them apart
+  const uint32_t same_hash = 0xABCDE;
+  auto hash_of = [same_hash](int key) { return key % 2 == 0 ? same_hash : static_cast<uint32_t>(key) << 12; };
+  for (int i = 0; i < static_cast<int>(BUCKET_ARRAY_SIZE); i++) {
+    ASSERT_TRUE(bucket_page->Insert(i, i, IntComparator(), hash_of(i)));
+  }
+  EXPECT_TRUE(bucket_page->IsFull());
+  EXPECT_FALSE(bucket_page->Insert(-1, -1, IntComparator(), hash_of(-1)));
+
+  for (int i = 0; i < static_cast<int>(BUCKET_ARRAY_SIZE); i++) {
+    std::vector<int> result;
+    ASSERT_TRUE(bucket_page->GetValue(i, IntComparator(), hash_of(i), &result));
+    ASSERT_EQ(1, result.size());
+    EXPECT_EQ(i, result[0]);
+  }
+
+  // a probe whose fingerprint matches no slot finds nothing even though the key is there
+  std::vector<int> result;
+  EXPECT_FALSE(bucket_page->GetValue(0, IntComparator(), same_hash ^ (1U << 12), &result));
+
+  // removing frees a slot in the middle, which the next insert reuses
+  ASSERT_TRUE(bucket_page->Remove(20, 20, IntComparator(), hash_of(20)));
+  EXPECT_FALSE(bucket_page->GetValue(20, IntComparator(), hash_of(20), &result));
+  ASSERT_TRUE(bucket_page->Insert(-2, -2, IntComparator(), hash_of(-2)));
+  EXPECT_EQ(-2, bucket_page->KeyAt(20));
+  EXPECT_TRUE(bucket_page->IsFull());
+
+  bpm->UnpinPage(bucket_page_id, true);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
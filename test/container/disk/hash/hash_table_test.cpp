@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
+#include <memory>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -18,13 +20,14 @@
 #include "container/disk/hash/disk_extendible_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(50, disk_manager);
   DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
@@ -117,4 +120,96 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, SplitMergeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), HashFunction<int>());
+
+  // enough pairs to split buckets many times over, two values per key
+  const int scale = 20000;
+  for (int i = 0; i < scale; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    ASSERT_TRUE(ht.Insert(nullptr, i, -i - 1));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_GT(ht.GetGlobalDepth(), 4);
+  for (int i = 0; i < scale; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(2, res.size());
+  }
+
+  // emptied buckets merge back into their split images and the directory shrinks
+  for (int i = 0; i < scale; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+    ASSERT_TRUE(ht.Remove(nullptr, i, -i - 1));
+    ASSERT_FALSE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(ht.GetGlobalDepth(), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, MultiDirectoryTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  // four directories; one alone tops out at DIRECTORY_ARRAY_SIZE buckets, fewer keys than this
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), HashFunction<int>(), 2);
+
+  const int scale = 300000;
+  for (int i = 0; i < scale; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  for (int i = 0; i < scale; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(1, res.size());
+    ASSERT_EQ(i, res[0]);
+  }
+
+  for (int i = 0; i < scale; i++) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(ht.GetGlobalDepth(), 0);
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 0, &res));
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentInsertLookupTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), HashFunction<int>());
+
+  // writers split buckets while readers look up the keys that are already in
+  const int num_threads = 4;
+  const int keys_per_thread = 5000;
+  std::atomic<int> lookups_failed{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&ht, t]() {
+      for (int i = t; i < num_threads * keys_per_thread; i += num_threads) {
+        ht.Insert(nullptr, i, i);
+      }
+    });
+    threads.emplace_back([&ht, &lookups_failed, t]() {
+      for (int i = t; i < num_threads * keys_per_thread; i += num_threads) {
+        std::vector<int> res;
+        while (!ht.GetValue(nullptr, i, &res)) {
+          std::this_thread::yield();
+        }
+        lookups_failed += res.size() == 1 && res[0] == i ? 0 : 1;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(lookups_failed, 0);
+  ht.VerifyIntegrity();
+}
+
 }  // namespace bustub
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table_test.cpp
+//
+// Identification: test/container/disk/hash/linear_probe_hash_table_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/disk/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, SampleTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), 1000, HashFunction<int>());
+
+  // insert a few values, two per key
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i + 100));
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 0; i < 5; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(2, res.size());
+  }
+
+  // remove one value per key; the tombstones must not hide the other
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(2 * i + 100, res[0]);
+  }
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 5, &res));
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, IncrementalResizeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), 1, HashFunction<int>());
+  size_t initial_size = ht.GetSize();
+
+  // grow through several resizes, checking keys from before the last one while it is still draining
+  const int scale = 20000;
+  for (int i = 0; i < scale; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, i, i));
+    ASSERT_FALSE(ht.Insert(nullptr, i / 2, i / 2));
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i / 3, &res));
+    ASSERT_EQ(1, res.size());
+    ASSERT_EQ(i / 3, res[0]);
+  }
+  EXPECT_GE(ht.GetSize(), 2 * scale);
+  EXPECT_GT(ht.GetSize(), 8 * initial_size);
+
+  for (int i = 0; i < scale; i += 2) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < scale; i++) {
+    std::vector<int> res;
+    ASSERT_EQ(i % 2 == 1, ht.GetValue(nullptr, i, &res));
+  }
+
+  // an explicit resize drains any migration in progress and starts another
+  size_t size = ht.GetSize();
+  ht.Resize(size);
+  EXPECT_GE(ht.GetSize(), 2 * size);
+  for (int i = 1; i < scale; i += 2) {
+    ASSERT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < scale; i++) {
+    std::vector<int> res;
+    ASSERT_FALSE(ht.GetValue(nullptr, i, &res));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, TombstoneReuseTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), 1000, HashFunction<int>());
+  size_t size = ht.GetSize();
+
+  // churn far more entries through the table than it has slots; each insert takes back a tombstone on its chain,
+  // so the table never fills up with them and never grows
+  const int keys = 100;
+  for (int round = 0; round < 100; round++) {
+    for (int i = 0; i < keys; i++) {
+      ASSERT_TRUE(ht.Insert(nullptr, i, round));
+    }
+    for (int i = 0; i < keys; i++) {
+      std::vector<int> res;
+      ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+      ASSERT_EQ(1, res.size());
+      ASSERT_EQ(round, res[0]);
+      ASSERT_TRUE(ht.Remove(nullptr, i, round));
+    }
+  }
+  EXPECT_EQ(size, ht.GetSize());
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, ConcurrentInsertLookupTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), 1, HashFunction<int>());
+
+  // the writer keeps the table resizing while the reader looks up keys already inserted
+  const int scale = 10000;
+  std::atomic<int> inserted{0};
+  std::thread writer([&]() {
+    for (int i = 0; i < scale; i++) {
+      ht.Insert(nullptr, i, i);
+      inserted = i + 1;
+    }
+  });
+  int lookups_failed = 0;
+  for (int i = 0; i < scale; i++) {
+    while (inserted.load() <= i) {
+      std::this_thread::yield();
+    }
+    std::vector<int> res;
+    lookups_failed += ht.GetValue(nullptr, i, &res) && res.size() == 1 && res[0] == i ? 0 : 1;
+  }
+  writer.join();
+  EXPECT_EQ(lookups_failed, 0);
+}
+
+}  // namespace bustub
@@ -0,0 +1,160 @@
+#include <fmt/format.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <map>
+#include <mutex>   // NOLINT
+#include <optional>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "primer/trie.h"
+#include "primer/trie_store.h"
+
+namespace bustub {
+
+namespace {
+
+const int NUM_READERS = 4;
+const uint32_t NUM_KEYS = 1000;
+const auto RUN_TIME = std::chrono::milliseconds(1000);
+const uint32_t BULK_KEYS = 100000;
+
+// The store as it was before readers went lock-free: every read copies the root under a mutex
+class LockedTrieStore {
+ public:
+  auto Get(std::string_view key) -> std::optional<uint32_t> {
+    Trie root;
+    {
+      std::lock_guard lock(root_lock_);
+      root = root_;
+    }
+    const auto *value = root.Get<uint32_t>(key);
+    return value == nullptr ? std::nullopt : std::make_optional(*value);
+  }
+
+  void Put(std::string_view key, uint32_t value) {
+    std::lock_guard write_lock(write_lock_);
+    Trie root;
+    {
+      std::lock_guard lock(root_lock_);
+      root = root_;
+    }
+    root = root.Put<uint32_t>(key, value);
+    std::lock_guard lock(root_lock_);
+    root_ = root;
+  }
+
+ private:
+  std::mutex root_lock_;
+  std::mutex write_lock_;
+  Trie root_;
+};
+
+auto Key(uint32_t i) -> std::string { return fmt::format("key-{:05}", i); }
+
+/**
+ * One writer keeps overwriting the keys and then "latest" with the round it finished; readers look up "latest" and a
+ * key, which must be at least as new, since it was put before. Prints reads and writes per second.
+ */
+template <class Store, class GetValue>
+void RunReadersAndWriter(const std::string &name, Store *store, GetValue get_value) {
+  for (uint32_t i = 0; i < NUM_KEYS; i++) {
+    store->Put(Key(i), 0U);
+  }
+  store->Put("latest", 0U);
+
+  std::atomic<bool> done{false};
+  std::atomic<uint64_t> reads{0};
+  uint64_t writes = 0;
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < NUM_READERS; tid++) {
+    readers.emplace_back([&, tid] {
+      uint64_t local_reads = 0;
+      uint32_t i = tid;
+      while (!done.load(std::memory_order_relaxed)) {
+        auto latest = get_value(store, "latest");
+        auto value = get_value(store, Key(i));
+        ASSERT_TRUE(latest.has_value() && value.has_value());
+        ASSERT_GE(*value, *latest);
+        i = (i + 7919) % NUM_KEYS;
+        local_reads += 2;
+      }
+      reads += local_reads;
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t round = 1; std::chrono::steady_clock::now() - start < RUN_TIME; round++) {
+    for (uint32_t i = 0; i < NUM_KEYS; i++) {
+      store->Put(Key(i), round);
+      writes++;
+    }
+    store->Put("latest", round);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  fmt::print("{:<10} {:>14.0f} {:>14.0f}\n", name, reads / seconds, writes / seconds);
+}
+
+/** Prints the keys per second `load` puts into an empty container. */
+template <class Load>
+void RunBulkLoad(const std::string &name, Load load) {
+  auto start = std::chrono::steady_clock::now();
+  load();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  fmt::print("{:<10} {:>14.0f}\n", name, BULK_KEYS / seconds);
+}
+
+}  // namespace
+
+TEST(TrieStoreBenchTest, ReadersAndWriterThroughput) {
+  fmt::print("{:<10} {:>14} {:>14}\n", "", "reads/s", "writes/s");
+  {
+    TrieStore store;
+    RunReadersAndWriter("lock-free", &store, [](TrieStore *store, std::string_view key) -> std::optional<uint32_t> {
+      auto guard = store->Get<uint32_t>(key);
+      return guard.has_value() ? std::make_optional(**guard) : std::nullopt;
+    });
+  }
+  {
+    LockedTrieStore store;
+    RunReadersAndWriter("mutex", &store,
+                        [](LockedTrieStore *store, std::string_view key) { return store->Get(key); });
+  }
+}
+
+TEST(TrieStoreBenchTest, BulkLoadThroughput) {
+  fmt::print("{:<10} {:>14}\n", "", "puts/s");
+  TrieStore store;
+  RunBulkLoad("put", [&] {
+    for (uint32_t i = 0; i < BULK_KEYS; i++) {
+      store.Put(Key(i), i);
+    }
+  });
+  TrieStore batch_store;
+  RunBulkLoad("batch", [&] {
+    TrieStore::Batch batch(&batch_store);
+    for (uint32_t i = 0; i < BULK_KEYS; i++) {
+      batch.Put(Key(i), i);
+    }
+    batch.Commit();
+  });
+  // A mutable ordered container, for reference
+  std::map<std::string, uint32_t> map;
+  RunBulkLoad("std::map", [&] {
+    for (uint32_t i = 0; i < BULK_KEYS; i++) {
+      map.emplace(Key(i), i);
+    }
+  });
+
+  for (uint32_t i = 0; i < BULK_KEYS; i++) {
+    ASSERT_EQ(**batch_store.Get<uint32_t>(Key(i)), i);
+  }
+}
+
+}  // namespace bustub
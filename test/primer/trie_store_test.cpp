@@ -5,6 +5,8 @@
 #include <optional>
 #include <random>
 #include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
@@ -121,4 +123,116 @@ TEST(TrieStoreTest, MixedConcurrentTest) {
   }
 }
 
+TEST(TrieStoreTest, BatchTest) {
+  auto store = TrieStore();
+  store.Put<uint32_t>("kept", 1);
+  store.Put<uint32_t>("removed", 2);
+  auto guard = store.Get<uint32_t>("kept");
+
+  TrieStore::Batch batch(&store);
+  for (uint32_t i = 0; i < 1000; i++) {
+    batch.Put<uint32_t>(fmt::format("{:#05}", i), i);
+  }
+  batch.Put<uint32_t>("kept", 11);
+  batch.Remove("removed");
+  batch.Remove("00500");
+
+  // Nothing is visible before the commit
+  ASSERT_EQ(store.Get<uint32_t>("00000"), std::nullopt);
+  ASSERT_EQ(**store.Get<uint32_t>("removed"), 2);
+
+  // Another writer publishes in between; the batch is applied on top of it
+  store.Put<uint32_t>("00001", 100);
+  store.Put<uint32_t>("other", 3);
+  batch.Commit();
+
+  ASSERT_EQ(**guard, 1);
+  ASSERT_EQ(**store.Get<uint32_t>("kept"), 11);
+  ASSERT_EQ(store.Get<uint32_t>("removed"), std::nullopt);
+  ASSERT_EQ(**store.Get<uint32_t>("other"), 3);
+  ASSERT_EQ(store.Get<uint32_t>("00500"), std::nullopt);
+  for (uint32_t i = 0; i < 1000; i++) {
+    if (i != 500) {
+      ASSERT_EQ(**store.Get<uint32_t>(fmt::format("{:#05}", i)), i);
+    }
+  }
+
+  // The batch goes on from what it published, without touching the nodes readers now see
+  auto published = store.Get<uint32_t>("00002");
+  batch.Put<uint32_t>("00002", 22);
+  batch.Remove("kept");
+  batch.Commit();
+  ASSERT_EQ(**published, 2);
+  ASSERT_EQ(**store.Get<uint32_t>("00002"), 22);
+  ASSERT_EQ(store.Get<uint32_t>("kept"), std::nullopt);
+  ASSERT_EQ(**store.Get<uint32_t>("00003"), 3);
+}
+
+TEST(TrieStoreTest, BatchConcurrentTest) {
+  auto store = TrieStore();
+
+  std::vector<std::thread> threads;
+
+  const int keys_per_thread = 10000;
+  const int keys_per_batch = 100;
+
+  for (int tid = 0; tid < 4; tid++) {
+    std::thread t([&store, tid] {
+      TrieStore::Batch batch(&store);
+      for (uint32_t i = 0; i < keys_per_thread; i++) {
+        std::string key = fmt::format("{:#05}", i * 4 + tid);
+        std::string value = fmt::format("value-{:#08}", i * 4 + tid);
+        batch.Put<std::string>(key, value);
+        if (i % 3 == 0) {
+          batch.Remove(key);
+        }
+        if (i % keys_per_batch == keys_per_batch - 1) {
+          batch.Commit();
+        }
+      }
+      batch.Commit();
+    });
+    threads.push_back(std::move(t));
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  for (uint32_t i = 0; i < keys_per_thread * 4; i++) {
+    std::string key = fmt::format("{:#05}", i);
+    auto guard = store.Get<std::string>(key);
+    if (i / 4 % 3 == 0) {
+      ASSERT_EQ(guard, std::nullopt);
+    } else {
+      ASSERT_EQ(**guard, fmt::format("value-{:#08}", i));
+    }
+  }
+}
+
+TEST(TrieStoreTest, ScanTest) {
+  auto store = TrieStore();
+  for (uint32_t i = 0; i < 100; i++) {
+    store.Put<uint32_t>(fmt::format("{:#03}", i), i);
+  }
+
+  // The scan goes on over the trie it started on
+  auto iter = store.Scan<uint32_t>("04");
+  store.Remove("045");
+  store.Put<uint32_t>("0455", 455);
+  for (uint32_t i = 40; i < 50; i++, ++iter) {
+    ASSERT_FALSE(iter.IsEnd());
+    ASSERT_EQ(iter.Key(), fmt::format("{:#03}", i));
+    ASSERT_EQ(*iter, i);
+  }
+  ASSERT_TRUE(iter.IsEnd());
+
+  std::vector<std::pair<std::string, const uint32_t *>> page;
+  ASSERT_EQ(store.Scan<uint32_t>("04", "044").NextBatch(&page, 3), 3);
+  ASSERT_EQ(page[0].first, "0455");
+  ASSERT_EQ(*page[0].second, 455);
+  ASSERT_EQ(page[1].first, "046");
+  ASSERT_EQ(page[2].first, "047");
+}
+
 }  // namespace bustub
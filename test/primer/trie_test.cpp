@@ -1,10 +1,13 @@
 #include <fmt/format.h>
 #include <bitset>
 #include <functional>
+#include <map>
 #include <numeric>
 #include <optional>
 #include <random>
 #include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
@@ -250,4 +253,113 @@ TEST(TrieTest, PointerStability) {
   ASSERT_EQ(reinterpret_cast<uint64_t>(ptr_before), reinterpret_cast<uint64_t>(ptr_after));
 }
 
+TEST(TrieTest, WideAndCompressedTest) {
+  // Keys share prefixes of any length and then fan out over all byte values, so that nodes grow through every child
+  // layout and back, and compressed prefixes are split by puts and merged again by removes
+  const std::string common = "a/common/prefix";
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<int> dis(0, 255);
+  std::map<std::string, uint32_t> expected;
+  std::vector<std::string> keys;
+  std::vector<std::pair<Trie, std::map<std::string, uint32_t>>> snapshots;
+  auto trie = Trie();
+  for (uint32_t i = 0; i < 30000; i++) {
+    std::string key = common.substr(0, dis(gen) % (common.size() + 1));
+    for (int length = dis(gen) % 4; length > 0; length--) {
+      key += static_cast<char>(dis(gen) % 2 == 0 ? dis(gen) : 'a' + dis(gen) % 3);
+    }
+    if (dis(gen) % 3 == 0) {
+      trie = trie.Remove(key);
+      expected.erase(key);
+    } else {
+      trie = trie.Put<uint32_t>(key, i);
+      expected[key] = i;
+    }
+    keys.push_back(std::move(key));
+    if (i % 5000 == 0) {
+      snapshots.emplace_back(trie, expected);
+    }
+  }
+  // Drain most of it again, so that wide nodes shrink
+  for (size_t i = 0; i < keys.size(); i += 2) {
+    trie = trie.Remove(keys[i]);
+    expected.erase(keys[i]);
+  }
+  snapshots.emplace_back(trie, expected);
+
+  for (const auto &[snapshot, snapshot_expected] : snapshots) {
+    for (const auto &key : keys) {
+      auto iter = snapshot_expected.find(key);
+      const auto *value = snapshot.Get<uint32_t>(key);
+      if (iter == snapshot_expected.end()) {
+        ASSERT_EQ(value, nullptr);
+      } else {
+        ASSERT_NE(value, nullptr);
+        ASSERT_EQ(*value, iter->second);
+      }
+    }
+  }
+}
+
+TEST(TrieTest, ScanTest) {
+  // Keys from a small alphabet share many prefixes, so that scans start inside compressed prefixes and resume from
+  // keys that are not in the trie
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<int> dis(0, 255);
+  auto random_key = [&]() {
+    std::string key;
+    for (int length = dis(gen) % 7; length > 0; length--) {
+      key += static_cast<char>(dis(gen) % 8 == 0 ? dis(gen) : 'a' + dis(gen) % 3);
+    }
+    return key;
+  };
+  std::map<std::string, uint32_t> expected;
+  auto trie = Trie();
+  for (uint32_t i = 0; i < 2000; i++) {
+    auto key = random_key();
+    trie = trie.Put<uint32_t>(key, i);
+    expected[key] = i;
+  }
+  // Values of another type are skipped
+  trie = trie.Put<std::string>("abc-string", "skipped");
+  auto snapshot = trie;
+  trie = trie.Put<uint32_t>("abc-after-snapshot", 0);
+
+  for (int round = 0; round < 300; round++) {
+    auto prefix = random_key().substr(0, dis(gen) % 4);
+    std::optional<std::string> after;
+    if (round % 2 == 1) {
+      after = prefix + random_key();
+    }
+    std::vector<std::pair<std::string, uint32_t>> expected_keys;
+    for (const auto &[key, value] : expected) {
+      if (key.compare(0, prefix.size(), prefix) == 0 && (!after.has_value() || key > *after)) {
+        expected_keys.emplace_back(key, value);
+      }
+    }
+
+    std::vector<std::pair<std::string, uint32_t>> scanned;
+    for (auto iter = snapshot.Scan<uint32_t>(prefix, after); !iter.IsEnd(); ++iter) {
+      scanned.emplace_back(iter.Key(), *iter);
+    }
+    ASSERT_EQ(scanned, expected_keys) << "prefix " << prefix;
+
+    // Page through the same keys, resuming each page after the last key of the previous one
+    std::vector<std::pair<std::string, uint32_t>> paged;
+    std::vector<std::pair<std::string, const uint32_t *>> page;
+    std::optional<std::string> last = after;
+    do {
+      page.clear();
+      snapshot.Scan<uint32_t>(prefix, last).NextBatch(&page, 7);
+      for (const auto &[key, value] : page) {
+        paged.emplace_back(key, *value);
+      }
+      if (!page.empty()) {
+        last = page.back().first;
+      }
+    } while (!page.empty());
+    ASSERT_EQ(paged, expected_keys) << "prefix " << prefix;
+  }
+}
+
 }  // namespace bustub
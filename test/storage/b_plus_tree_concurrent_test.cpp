@@ -122,7 +122,7 @@ void LookupHelper(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree, con
   delete transaction;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
+TEST(BPlusTreeConcurrentTest, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -170,7 +170,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest2) {
+TEST(BPlusTreeConcurrentTest, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -217,7 +217,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest2) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest1) {
+TEST(BPlusTreeConcurrentTest, DeleteTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -256,7 +256,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
+TEST(BPlusTreeConcurrentTest, DeleteTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -295,7 +295,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_MixTest1) {
+TEST(BPlusTreeConcurrentTest, MixTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -336,7 +336,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_MixTest2) {
+TEST(BPlusTreeConcurrentTest, MixTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -402,4 +402,247 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest2) {
   delete bpm;
 }
 
+TEST(BPlusTreeConcurrentTest, ReverseScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  // small pages, so that writers keep splitting and merging the leaves under the scans
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 4, 4);
+
+  std::vector<int64_t> perserved_keys;
+  std::vector<int64_t> dynamic_keys;
+  int64_t sieve = 5;
+  for (int64_t i = 1; i <= 400; i++) {
+    (i % sieve == 0 ? perserved_keys : dynamic_keys).push_back(i);
+  }
+  InsertHelper(&tree, perserved_keys, 1);
+
+  // Descending scans must see every preserved key exactly once, in order, whatever the writers do.
+  auto scan_task = [&](int tid) {
+    for (int round = 0; round < 20; round++) {
+      size_t size = 0;
+      int64_t previous = INT64_MAX;
+      for (auto iter = tree.RBegin(); iter != tree.End(); ++iter) {
+        int64_t key = (*iter).first.ToString();
+        ASSERT_LT(key, previous);
+        previous = key;
+        if (key % sieve == 0) {
+          size++;
+        }
+      }
+      ASSERT_EQ(size, perserved_keys.size());
+    }
+  };
+  auto write_task = [&](int tid) {
+    for (int round = 0; round < 5; round++) {
+      InsertHelper(&tree, dynamic_keys, tid);
+      DeleteHelper(&tree, dynamic_keys, tid);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back(i % 2 == 0 ? std::function<void(int)>(scan_task) : std::function<void(int)>(write_task), i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeConcurrentTest, BLinkInsertTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // create b+ tree with small pages so that splits reach the root many times
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 3, 4,
+                                                            BPlusTreeMode::B_LINK);
+  // keys to Insert
+  std::vector<int64_t> keys;
+  int64_t scale_factor = 1000;
+  for (int64_t key = 1; key < scale_factor; key++) {
+    keys.push_back(key);
+  }
+  LaunchParallelTest(4, InsertHelperSplit, &tree, keys, 4);
+
+  std::vector<RID> rids;
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    tree.GetValue(index_key, &rids);
+    EXPECT_EQ(rids.size(), 1);
+
+    int64_t value = key & 0xFFFFFFFF;
+    EXPECT_EQ(rids[0].GetSlotNum(), value);
+  }
+
+  int64_t current_key = 1;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 1;
+  }
+  EXPECT_EQ(current_key, keys.size() + 1);
+
+  // removing everything leaves an empty tree
+  LaunchParallelTest(4, DeleteHelperSplit, &tree, keys, 4);
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_TRUE(tree.Begin() == tree.End());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeConcurrentTest, BLinkMixTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, 3, 4,
+                                                            BPlusTreeMode::B_LINK);
+
+  std::vector<int64_t> perserved_keys;
+  std::vector<int64_t> dynamic_keys;
+  int64_t total_keys = 500;
+  int64_t sieve = 5;
+  for (int64_t i = 1; i <= total_keys; i++) {
+    if (i % sieve == 0) {
+      perserved_keys.push_back(i);
+    } else {
+      dynamic_keys.push_back(i);
+    }
+  }
+  InsertHelper(&tree, perserved_keys, 1);
+
+  auto insert_task = [&](int tid) { InsertHelper(&tree, dynamic_keys, tid); };
+  auto delete_task = [&](int tid) { DeleteHelper(&tree, dynamic_keys, tid); };
+  auto lookup_task = [&](int tid) { LookupHelper(&tree, perserved_keys, tid); };
+
+  std::vector<std::thread> threads;
+  std::vector<std::function<void(int)>> tasks;
+  tasks.emplace_back(insert_task);
+  tasks.emplace_back(delete_task);
+  tasks.emplace_back(lookup_task);
+
+  size_t num_threads = 6;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back(std::thread{tasks[i % tasks.size()], i});
+  }
+  for (size_t i = 0; i < num_threads; i++) {
+    threads[i].join();
+  }
+
+  // Check all reserved keys exist, in order
+  size_t size = 0;
+  int64_t last_key = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    const auto &pair = *iter;
+    EXPECT_GT(pair.first.ToString(), last_key);
+    last_key = pair.first.ToString();
+    if ((pair.first).ToString() % sieve == 0) {
+      size++;
+    }
+  }
+
+  ASSERT_EQ(size, perserved_keys.size());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
+TEST(BPlusTreeConcurrentTest, ParallelRangeScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(256, disk_manager.get());
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator);
+  ASSERT_TRUE(tree.SplitRange(nullptr, nullptr, 8).empty());
+
+  const int64_t num_keys = 1000000;
+  std::vector<std::pair<GenericKey<8>, RID>> pairs(num_keys);
+  for (int64_t i = 0; i < num_keys; i++) {
+    pairs[i].first.SetFromInteger(i);
+    pairs[i].second.Set(0, static_cast<uint32_t>(i));
+  }
+  ASSERT_TRUE(tree.BulkLoad(std::move(pairs)));
+
+  // Scan [lower, upper] split into `partitions` sub-ranges on as many threads; every key must be seen exactly once
+  // and the sub-ranges must be of similar sizes.
+  auto check_split = [&](int64_t lower, int64_t upper, size_t partitions) {
+    GenericKey<8> lower_key;
+    GenericKey<8> upper_key;
+    lower_key.SetFromInteger(lower);
+    upper_key.SetFromInteger(upper);
+    auto boundaries = tree.SplitRange(&lower_key, &upper_key, partitions);
+    ASSERT_EQ(boundaries.size(), partitions - 1);
+    for (size_t i = 0; i < boundaries.size(); i++) {
+      ASSERT_GT(comparator(boundaries[i], i == 0 ? lower_key : boundaries[i - 1]), 0);
+      ASSERT_LE(comparator(boundaries[i], upper_key), 0);
+    }
+
+    std::vector<int64_t> counts(partitions);
+    std::vector<int64_t> sums(partitions);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < partitions; i++) {
+      threads.emplace_back([&, i] {
+        const auto *part_lower = i == 0 ? &lower_key : &boundaries[i - 1];
+        const auto *part_upper = i + 1 == partitions ? nullptr : &boundaries[i];
+        for (auto iter = tree.Begin(part_lower, part_upper == nullptr ? &upper_key : part_upper); !iter.IsEnd();
+             ++iter) {
+          if (part_upper != nullptr && comparator((*iter).first, *part_upper) == 0) {
+            break;
+          }
+          counts[i]++;
+          sums[i] += (*iter).second.GetSlotNum();
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    int64_t expected_count = upper - lower + 1;
+    int64_t count = 0;
+    int64_t sum = 0;
+    for (size_t i = 0; i < partitions; i++) {
+      ASSERT_GT(counts[i], expected_count / static_cast<int64_t>(partitions) / 2);
+      ASSERT_LT(counts[i], expected_count / static_cast<int64_t>(partitions) * 2);
+      count += counts[i];
+      sum += sums[i];
+    }
+    ASSERT_EQ(count, expected_count);
+    ASSERT_EQ(sum, (lower + upper) * expected_count / 2);
+  };
+  check_split(0, num_keys - 1, 8);
+  check_split(123456, 345678, 4);
+  check_split(500000, 900000, 16);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
+
 }  // namespace bustub
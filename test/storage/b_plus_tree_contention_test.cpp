@@ -76,6 +76,79 @@ bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool wit
   return success;
 }
 
+/**
+ * Each thread fills its own key range, then keeps removing a run of keys and putting them back. With eager merging
+ * the removals underflow leaves and restart with write latches from the root, which the other threads then wait on.
+ * Only the removal and reinsertion phase is timed, in `churn_ms`.
+ */
+bool BPlusTreeChurnBenchmarkCall(size_t num_threads, int leaf_node_size, BPlusTreeMode mode, size_t *churn_ms) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerMemory(256 << 10);  // 1GB
+  auto *bpm = new BufferPoolManager(4096, disk_manager);
+
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  bool success = true;
+  {
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm, comparator, leaf_node_size, 10,
+                                                             mode);
+    const int64_t keys_per_thread = 1000;
+    const int64_t run_length = leaf_node_size;
+    const int rounds = 10;
+    auto run_threads = [num_threads](const std::function<void(int64_t)> &func) {
+      std::vector<std::thread> threads;
+      for (size_t i = 0; i < num_threads; i++) {
+        threads.emplace_back(func, static_cast<int64_t>(i));
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+    };
+
+    run_threads([&tree, keys_per_thread](int64_t i) {
+      GenericKey<8> index_key;
+      for (int64_t key = keys_per_thread * i; key < keys_per_thread * (i + 1); key++) {
+        index_key.SetFromInteger(key);
+        tree.Insert(index_key, RID(0, key));
+      }
+    });
+    auto clock_start = std::chrono::system_clock::now();
+    run_threads([&tree, keys_per_thread, run_length, rounds](int64_t i) {
+      GenericKey<8> index_key;
+      const int64_t end_key = keys_per_thread * (i + 1);
+      for (int round = 0; round < rounds; round++) {
+        for (int64_t run = keys_per_thread * i + round; run + run_length < end_key; run += run_length * 4) {
+          for (int64_t key = run; key < run + run_length; key++) {
+            index_key.SetFromInteger(key);
+            tree.Remove(index_key, nullptr);
+          }
+          for (int64_t key = run; key < run + run_length; key++) {
+            index_key.SetFromInteger(key);
+            tree.Insert(index_key, RID(0, key));
+          }
+        }
+      }
+    });
+    auto clock_end = std::chrono::system_clock::now();
+    *churn_ms = std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start).count();
+
+    tree.Consolidate();
+    int64_t expected = 0;
+    for (auto iter = tree.Begin(); iter != tree.End(); ++iter, ++expected) {
+      success = success && (*iter).second.GetSlotNum() == expected;
+    }
+    success = success && expected == static_cast<int64_t>(keys_per_thread * num_threads);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  return success;
+}
+
 TEST(BPlusTreeContentionTest, BPlusTreeContentionBenchmark) {  // NOLINT
   std::cout << "This test will see how your B+ tree performance differs with and without contention." << std::endl;
   std::cout << "If your submission timeout, segfault, or didn't implement lock crabbing, we will manually deduct all "
@@ -168,4 +241,37 @@ TEST(BPlusTreeContentionTest, BPlusTreeContentionBenchmark2) {  // NOLINT
             << std::endl;
 }
 
+TEST(BPlusTreeContentionTest, LazyMergeChurnBenchmark) {  // NOLINT
+  std::cout << "This test compares eager and lazy merging under removals and inserts alternating around the same keys."
+            << std::endl;
+
+  std::vector<size_t> time_ms_eager;
+  std::vector<size_t> time_ms_lazy;
+  for (size_t iter = 0; iter < 6; iter++) {
+    bool lazy = iter % 2 == 1;
+    size_t churn_ms;
+    ASSERT_TRUE(BPlusTreeChurnBenchmarkCall(16, 10, lazy ? BPlusTreeMode::LAZY_MERGE : BPlusTreeMode::LATCH_CRABBING,
+                                            &churn_ms));
+    (lazy ? time_ms_lazy : time_ms_eager).push_back(churn_ms);
+  }
+
+  std::cout << "<<< BEGIN3" << std::endl;
+  double total_eager = 0;
+  double total_lazy = 0;
+  std::cout << "Eager Merge Time: ";
+  for (auto x : time_ms_eager) {
+    std::cout << x << " ";
+    total_eager += x;
+  }
+  std::cout << std::endl;
+  std::cout << "Lazy Merge Time: ";
+  for (auto x : time_ms_lazy) {
+    std::cout << x << " ";
+    total_lazy += x;
+  }
+  std::cout << std::endl;
+  std::cout << "Ratio: " << total_lazy / total_eager << std::endl;
+  std::cout << ">>> END3" << std::endl;
+}
+
 }  // namespace bustub
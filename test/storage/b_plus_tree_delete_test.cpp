@@ -11,7 +11,11 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <random>
+#include <set>
+#include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -23,7 +27,7 @@ namespace bustub {
 
 using bustub::DiskManagerUnlimitedMemory;
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
+TEST(BPlusTreeTests, DeleteTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -90,7 +94,7 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
+TEST(BPlusTreeTests, DeleteTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -156,4 +160,209 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
   delete transaction;
   delete bpm;
 }
+
+TEST(BPlusTreeTests, ReverseScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (auto mode : {BPlusTreeMode::LATCH_CRABBING, BPlusTreeMode::B_LINK}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto *bpm = new BufferPoolManager(50, disk_manager.get());
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4,
+                                                             4, mode);
+    GenericKey<8> index_key;
+    auto *transaction = new Transaction(0);
+
+    // shuffled inserts and removals split and merge leaves all over the tree
+    std::vector<int64_t> keys;
+    for (int64_t key = 1; key <= 300; key++) {
+      keys.push_back(key);
+    }
+    std::mt19937 gen(15445);
+    std::shuffle(keys.begin(), keys.end(), gen);
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      ASSERT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+    }
+    std::set<int64_t> remaining(keys.begin(), keys.end());
+    std::shuffle(keys.begin(), keys.end(), gen);
+    for (size_t i = 0; i < keys.size() / 2; i++) {
+      index_key.SetFromInteger(keys[i]);
+      tree.Remove(index_key, transaction);
+      remaining.erase(keys[i]);
+    }
+
+    auto expect_range = [&](const int64_t *upper, const int64_t *lower) {
+      GenericKey<8> upper_key;
+      GenericKey<8> lower_key;
+      if (upper != nullptr) {
+        upper_key.SetFromInteger(*upper);
+      }
+      if (lower != nullptr) {
+        lower_key.SetFromInteger(*lower);
+      }
+      std::vector<int64_t> expected;
+      for (auto it = remaining.rbegin(); it != remaining.rend(); ++it) {
+        if ((upper == nullptr || *it <= *upper) && (lower == nullptr || *it >= *lower)) {
+          expected.push_back(*it);
+        }
+      }
+
+      const GenericKey<8> *upper_bound = upper != nullptr ? &upper_key : nullptr;
+      const GenericKey<8> *lower_bound = lower != nullptr ? &lower_key : nullptr;
+      std::vector<int64_t> scanned;
+      for (auto iterator = tree.RBegin(upper_bound, lower_bound); iterator != tree.End(); ++iterator) {
+        scanned.push_back((*iterator).first.ToString());
+      }
+      EXPECT_EQ(scanned, expected);
+
+      std::vector<std::pair<GenericKey<8>, RID>> batch;
+      auto iterator = tree.RBegin(upper_bound, lower_bound);
+      size_t count;
+      while ((count = iterator.NextBatch(&batch, 3)) > 0) {
+        EXPECT_LE(count, 3);
+      }
+      scanned.clear();
+      for (const auto &pair : batch) {
+        scanned.push_back(pair.second.GetSlotNum());
+      }
+      EXPECT_EQ(scanned, expected);
+    };
+    int64_t low = 57;
+    int64_t high = 243;
+    int64_t beyond = 1000;
+    expect_range(nullptr, nullptr);
+    expect_range(&high, nullptr);
+    expect_range(nullptr, &low);
+    expect_range(&high, &low);
+    expect_range(&low, &high);
+    expect_range(&low, &low);
+    expect_range(&beyond, &high);
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete transaction;
+    delete bpm;
+  }
+}
+
+TEST(BPlusTreeTests, RemoveBatchTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  auto *transaction = new Transaction(0);
+
+  int64_t scale = 400;
+  for (int64_t key = 1; key <= scale; key++) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+  }
+
+  // every key not divisible by 3 in one shuffled batch, plus keys that are not in the tree
+  std::vector<GenericKey<8>> keys;
+  for (int64_t key = -10; key <= scale + 10; key++) {
+    if (key % 3 != 0) {
+      index_key.SetFromInteger(key);
+      keys.push_back(index_key);
+    }
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  tree.RemoveBatch(keys, transaction);
+
+  int64_t current_key = 3;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+    current_key = current_key + 3;
+  }
+  EXPECT_EQ(current_key, scale / 3 * 3 + 3);
+
+  // then everything else, which empties the tree
+  keys.clear();
+  for (int64_t key = 3; key <= scale; key += 3) {
+    index_key.SetFromInteger(key);
+    keys.push_back(index_key);
+  }
+  tree.RemoveBatch(keys, transaction);
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, LazyMergeTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  auto tree = std::make_unique<BPlusTree<GenericKey<8>, RID, GenericComparator<8>>>(
+      "foo_pk", header_page->GetPageId(), bpm, comparator, 4, 4, BPlusTreeMode::LAZY_MERGE);
+  GenericKey<8> index_key;
+
+  int64_t scale = 1000;
+  for (int64_t key = 1; key <= scale; key++) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree->Insert(index_key, RID(0, key)));
+  }
+  auto expect_multiples_of = [&](int64_t step) {
+    int64_t current_key = step;
+    for (auto iterator = tree->Begin(); iterator != tree->End(); ++iterator) {
+      ASSERT_EQ((*iterator).first.ToString(), current_key);
+      current_key += step;
+    }
+    EXPECT_EQ(current_key, scale / step * step + step);
+    for (auto iterator = tree->RBegin(); iterator != tree->End(); ++iterator) {
+      current_key -= step;
+      ASSERT_EQ((*iterator).first.ToString(), current_key);
+    }
+    EXPECT_EQ(current_key, step);
+  };
+
+  // removals leave empty and underfull leaves in place, which scans step over
+  for (int64_t key = 1; key <= scale; key++) {
+    if (key % 7 != 0) {
+      index_key.SetFromInteger(key);
+      tree->Remove(index_key, nullptr);
+    }
+  }
+  expect_multiples_of(7);
+  tree->Consolidate();
+  EXPECT_EQ(tree->GetUnderfullLeafCount(), 0);
+  expect_multiples_of(7);
+
+  // the background thread gets to the leaves on its own once removals stop
+  for (int64_t key = 7; key <= scale; key += 7) {
+    if (key % 14 != 0) {
+      index_key.SetFromInteger(key);
+      tree->Remove(index_key, nullptr);
+    }
+  }
+  for (int i = 0; i < 100 && tree->GetUnderfullLeafCount() > 0; i++) {
+    std::this_thread::sleep_for(BPLUS_TREE_CONSOLIDATE_INTERVAL);
+  }
+  EXPECT_EQ(tree->GetUnderfullLeafCount(), 0);
+  expect_multiples_of(14);
+
+  for (int64_t key = 14; key <= scale; key += 14) {
+    index_key.SetFromInteger(key);
+    tree->Remove(index_key, nullptr);
+  }
+  EXPECT_TRUE(tree->IsEmpty());
+  tree->Consolidate();
+  EXPECT_EQ(tree->GetRootPageId(), INVALID_PAGE_ID);
+
+  tree.reset();
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+}
 }  // namespace bustub
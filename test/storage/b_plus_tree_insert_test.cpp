@@ -12,18 +12,23 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager_memory.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
 
 namespace bustub {
 
 using bustub::DiskManagerUnlimitedMemory;
 
-TEST(BPlusTreeTests, DISABLED_InsertTest1) {
+TEST(BPlusTreeTests, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -62,7 +67,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest2) {
+TEST(BPlusTreeTests, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -120,7 +125,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   delete bpm;
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest3) {
+TEST(BPlusTreeTests, InsertTest3) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -184,4 +189,323 @@ TEST(BPlusTreeTests, DISABLED_InsertTest3) {
   delete transaction;
   delete bpm;
 }
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 5, 4);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  // shuffled input with a duplicate key, which keeps its first value
+  std::vector<int64_t> keys;
+  int64_t scale = 500;
+  for (int64_t key = 1; key <= scale; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  std::vector<std::pair<GenericKey<8>, RID>> pairs;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    pairs.emplace_back(index_key, RID(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF));
+  }
+  index_key.SetFromInteger(1);
+  pairs.emplace_back(index_key, RID(1, 1));
+  ASSERT_TRUE(tree.BulkLoad(pairs));
+  ASSERT_FALSE(tree.BulkLoad(pairs));
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    tree.GetValue(index_key, &rids);
+    ASSERT_EQ(rids.size(), 1);
+    EXPECT_EQ(rids[0].GetPageId(), 0);
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+
+  int64_t current_key = 1;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+    current_key = current_key + 1;
+  }
+  EXPECT_EQ(current_key, scale + 1);
+  for (auto iterator = tree.RBegin(); iterator != tree.End(); ++iterator) {
+    current_key = current_key - 1;
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+  }
+  EXPECT_EQ(current_key, 1);
+
+  // the loaded tree keeps working with regular inserts and removals
+  for (int64_t key = scale + 1; key <= 2 * scale; key++) {
+    index_key.SetFromInteger(key);
+    rid.Set(0, key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+  for (int64_t key = 1; key <= 2 * scale; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  current_key = 2;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+    current_key = current_key + 2;
+  }
+  EXPECT_EQ(current_key, 2 * scale + 2);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+/*
+ * Bulk load keys 1 to `total` into a fresh tree and check that no page but the root is below its minimum size, which
+ * would merge on its first removal, or above what it can hold.
+ */
+void CheckBulkLoadedPageSizes(int leaf_max_size, int internal_max_size, double fill_factor, int64_t total) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPageGuarded(&header_page_id).Drop();
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page_id, bpm.get(), comparator,
+                                                           leaf_max_size, internal_max_size);
+  std::vector<std::pair<GenericKey<8>, RID>> pairs;
+  GenericKey<8> index_key;
+  for (int64_t key = 1; key <= total; key++) {
+    index_key.SetFromInteger(key);
+    pairs.emplace_back(index_key, RID(0, key));
+  }
+  ASSERT_TRUE(tree.BulkLoad(pairs, fill_factor));
+
+  int64_t loaded = 0;
+  std::vector<page_id_t> pages{tree.GetRootPageId()};
+  for (size_t i = 0; i < pages.size(); i++) {
+    auto guard = bpm->FetchPageRead(pages[i]);
+    auto page = guard.As<BPlusTreePage>();
+    std::string where = fmt::format("max {}/{}, fill {}, {} keys, page {}", leaf_max_size, internal_max_size,
+                                    fill_factor, total, pages[i]);
+    if (i > 0) {
+      ASSERT_GE(page->GetSize(), page->GetMinSize()) << where;
+    }
+    if (page->IsLeafPage()) {
+      ASSERT_LT(page->GetSize(), page->GetMaxSize()) << where;
+      loaded += page->GetSize();
+      continue;
+    }
+    ASSERT_LE(page->GetSize(), page->GetMaxSize()) << where;
+    auto internal = guard.As<BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>>();
+    for (int j = 0; j < internal->GetSize(); j++) {
+      pages.push_back(internal->ValueAt(j));
+    }
+  }
+  ASSERT_EQ(loaded, total);
+}
+
+TEST(BPlusTreeTests, BulkLoadPageSizeTest) {
+  // At the lowest fill, leaves get their minimum size: one more key than that, one less than twice that, and one more
+  // than the fill used to spread over two half-empty pages
+  for (int64_t total : {51, 99, 101, 2 * 50 * 51 + 1}) {
+    CheckBulkLoadedPageSizes(100, 101, 0.0, total);
+    CheckBulkLoadedPageSizes(100, 101, 0.5, total);
+    CheckBulkLoadedPageSizes(100, 101, 1.0, total);
+  }
+  // Small pages, so that every count of keys up to a few levels of internal pages is tried
+  for (int64_t total = 1; total <= 200; total++) {
+    CheckBulkLoadedPageSizes(6, 5, 0.0, total);
+    CheckBulkLoadedPageSizes(7, 6, 0.7, total);
+    CheckBulkLoadedPageSizes(5, 4, 1.0, total);
+  }
+}
+
+TEST(BPlusTreeTests, RangeScanTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // small leaves, so a scan crosses many more leaves than the buffer pool has frames
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  auto *transaction = new Transaction(0);
+
+  // even keys only, so that bounds can fall between keys
+  int64_t scale = 400;
+  for (int64_t key = 2; key <= 2 * scale; key += 2) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+  }
+
+  auto expect_range = [&](int64_t lower, int64_t upper) {
+    GenericKey<8> lower_key;
+    GenericKey<8> upper_key;
+    lower_key.SetFromInteger(lower);
+    upper_key.SetFromInteger(upper);
+    int64_t first = std::max<int64_t>(2, lower + (lower & 1));
+    int64_t last = std::min<int64_t>(2 * scale, upper - (upper & 1));
+
+    int64_t current_key = first;
+    for (auto iterator = tree.Begin(&lower_key, &upper_key); iterator != tree.End(); ++iterator) {
+      ASSERT_EQ((*iterator).first.ToString(), current_key);
+      current_key += 2;
+    }
+    EXPECT_EQ(current_key, std::max(first, last + 2)) << lower << " " << upper;
+
+    std::vector<std::pair<GenericKey<8>, RID>> batch;
+    auto iterator = tree.Begin(&lower_key, &upper_key);
+    size_t count;
+    while ((count = iterator.NextBatch(&batch, 3)) > 0) {
+      EXPECT_LE(count, 3);
+    }
+    EXPECT_TRUE(iterator.IsEnd());
+    ASSERT_EQ(batch.size(), last >= first ? (last - first) / 2 + 1 : 0) << lower << " " << upper;
+    for (size_t i = 0; i < batch.size(); i++) {
+      EXPECT_EQ(batch[i].second.GetSlotNum(), first + 2 * static_cast<int64_t>(i));
+    }
+  };
+  expect_range(0, 3 * scale);
+  expect_range(2, 2 * scale);
+  expect_range(101, 599);
+  expect_range(100, 600);
+  expect_range(300, 300);
+  expect_range(301, 301);
+  expect_range(500, 100);
+  expect_range(2 * scale + 1, 3 * scale);
+
+  // unbounded on either side
+  index_key.SetFromInteger(2 * scale - 9);
+  int64_t current_key = 2 * scale - 8;
+  for (auto iterator = tree.Begin(&index_key, nullptr); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+    current_key += 2;
+  }
+  EXPECT_EQ(current_key, 2 * scale + 2);
+  index_key.SetFromInteger(9);
+  current_key = 2;
+  for (auto iterator = tree.Begin(nullptr, &index_key); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+    current_key += 2;
+  }
+  EXPECT_EQ(current_key, 10);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, InsertBatchTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  auto *transaction = new Transaction(0);
+
+  // odd keys one at a time, then the rest in unsorted batches that also repeat some keys
+  int64_t scale = 400;
+  for (int64_t key = 1; key <= scale; key += 2) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+  }
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= scale; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  size_t inserted = 0;
+  for (size_t begin = 0; begin < keys.size(); begin += 100) {
+    std::vector<std::pair<GenericKey<8>, RID>> pairs;
+    for (size_t i = begin; i < begin + 100; i++) {
+      index_key.SetFromInteger(keys[i]);
+      pairs.emplace_back(index_key, RID(0, keys[i]));
+    }
+    pairs.push_back(pairs.front());
+    inserted += tree.InsertBatch(pairs, transaction);
+  }
+  EXPECT_EQ(inserted, scale / 2);
+
+  int64_t current_key = 1;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 1;
+  }
+  EXPECT_EQ(current_key, scale + 1);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, CoveringIndexTest) {
+  auto schema = ParseCreateStatement("a integer,b integer,c bigint,d integer");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  // key (a), with b and c stored in the leaves
+  CoveringBPlusTreeIndexForTwoIntegerColumn index(
+      std::make_unique<IndexMetadata>("foo_pk", "foo", schema.get(), std::vector<uint32_t>{0},
+                                      std::vector<uint32_t>{1, 2}),
+      bpm);
+  auto *transaction = new Transaction(0);
+
+  auto make_entry = [&](int32_t a) {
+    Tuple row({ValueFactory::GetIntegerValue(a), ValueFactory::GetIntegerValue(a * 10),
+               ValueFactory::GetBigIntValue(int64_t{a} << 40), ValueFactory::GetIntegerValue(-a)},
+              schema.get());
+    return row.KeyFromTuple(*schema, *index.GetEntrySchema(), index.GetEntryAttrs());
+  };
+  // even keys one at a time, odd keys in a batch, then drop the multiples of three
+  int32_t scale = 300;
+  for (int32_t a = 0; a < scale; a += 2) {
+    ASSERT_TRUE(index.InsertEntry(make_entry(a), RID(a, 0), transaction));
+  }
+  std::vector<std::pair<Tuple, RID>> entries;
+  for (int32_t a = 1; a < scale; a += 2) {
+    entries.emplace_back(make_entry(a), RID(a, 0));
+  }
+  EXPECT_EQ(index.InsertEntries(entries, transaction), static_cast<size_t>(scale / 2));
+  for (int32_t a = 0; a < scale; a += 3) {
+    index.DeleteEntry(make_entry(a), RID(a, 0), transaction);
+  }
+
+  auto *metadata = index.GetMetadata();
+  int32_t expected = 1;
+  for (auto iterator = index.GetBeginIterator(); iterator != index.GetEndIterator(); ++iterator) {
+    const auto &[key, value] = *iterator;
+    EXPECT_EQ(key.ToValue(metadata->GetKeySchema(), 0).GetAs<int32_t>(), expected);
+    EXPECT_EQ(value.rid_.GetPageId(), expected);
+    EXPECT_EQ(value.ToValue(metadata->GetIncludeSchema(), 0).GetAs<int32_t>(), expected * 10);
+    EXPECT_EQ(value.ToValue(metadata->GetIncludeSchema(), 1).GetAs<int64_t>(), int64_t{expected} << 40);
+    expected += expected % 3 == 1 ? 1 : 2;
+  }
+  EXPECT_EQ(expected, scale + 1);
+
+  std::vector<RID> rids;
+  index.ScanKey(Tuple({ValueFactory::GetIntegerValue(7)}, metadata->GetKeySchema()), &rids, transaction);
+  ASSERT_EQ(rids.size(), 1);
+  EXPECT_EQ(rids[0].GetPageId(), 7);
+  rids.clear();
+  index.ScanKey(Tuple({ValueFactory::GetIntegerValue(9)}, metadata->GetKeySchema()), &rids, transaction);
+  EXPECT_TRUE(rids.empty());
+
+  delete transaction;
+  delete bpm;
+}
 }  // namespace bustub
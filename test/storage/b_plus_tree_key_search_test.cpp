@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search_test.cpp
+//
+// Identification: test/storage/b_plus_tree_key_search_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/rid.h"
+#include "gtest/gtest.h"
+#include "storage/page/b_plus_tree_key_search.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using KeySearch = BPlusTreeKeySearch<GenericKey<8>, GenericComparator<8>>;
+using ComparatorSearch = ComparatorKeySearch<GenericKey<8>, GenericComparator<8>>;
+
+/** Check the integer search against the comparator on sorted pages of up to 40 keys. */
+void CheckAgainstComparator(const std::string &schema, const std::function<std::vector<Value>(int)> &make_values,
+                            IntegerKeyLayout layout) {
+  auto key_schema = ParseCreateStatement(schema);
+  GenericComparator<8> comparator(key_schema.get());
+  ASSERT_EQ(comparator.GetIntegerKeyLayout(), layout);
+
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<int> dis(-1000, 1000);
+  auto make_key = [&](int seed) {
+    GenericKey<8> key;
+    key.SetFromKey(Tuple(make_values(seed), key_schema.get()));
+    return key;
+  };
+
+  for (int size = 0; size < 40; size++) {
+    std::vector<int> seeds;
+    for (int i = 0; i < size; i++) {
+      seeds.push_back(dis(gen));
+    }
+    std::sort(seeds.begin(), seeds.end());
+    seeds.erase(std::unique(seeds.begin(), seeds.end()), seeds.end());
+    std::vector<std::pair<GenericKey<8>, RID>> entries;
+    for (auto seed : seeds) {
+      entries.emplace_back(make_key(seed), RID());
+    }
+    int n = static_cast<int>(entries.size());
+    for (int probe = -1002; probe <= 1002; probe += 7) {
+      auto key = make_key(probe);
+      for (int begin = 0; begin <= std::min(n, 1); begin++) {
+        EXPECT_EQ(KeySearch::LowerBound(entries.data(), begin, n, key, comparator),
+                  ComparatorSearch::LowerBound(entries.data(), begin, n, key, comparator));
+        EXPECT_EQ(KeySearch::UpperBound(entries.data(), begin, n, key, comparator),
+                  ComparatorSearch::UpperBound(entries.data(), begin, n, key, comparator));
+      }
+    }
+  }
+}
+
+TEST(BPlusTreeKeySearchTest, BigIntTest) {
+  CheckAgainstComparator(
+      "a bigint", [](int seed) { return std::vector<Value>{ValueFactory::GetBigIntValue(seed * 1000000007LL)}; },
+      IntegerKeyLayout::BIGINT);
+}
+
+TEST(BPlusTreeKeySearchTest, IntegerTest) {
+  CheckAgainstComparator(
+      "a integer", [](int seed) { return std::vector<Value>{ValueFactory::GetIntegerValue(seed)}; },
+      IntegerKeyLayout::INTEGER);
+}
+
+TEST(BPlusTreeKeySearchTest, TwoIntegerTest) {
+  // the second column crosses zero inside every value of the first one
+  CheckAgainstComparator(
+      "a integer,b integer",
+      [](int seed) {
+        int high = seed >= 0 ? seed / 100 : -((-seed + 99) / 100);
+        return std::vector<Value>{ValueFactory::GetIntegerValue(high),
+                                  ValueFactory::GetIntegerValue((seed - high * 100 - 50) * 40000000)};
+      },
+      IntegerKeyLayout::TWO_INTEGER);
+}
+
+TEST(BPlusTreeKeySearchTest, NullTest) {
+  // NULLs take the place of the smallest keys, so the pages stay sorted
+  CheckAgainstComparator(
+      "a bigint",
+      [](int seed) {
+        return std::vector<Value>{seed <= -1000 ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                                                : ValueFactory::GetBigIntValue(seed)};
+      },
+      IntegerKeyLayout::BIGINT);
+  CheckAgainstComparator(
+      "a integer",
+      [](int seed) {
+        return std::vector<Value>{seed <= -1000 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                                : ValueFactory::GetIntegerValue(seed)};
+      },
+      IntegerKeyLayout::INTEGER);
+  CheckAgainstComparator(
+      "a integer,b integer",
+      [](int seed) {
+        int high = seed >= 0 ? seed / 10 : -((-seed + 9) / 10);
+        int low = seed - high * 10;
+        return std::vector<Value>{seed <= -1000 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                                : ValueFactory::GetIntegerValue(high),
+                                  low == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                           : ValueFactory::GetIntegerValue(low)};
+      },
+      IntegerKeyLayout::TWO_INTEGER);
+
+  auto key_schema = ParseCreateStatement("a integer,b integer");
+  GenericComparator<8> comparator(key_schema.get());
+  auto make_key = [&](const Value &a, const Value &b) {
+    GenericKey<8> key;
+    key.SetFromKey(Tuple({a, b}, key_schema.get()));
+    return key;
+  };
+  auto null = ValueFactory::GetNullValueByType(TypeId::INTEGER);
+  auto min = ValueFactory::GetIntegerValue(BUSTUB_INT32_MIN);
+  auto zero = ValueFactory::GetIntegerValue(0);
+  EXPECT_LT(comparator(make_key(null, zero), make_key(min, null)), 0);
+  EXPECT_LT(comparator(make_key(zero, null), make_key(zero, min)), 0);
+  EXPECT_EQ(comparator(make_key(null, null), make_key(null, null)), 0);
+  EXPECT_GT(comparator(make_key(min, min), make_key(null, min)), 0);
+}
+
+TEST(BPlusTreeKeySearchTest, FallbackTest) {
+  auto key_schema = ParseCreateStatement("a integer,b smallint");
+  GenericComparator<8> comparator(key_schema.get());
+  EXPECT_EQ(comparator.GetIntegerKeyLayout(), IntegerKeyLayout::NONE);
+}
+
+}  // namespace bustub
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_prefix_page_test.cpp
+//
+// Identification: test/storage/b_plus_tree_prefix_page_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "common/rid.h"
+#include "gtest/gtest.h"
+#include "prefix_page.h"  // NOLINT
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using PrefixLeafPage = BPlusTreePrefixLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
+using PrefixInternalPage = BPlusTreePrefixInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
+
+auto MakeCompositeKey(Schema *key_schema, int64_t a, int64_t b, int64_t c, int64_t d) -> GenericKey<32> {
+  std::vector<Value> values{ValueFactory::GetBigIntValue(a), ValueFactory::GetBigIntValue(b),
+                            ValueFactory::GetBigIntValue(c), ValueFactory::GetBigIntValue(d)};
+  GenericKey<32> key;
+  key.SetFromKey(Tuple(values, key_schema));
+  return key;
+}
+
+TEST(BPlusTreePrefixPageTest, LeafTest) {
+  auto key_schema = ParseCreateStatement("a bigint,b bigint,c bigint,d bigint");
+  GenericComparator<32> comparator(key_schema.get());
+  alignas(8) char buffer[BUSTUB_PAGE_SIZE];
+  auto leaf = reinterpret_cast<PrefixLeafPage *>(buffer);
+  leaf->Init();
+
+  // keys sharing their first three columns, inserted out of order until the page is full
+  std::vector<int64_t> ds(200);
+  std::iota(ds.begin(), ds.end(), 0);
+  std::shuffle(ds.begin(), ds.end(), std::mt19937(15445));
+  std::vector<int64_t> inserted;
+  for (auto d : ds) {
+    if (!leaf->Insert(MakeCompositeKey(key_schema.get(), 7, 3, 42, d), RID(0, d), comparator)) {
+      break;
+    }
+    inserted.push_back(d);
+  }
+  ASSERT_GT(static_cast<int>(inserted.size()), leaf->GetMaxSize());
+  ASSERT_EQ(leaf->GetSize(), inserted.size());
+  EXPECT_GE(leaf->GetPrefixSize(), 24);
+  EXPECT_FALSE(leaf->Insert(MakeCompositeKey(key_schema.get(), 7, 3, 42, inserted[0]), RID(), comparator));
+
+  std::sort(inserted.begin(), inserted.end());
+  for (int i = 0; i < leaf->GetSize(); i++) {
+    EXPECT_EQ(comparator(leaf->KeyAt(i), MakeCompositeKey(key_schema.get(), 7, 3, 42, inserted[i])), 0);
+    EXPECT_EQ(leaf->ValueAt(i).GetSlotNum(), inserted[i]);
+  }
+
+  // a key with a different leading column shrinks the prefix, which no longer leaves room for everything
+  EXPECT_FALSE(leaf->Insert(MakeCompositeKey(key_schema.get(), 8, 0, 0, 0), RID(), comparator));
+
+  // on an emptier page the prefix shrinks and all keys are written back
+  leaf->Init();
+  for (int64_t d = 0; d < 10; d++) {
+    ASSERT_TRUE(leaf->Insert(MakeCompositeKey(key_schema.get(), 7, 3, 42, d), RID(0, d), comparator));
+  }
+  ASSERT_TRUE(leaf->Insert(MakeCompositeKey(key_schema.get(), 1, 0, 0, 0), RID(0, 100), comparator));
+  EXPECT_EQ(leaf->GetPrefixSize(), 0);
+  RID rid;
+  ASSERT_TRUE(leaf->Lookup(MakeCompositeKey(key_schema.get(), 1, 0, 0, 0), &rid, comparator));
+  EXPECT_EQ(rid.GetSlotNum(), 100);
+  for (int64_t d = 0; d < 10; d++) {
+    ASSERT_TRUE(leaf->Lookup(MakeCompositeKey(key_schema.get(), 7, 3, 42, d), &rid, comparator));
+    EXPECT_EQ(rid.GetSlotNum(), d);
+  }
+  EXPECT_FALSE(leaf->Lookup(MakeCompositeKey(key_schema.get(), 7, 3, 42, 10), &rid, comparator));
+}
+
+TEST(BPlusTreePrefixPageTest, InternalTest) {
+  auto key_schema = ParseCreateStatement("a bigint,b bigint,c bigint,d bigint");
+  GenericComparator<32> comparator(key_schema.get());
+  alignas(8) char buffer[BUSTUB_PAGE_SIZE];
+  auto internal = reinterpret_cast<PrefixInternalPage *>(buffer);
+  internal->Init();
+
+  // suffix truncation keeps only what is needed to tell the two keys apart
+  auto left = MakeCompositeKey(key_schema.get(), 7, 3, 41, 999);
+  auto right = MakeCompositeKey(key_schema.get(), 7, 3, 42, 17);
+  auto separator = PrefixInternalPage::ShortestSeparator(left, right, comparator);
+  EXPECT_LT(comparator(left, separator), 0);
+  EXPECT_LE(comparator(separator, right), 0);
+  EXPECT_EQ(comparator(separator, MakeCompositeKey(key_schema.get(), 7, 3, 42, 0)), 0);
+
+  // child i covers [(7, 3, 10 * i, 0), (7, 3, 10 * (i + 1), 0))
+  int children = 0;
+  while (internal->Append(MakeCompositeKey(key_schema.get(), 7, 3, 10 * children, 0), children)) {
+    children++;
+  }
+  ASSERT_GT(children, internal->GetMaxSize());
+  EXPECT_GE(internal->GetPrefixSize(), 16);
+  for (int i = 0; i < children; i++) {
+    EXPECT_EQ(internal->ValueAt(i), i);
+    EXPECT_EQ(internal->Lookup(MakeCompositeKey(key_schema.get(), 7, 3, 10 * i + 5, 123), comparator), i);
+  }
+  EXPECT_EQ(internal->Lookup(MakeCompositeKey(key_schema.get(), 0, 0, 0, 0), comparator), 0);
+  EXPECT_EQ(internal->Lookup(MakeCompositeKey(key_schema.get(), 9, 0, 0, 0), comparator), children - 1);
+
+  // a separator sharing less with the page re-encodes it
+  internal->Init();
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(internal->Append(MakeCompositeKey(key_schema.get(), 7, 3, 10 * i, 0), i));
+  }
+  ASSERT_TRUE(internal->Append(MakeCompositeKey(key_schema.get(), 8, 0, 0, 0), 5));
+  EXPECT_EQ(internal->GetPrefixSize(), 0);
+  for (int i = 1; i < 5; i++) {
+    EXPECT_EQ(comparator(internal->KeyAt(i), MakeCompositeKey(key_schema.get(), 7, 3, 10 * i, 0)), 0);
+  }
+  EXPECT_EQ(internal->Lookup(MakeCompositeKey(key_schema.get(), 7, 3, 25, 0), comparator), 2);
+  EXPECT_EQ(internal->Lookup(MakeCompositeKey(key_schema.get(), 8, 1, 0, 0), comparator), 5);
+}
+
+}  // namespace bustub
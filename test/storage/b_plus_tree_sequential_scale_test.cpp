@@ -27,7 +27,7 @@ using bustub::DiskManagerUnlimitedMemory;
 /**
  * This test should be passing with your Checkpoint 1 submission.
  */
-TEST(BPlusTreeTests, DISABLED_ScaleTest) {  // NOLINT
+TEST(BPlusTreeTests, ScaleTest) {  // NOLINT
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -77,4 +77,56 @@ TEST(BPlusTreeTests, DISABLED_ScaleTest) {  // NOLINT
   delete transaction;
   delete bpm;
 }
+
+/**
+ * Ascending inserts take the rightmost-leaf fast path and split 90/10, so every leaf but the last keeps the same
+ * BPLUS_TREE_APPEND_SPLIT_KEEP share of its pairs.
+ */
+TEST(BPlusTreeTests, SequentialFillTest) {  // NOLINT
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t page_id;
+  bpm->NewPageGuarded(&page_id).Drop();
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm.get(), comparator);
+  GenericKey<8> index_key;
+  RID rid;
+
+  int64_t scale = 100000;
+  for (int64_t key = 1; key <= scale; key++) {
+    rid.Set(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xFFFFFFFF));
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, rid));
+  }
+
+  // walk the leaf chain from the leftmost leaf
+  page_id_t leaf_page_id = tree.GetRootPageId();
+  while (true) {
+    auto guard = bpm->FetchPageRead(leaf_page_id);
+    if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+      break;
+    }
+    leaf_page_id = guard.As<BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>>()->ValueAt(0);
+  }
+  int64_t expected = 1;
+  while (leaf_page_id != INVALID_PAGE_ID) {
+    auto guard = bpm->FetchPageRead(leaf_page_id);
+    auto leaf = guard.As<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>>();
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      ASSERT_EQ(leaf->KeyAt(i).ToString(), expected++);
+    }
+    leaf_page_id = leaf->GetNextPageId();
+    if (leaf_page_id == INVALID_PAGE_ID) {
+      ASSERT_GE(leaf->GetSize(), 1);
+      ASSERT_LT(leaf->GetSize(), leaf->GetMaxSize());
+    } else {
+      int keep = std::clamp(static_cast<int>(leaf->GetMaxSize() * BPLUS_TREE_APPEND_SPLIT_KEEP),
+                            leaf->GetMinSize(), leaf->GetMaxSize() - 1);
+      ASSERT_EQ(leaf->GetSize(), keep) << "leaf " << guard.PageId();
+    }
+  }
+  ASSERT_EQ(expected, scale + 1);
+}
 }  // namespace bustub
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter_test.cpp
+//
+// Identification: test/storage/bloom_filter_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/index/bloom_filter.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+TEST(BloomFilterTest, FalsePositiveRateTest) {
+  const size_t capacity = 100000;
+  BloomFilter filter(capacity);
+  std::mt19937_64 gen(15445);
+  std::vector<uint64_t> hashes;
+  for (size_t i = 0; i < capacity; i++) {
+    hashes.push_back(gen());
+    filter.Insert(hashes.back());
+  }
+  for (auto hash : hashes) {
+    ASSERT_TRUE(filter.MayContain(hash));
+  }
+
+  size_t false_positives = 0;
+  for (size_t i = 0; i < capacity; i++) {
+    false_positives += filter.MayContain(gen()) ? 1 : 0;
+  }
+  double rate = static_cast<double>(false_positives) / capacity;
+  EXPECT_LT(rate, 0.03);
+  EXPECT_GT(filter.EstimatedFalsePositiveRate(), rate / 2);
+  EXPECT_LT(filter.EstimatedFalsePositiveRate(), rate * 2);
+}
+
+TEST(BloomFilterTest, IndexLookupTest) {
+  auto schema = ParseCreateStatement("a integer");
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  BPlusTreeIndexForTwoIntegerColumn index(
+      std::make_unique<IndexMetadata>("foo_pk", "foo", schema.get(), std::vector<uint32_t>{0}), bpm);
+  auto *transaction = new Transaction(0);
+  auto make_key = [&](int32_t a) { return Tuple({ValueFactory::GetIntegerValue(a)}, schema.get()); };
+
+  // even keys, bulk loaded before the filter is enabled and inserted one at a time after it
+  const int32_t scale = 20000;
+  std::vector<std::pair<IntegerKeyType, IntegerValueType>> entries;
+  for (int32_t a = 0; a < scale; a += 2) {
+    entries.emplace_back(index.MakeEntry(make_key(a), RID(a, 0)));
+  }
+  ASSERT_TRUE(index.BulkLoad(std::move(entries)));
+  index.EnableBloomFilter();
+  for (int32_t a = scale; a < scale * 2; a += 2) {
+    ASSERT_TRUE(index.InsertEntry(make_key(a), RID(a, 0), transaction));
+  }
+
+  auto lookup = [&](int32_t a) {
+    std::vector<RID> rids;
+    index.ScanKey(make_key(a), &rids, transaction);
+    return rids;
+  };
+  for (int32_t a = 0; a < scale * 2; a++) {
+    auto rids = lookup(a);
+    ASSERT_EQ(rids.size(), a % 2 == 0 ? 1 : 0);
+  }
+  auto stats = index.GetBloomFilterStats();
+  EXPECT_EQ(stats.probes_, scale * 2);
+  EXPECT_EQ(stats.skipped_ + stats.false_positives_, scale);
+  EXPECT_LT(stats.FalsePositiveRate(), 0.05);
+  EXPECT_GT(stats.estimated_false_positive_rate_, 0);
+
+  // removing most keys rebuilds the filter, with no removed key left behind in it and none of the rest missing
+  for (int32_t a = 0; a < scale * 2; a += 2) {
+    if (a % 10 != 0) {
+      index.DeleteEntry(make_key(a), RID(a, 0), transaction);
+    }
+  }
+  for (int32_t a = 0; a < scale * 2; a += 10) {
+    ASSERT_EQ(lookup(a).size(), 1);
+  }
+  auto before = index.GetBloomFilterStats();
+  for (int32_t a = 2; a < scale * 2; a += 10) {
+    ASSERT_TRUE(lookup(a).empty());
+  }
+  auto after = index.GetBloomFilterStats();
+  EXPECT_GT(after.skipped_ - before.skipped_, static_cast<size_t>(scale / 5 * 9 / 10));
+
+  delete transaction;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memcmp_key_test.cpp
+//
+// Identification: test/storage/memcmp_key_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/memcmp_key.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Compare two rows column by column, the order the encoding must preserve. */
+auto CompareRows(const std::vector<Value> &lhs, const std::vector<Value> &rhs) -> int {
+  for (size_t i = 0; i < lhs.size(); i++) {
+    if (lhs[i].CompareLessThan(rhs[i]) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (lhs[i].CompareGreaterThan(rhs[i]) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+auto Sign(int value) -> int { return (value > 0) - (value < 0); }
+
+TEST(MemcmpKeyTest, OrderTest) {
+  auto key_schema = ParseCreateStatement("a integer,b varchar(8),c bigint,d double,e smallint");
+  MemcmpComparator<64> comparator(key_schema.get());
+
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<int> small(-3, 3);
+  std::vector<std::string> strings{"", std::string("\0", 1), std::string("a\0", 2), "a", "ab", "b", "\xff"};
+  std::uniform_int_distribution<size_t> string_dis(0, strings.size() - 1);
+
+  std::vector<std::vector<Value>> rows;
+  for (int i = 0; i < 300; i++) {
+    auto &s = strings[string_dis(gen)];
+    rows.push_back({ValueFactory::GetIntegerValue(small(gen) * 1000000), ValueFactory::GetVarcharValue(s),
+                    ValueFactory::GetBigIntValue(small(gen) * (int64_t{1} << 40)),
+                    ValueFactory::GetDecimalValue(small(gen) * 0.5), ValueFactory::GetSmallIntValue(small(gen))});
+  }
+  std::vector<GenericKey<64>> keys;
+  for (const auto &row : rows) {
+    keys.push_back(MemcmpKeyEncoder::MakeKey<64>(Tuple(row, key_schema.get()), key_schema.get()));
+  }
+  for (size_t i = 0; i < rows.size(); i++) {
+    for (size_t j = 0; j < rows.size(); j++) {
+      ASSERT_EQ(Sign(comparator(keys[i], keys[j])), CompareRows(rows[i], rows[j])) << i << " " << j;
+    }
+  }
+}
+
+TEST(MemcmpKeyTest, NullTest) {
+  auto key_schema = ParseCreateStatement("a bigint,b varchar(8)");
+  MemcmpComparator<32> comparator(key_schema.get());
+  auto make_key = [&](const Value &a, const Value &b) {
+    return MemcmpKeyEncoder::MakeKey<32>(Tuple({a, b}, key_schema.get()), key_schema.get());
+  };
+  auto null_bigint = ValueFactory::GetNullValueByType(TypeId::BIGINT);
+  auto null_varchar = ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+
+  // NULLs sort before every other value of their column
+  EXPECT_LT(comparator(make_key(null_bigint, ValueFactory::GetVarcharValue("z")),
+                       make_key(ValueFactory::GetBigIntValue(BUSTUB_INT64_MIN), ValueFactory::GetVarcharValue(""))),
+            0);
+  EXPECT_LT(comparator(make_key(ValueFactory::GetBigIntValue(1), null_varchar),
+                       make_key(ValueFactory::GetBigIntValue(1), ValueFactory::GetVarcharValue(""))),
+            0);
+  EXPECT_EQ(comparator(make_key(null_bigint, null_varchar), make_key(null_bigint, null_varchar)), 0);
+}
+
+TEST(MemcmpKeyTest, OverflowTest) {
+  auto key_schema = ParseCreateStatement("a varchar(16)");
+  Tuple tuple({ValueFactory::GetVarcharValue("a string too long")}, key_schema.get());
+  EXPECT_EQ(MemcmpKeyEncoder::EncodedSize(tuple, key_schema.get()), 20);
+  GenericKey<16> key;
+  EXPECT_THROW(MemcmpKeyEncoder::Encode(tuple, key_schema.get(), key.data_, sizeof(key.data_)), Exception);
+}
+
+TEST(MemcmpKeyTest, BPlusTreeTest) {
+  auto key_schema = ParseCreateStatement("a integer,b varchar(8)");
+  MemcmpComparator<16> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(50, disk_manager.get());
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<16>, RID, MemcmpComparator<16>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 4,
+                                                              5);
+  auto *transaction = new Transaction(0);
+
+  // (a, b) for a in [-5, 5) and b in {"", "x", "xy", "y"}, inserted in random order
+  std::vector<std::string> strings{"", "x", "xy", "y"};
+  std::vector<int> order(40);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937(15445));
+  auto make_key = [&](int i) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i / 4 - 5), ValueFactory::GetVarcharValue(strings[i % 4])},
+                key_schema.get());
+    return MemcmpKeyEncoder::MakeKey<16>(tuple, key_schema.get());
+  };
+  for (auto i : order) {
+    ASSERT_TRUE(tree.Insert(make_key(i), RID(i, 0), transaction));
+  }
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 40; i++) {
+    rids.clear();
+    ASSERT_TRUE(tree.GetValue(make_key(i), &rids));
+    EXPECT_EQ(rids[0].GetPageId(), i);
+  }
+  int expected = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    EXPECT_EQ((*iter).second.GetPageId(), expected++);
+  }
+  EXPECT_EQ(expected, 40);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+}  // namespace bustub
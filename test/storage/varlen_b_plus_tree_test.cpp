@@ -0,0 +1,298 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_b_plus_tree_test.cpp
+//
+// Identification: test/storage/varlen_b_plus_tree_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/varlen_b_plus_tree.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+
+namespace bustub {
+
+namespace {
+
+/** Random key of 1 to `max_length` bytes; a few leading bytes from a small alphabet give long shared prefixes. */
+auto RandomKey(std::mt19937 *gen, size_t max_length) -> std::string {
+  std::uniform_int_distribution<size_t> length_dist(1, max_length);
+  std::uniform_int_distribution<int> byte_dist(0, 255);
+  std::string key(length_dist(*gen), '\0');
+  for (size_t i = 0; i < key.size(); i++) {
+    key[i] = static_cast<char>(i < 3 ? byte_dist(*gen) % 3 : byte_dist(*gen));
+  }
+  return key;
+}
+
+void ExpectScan(VarlenBPlusTree *tree, const std::map<std::string, RID> &expected) {
+  auto expected_iter = expected.begin();
+  for (auto iter = tree->Begin(); !iter.IsEnd(); ++iter, ++expected_iter) {
+    ASSERT_NE(expected_iter, expected.end());
+    ASSERT_EQ((*iter).first, expected_iter->first);
+    ASSERT_EQ((*iter).second, expected_iter->second);
+  }
+  ASSERT_EQ(expected_iter, expected.end());
+
+  auto reverse_iter = expected.rbegin();
+  for (auto iter = tree->Begin(true); !iter.IsEnd(); ++iter, ++reverse_iter) {
+    ASSERT_NE(reverse_iter, expected.rend());
+    ASSERT_EQ((*iter).first, reverse_iter->first);
+  }
+  ASSERT_EQ(reverse_iter, expected.rend());
+}
+
+/** Walk the leaves through their next links, checking that each one links back; returns the number of leaves. */
+auto CheckLeafLinks(BufferPoolManager *bpm, VarlenBPlusTree *tree) -> size_t {
+  page_id_t page_id = tree->GetRootPageId();
+  if (page_id == INVALID_PAGE_ID) {
+    return 0;
+  }
+  while (true) {
+    auto guard = bpm->FetchPageRead(page_id);
+    const auto *page = guard.As<BPlusTreeSlottedPage>();
+    if (page->IsLeafPage()) {
+      EXPECT_EQ(page->GetPrevPageId(), INVALID_PAGE_ID);
+      break;
+    }
+    page_id = page->ChildAt(0);
+  }
+  size_t leaves = 0;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = bpm->FetchPageRead(page_id);
+    const auto *leaf = guard.As<BPlusTreeSlottedPage>();
+    EXPECT_TRUE(leaf->IsLeafPage());
+    EXPECT_EQ(leaf->GetPrevPageId(), prev_page_id);
+    EXPECT_GT(leaf->GetSize(), 0);
+    leaves++;
+    prev_page_id = page_id;
+    page_id = leaf->GetNextPageId();
+  }
+  return leaves;
+}
+
+}  // namespace
+
+TEST(VarlenBPlusTreeTests, SlottedPageTest) {
+  alignas(8) char buffer[BUSTUB_PAGE_SIZE];
+  auto page = reinterpret_cast<BPlusTreeSlottedPage *>(buffer);
+  page->Init(IndexPageType::LEAF_PAGE);
+
+  // fill the page with 100-byte keys in reverse order
+  std::vector<std::string> keys;
+  while (true) {
+    std::string key = std::to_string(9000 - keys.size());
+    key += std::string(100, static_cast<char>('a' + keys.size() % 26));
+    if (!page->InsertRid(0, key, RID(0, keys.size()))) {
+      break;
+    }
+    keys.push_back(key);
+  }
+  ASSERT_EQ(page->GetSize(), keys.size());
+  ASSERT_LT(page->GetFreeSpace(), 120);
+
+  // removing every other key leaves holes; inserting into them compacts the heap
+  int free_space = page->GetFreeSpace();
+  for (int i = page->GetSize() - 1; i >= 0; i -= 2) {
+    page->RemoveAt(i);
+  }
+  EXPECT_GT(page->GetFreeSpace(), free_space + 100 * static_cast<int>(keys.size() / 2));
+  std::string short_key = "0";
+  int inserted = 0;
+  while (page->InsertRid(page->KeyIndex(short_key), short_key, RID(1, inserted))) {
+    short_key += "0";
+    inserted++;
+  }
+  EXPECT_GT(inserted, 40);
+  for (int i = 1; i < page->GetSize(); i++) {
+    EXPECT_LT(page->KeyAt(i - 1), page->KeyAt(i));
+  }
+
+  EXPECT_THROW(page->InsertRid(0, std::string(BPlusTreeSlottedPage::MAX_KEY_SIZE + 1, 'x'), RID()), Exception);
+}
+
+TEST(VarlenBPlusTreeTests, InsertScanDeleteTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  VarlenBPlusTree tree("foo_pk", header_page_id, bpm.get());
+  ASSERT_TRUE(tree.IsEmpty());
+
+  std::mt19937 gen(15445);
+  std::map<std::string, RID> expected;
+  while (expected.size() < 5000) {
+    auto key = RandomKey(&gen, 200);
+    RID rid(static_cast<page_id_t>(expected.size()), 0);
+    bool fresh = expected.count(key) == 0;
+    ASSERT_EQ(tree.Insert(key, rid), fresh);
+    if (fresh) {
+      expected.emplace(key, rid);
+    }
+  }
+  ASSERT_FALSE(tree.IsEmpty());
+  ASSERT_FALSE(tree.Insert(expected.begin()->first, RID()));
+  ExpectScan(&tree, expected);
+
+  for (const auto &[key, rid] : expected) {
+    std::vector<RID> result;
+    ASSERT_TRUE(tree.GetValue(key, &result));
+    ASSERT_EQ(result.size(), 1);
+    ASSERT_EQ(result[0], rid);
+  }
+  std::vector<RID> result;
+  ASSERT_FALSE(tree.GetValue("not a key", &result));
+
+  // remove a contiguous run, which empties whole leaves, and every third key of the rest
+  int i = 0;
+  for (auto iter = expected.begin(); iter != expected.end(); i++) {
+    if ((i > 1000 && i < 2500) || i % 3 == 0) {
+      tree.Remove(iter->first);
+      iter = expected.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  ExpectScan(&tree, expected);
+
+  // longer keys into the emptied range and everywhere else
+  for (int j = 0; j < 2000; j++) {
+    auto key = RandomKey(&gen, 800);
+    if (expected.count(key) == 0) {
+      ASSERT_TRUE(tree.Insert(key, RID(j, 1)));
+      expected.emplace(key, RID(j, 1));
+    }
+  }
+  ExpectScan(&tree, expected);
+
+  EXPECT_THROW(tree.Insert(std::string(BPlusTreeSlottedPage::MAX_KEY_SIZE + 1, 'x'), RID()), Exception);
+
+  for (const auto &[key, rid] : expected) {
+    tree.Remove(key);
+  }
+  ASSERT_TRUE(tree.IsEmpty());
+  ASSERT_TRUE(tree.Begin(true).IsEnd());
+}
+
+TEST(VarlenBPlusTreeTests, MergeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPageGuarded(&header_page_id).Drop();
+  VarlenBPlusTree tree("foo_pk", header_page_id, bpm.get());
+
+  std::mt19937 gen(15445);
+  std::map<std::string, RID> expected;
+  while (expected.size() < 5000) {
+    auto key = RandomKey(&gen, 200);
+    if (tree.Insert(key, RID(static_cast<page_id_t>(expected.size()), 0))) {
+      expected.emplace(key, RID(static_cast<page_id_t>(expected.size()), 0));
+    }
+  }
+  size_t leaves = CheckLeafLinks(bpm.get(), &tree);
+
+  // keep one key in fifty, so that most leaves underflow and merge with a sibling
+  int i = 0;
+  for (auto iter = expected.begin(); iter != expected.end(); i++) {
+    if (i % 50 != 0) {
+      tree.Remove(iter->first);
+      iter = expected.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  ExpectScan(&tree, expected);
+  size_t merged_leaves = CheckLeafLinks(bpm.get(), &tree);
+  EXPECT_LT(merged_leaves * 10, leaves);
+
+  // removing the rest collapses the tree level by level and frees the root
+  for (const auto &[key, rid] : expected) {
+    tree.Remove(key);
+  }
+  ASSERT_TRUE(tree.IsEmpty());
+  ASSERT_EQ(CheckLeafLinks(bpm.get(), &tree), 0);
+}
+
+TEST(VarlenBPlusTreeTests, ConcurrentTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPageGuarded(&header_page_id).Drop();
+  VarlenBPlusTree tree("foo_pk", header_page_id, bpm.get());
+
+  // each writer inserts its own keys and removes every other one while a reader scans both ways
+  const int writers = 2;
+  std::mt19937 gen(15445);
+  std::vector<std::vector<std::string>> keys(writers);
+  std::map<std::string, RID> expected;
+  for (int w = 0; w < writers; w++) {
+    while (keys[w].size() < 2000) {
+      auto key = std::to_string(w) + RandomKey(&gen, 100);
+      if (expected.count(key) == 0) {
+        expected.emplace(key, RID(w, keys[w].size()));
+        keys[w].push_back(key);
+      }
+    }
+  }
+
+  std::atomic<bool> done{false};
+  std::atomic<int> out_of_order{0};
+  std::thread reader([&]() {
+    while (!done) {
+      for (bool reverse : {false, true}) {
+        std::string last;
+        bool first = true;
+        for (auto iter = tree.Begin(reverse); !iter.IsEnd(); ++iter) {
+          if (!first && (reverse ? (*iter).first >= last : (*iter).first <= last)) {
+            out_of_order++;
+          }
+          last = (*iter).first;
+          first = false;
+        }
+      }
+    }
+  });
+  std::vector<std::thread> threads;
+  for (int w = 0; w < writers; w++) {
+    threads.emplace_back([&, w]() {
+      for (size_t j = 0; j < keys[w].size(); j++) {
+        tree.Insert(keys[w][j], RID(w, j));
+      }
+      for (size_t j = 0; j < keys[w].size(); j += 2) {
+        tree.Remove(keys[w][j]);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  done = true;
+  reader.join();
+  EXPECT_EQ(out_of_order, 0);
+
+  for (int w = 0; w < writers; w++) {
+    for (size_t j = 0; j < keys[w].size(); j += 2) {
+      expected.erase(keys[w][j]);
+    }
+  }
+  ExpectScan(&tree, expected);
+  CheckLeafLinks(bpm.get(), &tree);
+}
+
+}  // namespace bustub
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/catalog.h"
+#include "common/config.h"
+#include "fmt/format.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "test_util.h"
+#include "type/value_factory.h"
+
+/*
+ * Inserts rows into a table with two B+ tree indexes, updating the indexes either one row at a time with InsertEntry
+ * or a batch at a time with InsertEntries, the way the insert executor does, then deletes them all the same way.
+ */
+
+static const size_t TOTAL_ROWS = 1000000;
+static const size_t BUSTUB_BPM_SIZE = 65536;
+
+auto SecondsSince(std::chrono::steady_clock::time_point start) -> double {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct RunResult {
+  double insert_per_sec_;
+  double delete_per_sec_;
+};
+
+auto Run(const std::vector<std::pair<int64_t, int64_t>> &rows, size_t batch_size) -> RunResult {
+  auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<bustub::BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get());
+  bustub::Catalog catalog(bpm.get(), nullptr, nullptr);
+  auto schema = bustub::ParseCreateStatement("a bigint,b bigint");
+  auto table_info = catalog.CreateTable(nullptr, "t", *schema);
+  std::vector<bustub::IndexInfo *> indexes;
+  for (uint32_t column = 0; column < 2; column++) {
+    auto key_schema = bustub::Schema::CopySchema(schema.get(), {column});
+    indexes.push_back(
+        catalog.CreateIndex<bustub::IntegerKeyType, bustub::IntegerValueType, bustub::IntegerComparatorType>(
+            nullptr, fmt::format("t_{}", column), "t", *schema, key_schema, {column}, bustub::TWO_INTEGER_SIZE,
+            bustub::IntegerHashFunctionType{}));
+  }
+
+  auto make_entries = [&](size_t begin, size_t end, const std::vector<bustub::RID> &rids, size_t index) {
+    std::vector<std::pair<bustub::Tuple, bustub::RID>> entries;
+    entries.reserve(end - begin);
+    auto *key_schema = indexes[index]->index_->GetKeySchema();
+    for (size_t i = begin; i < end; i++) {
+      auto value = index == 0 ? rows[i].first : rows[i].second;
+      entries.emplace_back(bustub::Tuple({bustub::ValueFactory::GetBigIntValue(value)}, key_schema), rids[i]);
+    }
+    return entries;
+  };
+
+  RunResult result{};
+  std::vector<bustub::RID> rids(rows.size());
+  auto start = std::chrono::steady_clock::now();
+  for (size_t begin = 0; begin < rows.size(); begin += batch_size) {
+    size_t end = std::min(rows.size(), begin + batch_size);
+    for (size_t i = begin; i < end; i++) {
+      bustub::Tuple tuple({bustub::ValueFactory::GetBigIntValue(rows[i].first),
+                           bustub::ValueFactory::GetBigIntValue(rows[i].second)},
+                          schema.get());
+      bustub::TupleMeta meta{bustub::INVALID_TXN_ID, bustub::INVALID_TXN_ID, false};
+      rids[i] = *table_info->table_->InsertTuple(meta, tuple);
+    }
+    for (size_t index = 0; index < indexes.size(); index++) {
+      auto entries = make_entries(begin, end, rids, index);
+      if (batch_size == 1) {
+        indexes[index]->index_->InsertEntry(entries[0].first, entries[0].second, nullptr);
+      } else {
+        indexes[index]->index_->InsertEntries(entries, nullptr);
+      }
+    }
+  }
+  result.insert_per_sec_ = rows.size() / SecondsSince(start);
+
+  std::vector<bustub::RID> found;
+  indexes[1]->index_->ScanKey(bustub::Tuple({bustub::ValueFactory::GetBigIntValue(rows.back().second)},
+                                            indexes[1]->index_->GetKeySchema()),
+                              &found, nullptr);
+  if (found.size() != 1 || !(found[0] == rids.back())) {
+    throw std::runtime_error("key not found");
+  }
+
+  start = std::chrono::steady_clock::now();
+  for (size_t begin = 0; begin < rows.size(); begin += batch_size) {
+    size_t end = std::min(rows.size(), begin + batch_size);
+    for (size_t index = 0; index < indexes.size(); index++) {
+      auto entries = make_entries(begin, end, rids, index);
+      if (batch_size == 1) {
+        indexes[index]->index_->DeleteEntry(entries[0].first, entries[0].second, nullptr);
+      } else {
+        indexes[index]->index_->DeleteEntries(entries, nullptr);
+      }
+    }
+  }
+  result.delete_per_sec_ = rows.size() / SecondsSince(start);
+  return result;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-btree-batch-bench");
+  program.add_argument("--rows").help("number of rows to insert");
+  program.add_argument("--batch").help("rows per batch (default: INDEX_BATCH_SIZE)");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t total_rows = TOTAL_ROWS;
+  if (program.present("--rows")) {
+    total_rows = std::stoul(program.get("--rows"));
+  }
+  size_t batch_size = bustub::INDEX_BATCH_SIZE;
+  if (program.present("--batch")) {
+    batch_size = std::stoul(program.get("--batch"));
+  }
+
+  fmt::print(stderr, "[info] total_rows={}, batch_size={}, bpm_size={}\n", total_rows, batch_size, BUSTUB_BPM_SIZE);
+
+  // two unique columns in unrelated random orders, so that every batch spreads over both indexes
+  std::vector<int64_t> a(total_rows);
+  std::iota(a.begin(), a.end(), 0);
+  std::vector<int64_t> b = a;
+  std::mt19937 gen(15445);
+  std::shuffle(a.begin(), a.end(), gen);
+  std::shuffle(b.begin(), b.end(), gen);
+  std::vector<std::pair<int64_t, int64_t>> rows(total_rows);
+  for (size_t i = 0; i < total_rows; i++) {
+    rows[i] = {a[i], b[i]};
+  }
+
+  auto single = Run(rows, 1);
+  auto batched = Run(rows, batch_size);
+
+  fmt::print("{:<8} {:>12} {:>12}\n", "", "insert/s", "delete/s");
+  fmt::print("{:<8} {:>12.0f} {:>12.0f}\n", "entry", single.insert_per_sec_, single.delete_per_sec_);
+  fmt::print("{:<8} {:>12.0f} {:>12.0f}\n", "batch", batched.insert_per_sec_, batched.delete_per_sec_);
+
+  return 0;
+}
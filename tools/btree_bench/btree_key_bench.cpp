@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "fmt/format.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/memcmp_key.h"
+#include "test_util.h"
+#include "type/value_factory.h"
+
+/*
+ * Compares GenericComparator, which deserializes every column into a Value, with MemcmpComparator on memcomparable
+ * keys: raw comparisons per second, then inserts and point lookups per second on a BPlusTree.
+ */
+
+using KeyType = bustub::GenericKey<64>;
+
+static const size_t TOTAL_KEYS = 200000;
+static const size_t TOTAL_COMPARISONS = 10000000;
+static const size_t BUSTUB_BPM_SIZE = 8192;
+
+auto SecondsSince(std::chrono::steady_clock::time_point start) -> double {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename Comparator>
+auto ComparisonsPerSecond(const std::vector<KeyType> &keys, const Comparator &comparator, size_t total_comparisons)
+    -> double {
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<size_t> dis(0, keys.size() - 1);
+  std::vector<std::pair<size_t, size_t>> pairs;
+  for (size_t i = 0; i < 1024; i++) {
+    pairs.emplace_back(dis(gen), dis(gen));
+  }
+  int64_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < total_comparisons; i++) {
+    const auto &[lhs, rhs] = pairs[i % pairs.size()];
+    checksum += comparator(keys[lhs], keys[rhs]) < 0 ? 1 : 0;
+  }
+  auto seconds = SecondsSince(start);
+  fmt::print(stderr, "[info] checksum={}\n", checksum);
+  return total_comparisons / seconds;
+}
+
+struct TreeResult {
+  double insert_per_sec_;
+  double lookup_per_sec_;
+};
+
+template <typename Comparator>
+auto RunTree(const std::vector<KeyType> &keys, const Comparator &comparator) -> TreeResult {
+  auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<bustub::BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get());
+  bustub::page_id_t page_id;
+  bpm->NewPageGuarded(&page_id);
+  bustub::BPlusTree<KeyType, bustub::RID, Comparator> tree("bench", page_id, bpm.get(), comparator);
+
+  TreeResult result{};
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < keys.size(); i++) {
+    tree.Insert(keys[i], bustub::RID(static_cast<bustub::page_id_t>(i), 0));
+  }
+  result.insert_per_sec_ = keys.size() / SecondsSince(start);
+
+  std::vector<bustub::RID> rids;
+  start = std::chrono::steady_clock::now();
+  for (const auto &key : keys) {
+    rids.clear();
+    if (!tree.GetValue(key, &rids)) {
+      throw std::runtime_error("key not found");
+    }
+  }
+  result.lookup_per_sec_ = keys.size() / SecondsSince(start);
+  return result;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-btree-key-bench");
+  program.add_argument("--keys").help("number of keys to index");
+  program.add_argument("--comparisons").help("number of key comparisons to time");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t total_keys = TOTAL_KEYS;
+  if (program.present("--keys")) {
+    total_keys = std::stoul(program.get("--keys"));
+  }
+  size_t total_comparisons = TOTAL_COMPARISONS;
+  if (program.present("--comparisons")) {
+    total_comparisons = std::stoul(program.get("--comparisons"));
+  }
+
+  fmt::print(stderr, "[info] total_keys={}, total_comparisons={}, bpm_size={}\n", total_keys, total_comparisons,
+             BUSTUB_BPM_SIZE);
+
+  // (region, name, id) with few regions and short names, so comparisons usually go past the first column
+  auto key_schema = bustub::ParseCreateStatement("region integer,name varchar(8),id bigint");
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<int> region_dis(0, 7);
+  std::uniform_int_distribution<int> length_dis(1, 8);
+  std::uniform_int_distribution<int> char_dis('a', 'd');
+  std::vector<KeyType> generic_keys;
+  std::vector<KeyType> memcmp_keys;
+  for (size_t i = 0; i < total_keys; i++) {
+    std::string name(length_dis(gen), ' ');
+    for (auto &c : name) {
+      c = static_cast<char>(char_dis(gen));
+    }
+    bustub::Tuple tuple({bustub::ValueFactory::GetIntegerValue(region_dis(gen)),
+                         bustub::ValueFactory::GetVarcharValue(name),
+                         bustub::ValueFactory::GetBigIntValue(static_cast<int64_t>(i))},
+                        key_schema.get());
+    KeyType key;
+    key.SetFromKey(tuple);
+    generic_keys.push_back(key);
+    memcmp_keys.push_back(bustub::MemcmpKeyEncoder::MakeKey<64>(tuple, key_schema.get()));
+  }
+
+  bustub::GenericComparator<64> generic_comparator(key_schema.get());
+  bustub::MemcmpComparator<64> memcmp_comparator(key_schema.get());
+
+  auto generic_cmp = ComparisonsPerSecond(generic_keys, generic_comparator, total_comparisons);
+  auto memcmp_cmp = ComparisonsPerSecond(memcmp_keys, memcmp_comparator, total_comparisons);
+  auto generic_tree = RunTree(generic_keys, generic_comparator);
+  auto memcmp_tree = RunTree(memcmp_keys, memcmp_comparator);
+
+  fmt::print("{:<8} {:>14} {:>12} {:>12}\n", "", "compare/s", "insert/s", "lookup/s");
+  fmt::print("{:<8} {:>14.0f} {:>12.0f} {:>12.0f}\n", "generic", generic_cmp, generic_tree.insert_per_sec_,
+             generic_tree.lookup_per_sec_);
+  fmt::print("{:<8} {:>14.0f} {:>12.0f} {:>12.0f}\n", "memcmp", memcmp_cmp, memcmp_tree.insert_per_sec_,
+             memcmp_tree.lookup_per_sec_);
+
+  return 0;
+}
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "fmt/format.h"
+#include "prefix_page.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/generic_key.h"
+#include "test_util.h"
+#include "type/value_factory.h"
+
+/*
+ * Compares the fanout, height and point lookup latency of two trees built bottom-up from the same composite keys:
+ * one with the regular page layout (BPlusTree::BulkLoad, pages packed full) and one with prefix-compressed pages
+ * and truncated separators.
+ */
+
+using KeyType = bustub::GenericKey<32>;
+using ComparatorType = bustub::GenericComparator<32>;
+using LeafPage = bustub::BPlusTreeLeafPage<KeyType, bustub::RID, ComparatorType>;
+using InternalPage = bustub::BPlusTreeInternalPage<KeyType, bustub::page_id_t, ComparatorType>;
+using PrefixLeafPage = bustub::BPlusTreePrefixLeafPage<KeyType, bustub::RID, ComparatorType>;
+using PrefixInternalPage = bustub::BPlusTreePrefixInternalPage<KeyType, bustub::page_id_t, ComparatorType>;
+
+static const size_t TOTAL_KEYS = 200000;
+static const size_t TOTAL_LOOKUPS = 200000;
+
+struct TreeStats {
+  int height_{0};
+  size_t leaf_pages_{0};
+  size_t internal_pages_{0};
+  size_t internal_entries_{0};
+  double lookup_ns_{0};
+};
+
+/** Walk every level through the sibling links, counting pages and children. */
+template <typename Leaf, typename Internal>
+auto CollectStats(bustub::BufferPoolManager *bpm, bustub::page_id_t root_page_id) -> TreeStats {
+  TreeStats stats;
+  bustub::page_id_t first_page_id = root_page_id;
+  while (true) {
+    stats.height_++;
+    auto guard = bpm->FetchPageRead(first_page_id);
+    if (guard.As<bustub::BPlusTreePage>()->IsLeafPage()) {
+      for (auto page_id = first_page_id; page_id != bustub::INVALID_PAGE_ID;) {
+        auto leaf_guard = bpm->FetchPageRead(page_id);
+        stats.leaf_pages_++;
+        page_id = leaf_guard.As<Leaf>()->GetNextPageId();
+      }
+      return stats;
+    }
+    for (auto page_id = first_page_id; page_id != bustub::INVALID_PAGE_ID;) {
+      auto internal_guard = bpm->FetchPageRead(page_id);
+      stats.internal_pages_++;
+      stats.internal_entries_ += internal_guard.As<Internal>()->GetSize();
+      page_id = internal_guard.As<Internal>()->GetNextPageId();
+    }
+    first_page_id = guard.As<Internal>()->ValueAt(0);
+  }
+}
+
+/** Build a prefix-compressed tree bottom-up from sorted, unique pairs and return its root. */
+auto BuildPrefixTree(bustub::BufferPoolManager *bpm, const std::vector<std::pair<KeyType, bustub::RID>> &pairs,
+                     const ComparatorType &comparator) -> bustub::page_id_t {
+  // Routing key and page id of every page on the level just built.
+  std::vector<std::pair<KeyType, bustub::page_id_t>> level;
+  bustub::page_id_t page_id;
+  auto guard = bpm->NewPageGuarded(&page_id);
+  auto leaf = guard.AsMut<PrefixLeafPage>();
+  leaf->Init();
+  level.emplace_back(pairs[0].first, page_id);
+  for (size_t i = 0; i < pairs.size(); i++) {
+    if (leaf->Insert(pairs[i].first, pairs[i].second, comparator)) {
+      continue;
+    }
+    auto next_guard = bpm->NewPageGuarded(&page_id);
+    leaf->SetNextPageId(page_id);
+    leaf = next_guard.AsMut<PrefixLeafPage>();
+    leaf->Init();
+    leaf->Insert(pairs[i].first, pairs[i].second, comparator);
+    level.emplace_back(PrefixInternalPage::ShortestSeparator(pairs[i - 1].first, pairs[i].first, comparator), page_id);
+    guard = std::move(next_guard);
+  }
+
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, bustub::page_id_t>> parents;
+    guard = bpm->NewPageGuarded(&page_id);
+    auto internal = guard.AsMut<PrefixInternalPage>();
+    internal->Init();
+    parents.emplace_back(level[0].first, page_id);
+    for (const auto &[key, child] : level) {
+      if (internal->Append(key, child)) {
+        continue;
+      }
+      auto next_guard = bpm->NewPageGuarded(&page_id);
+      internal->SetNextPageId(page_id);
+      internal = next_guard.AsMut<PrefixInternalPage>();
+      internal->Init();
+      internal->Append(key, child);
+      parents.emplace_back(key, page_id);
+      guard = std::move(next_guard);
+    }
+    level = std::move(parents);
+  }
+  return level[0].second;
+}
+
+auto PrefixTreeLookup(bustub::BufferPoolManager *bpm, bustub::page_id_t root_page_id, const KeyType &key,
+                      const ComparatorType &comparator, bustub::RID *rid) -> bool {
+  auto guard = bpm->FetchPageRead(root_page_id);
+  while (!guard.As<bustub::BPlusTreePage>()->IsLeafPage()) {
+    guard = bpm->FetchPageRead(guard.As<PrefixInternalPage>()->Lookup(key, comparator));
+  }
+  return guard.As<PrefixLeafPage>()->Lookup(key, rid, comparator);
+}
+
+template <typename Lookup>
+auto TimeLookups(const std::vector<KeyType> &keys, Lookup &&lookup) -> double {
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &key : keys) {
+    if (!lookup(key)) {
+      throw std::runtime_error("key not found");
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / keys.size();
+}
+
+void PrintStats(const std::string &layout, const TreeStats &stats, size_t total_keys) {
+  fmt::print("{:<8} height={} leaf_pages={:<8} keys_per_leaf={:<8.1f} internal_pages={:<6} fanout={:<8.1f} "
+             "lookup_ns={:.1f}\n",
+             layout, stats.height_, stats.leaf_pages_, static_cast<double>(total_keys) / stats.leaf_pages_,
+             stats.internal_pages_,
+             stats.internal_pages_ == 0 ? 0.0 : static_cast<double>(stats.internal_entries_) / stats.internal_pages_,
+             stats.lookup_ns_);
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-btree-prefix-bench");
+  program.add_argument("--keys").help("number of keys to index");
+  program.add_argument("--lookups").help("number of random point lookups per tree");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t total_keys = TOTAL_KEYS;
+  if (program.present("--keys")) {
+    total_keys = std::stoul(program.get("--keys"));
+  }
+  size_t total_lookups = TOTAL_LOOKUPS;
+  if (program.present("--lookups")) {
+    total_lookups = std::stoul(program.get("--lookups"));
+  }
+
+  // Keep both trees in memory so that lookups measure page layout, not I/O.
+  size_t bpm_size = total_keys / 16 + 256;
+  auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<bustub::BufferPoolManager>(bpm_size, disk_manager.get());
+
+  fmt::print(stderr, "[info] total_keys={}, total_lookups={}, bpm_size={}\n", total_keys, total_lookups, bpm_size);
+
+  // Hierarchical ids (tenant, region, user, event): neighbouring keys share their leading columns.
+  auto key_schema = bustub::ParseCreateStatement("tenant bigint,region bigint,user bigint,event bigint");
+  ComparatorType comparator(key_schema.get());
+  std::vector<std::pair<KeyType, bustub::RID>> pairs;
+  pairs.reserve(total_keys);
+  for (size_t i = 0; i < total_keys; i++) {
+    auto id = static_cast<int64_t>(i);
+    std::vector<bustub::Value> values{
+        bustub::ValueFactory::GetBigIntValue(1 + id / 65536), bustub::ValueFactory::GetBigIntValue(id / 4096 % 16),
+        bustub::ValueFactory::GetBigIntValue(id / 64 % 64), bustub::ValueFactory::GetBigIntValue(id % 64)};
+    KeyType key;
+    key.SetFromKey(bustub::Tuple(values, key_schema.get()));
+    pairs.emplace_back(key, bustub::RID(static_cast<bustub::page_id_t>(i), 0));
+  }
+
+  std::vector<KeyType> lookup_keys;
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<size_t> dis(0, total_keys - 1);
+  for (size_t i = 0; i < total_lookups; i++) {
+    lookup_keys.push_back(pairs[dis(gen)].first);
+  }
+
+  bustub::page_id_t header_page_id;
+  bpm->NewPageGuarded(&header_page_id);
+  bustub::BPlusTree<KeyType, bustub::RID, ComparatorType> tree("regular", header_page_id, bpm.get(), comparator);
+  tree.BulkLoad(pairs, 1.0);
+  auto regular = CollectStats<LeafPage, InternalPage>(bpm.get(), tree.GetRootPageId());
+  std::vector<bustub::RID> rids;
+  regular.lookup_ns_ = TimeLookups(lookup_keys, [&](const KeyType &key) {
+    rids.clear();
+    return tree.GetValue(key, &rids);
+  });
+
+  auto root_page_id = BuildPrefixTree(bpm.get(), pairs, comparator);
+  auto prefix = CollectStats<PrefixLeafPage, PrefixInternalPage>(bpm.get(), root_page_id);
+  bustub::RID rid;
+  prefix.lookup_ns_ = TimeLookups(lookup_keys, [&](const KeyType &key) {
+    return PrefixTreeLookup(bpm.get(), root_page_id, key, comparator, &rid);
+  });
+
+  PrintStats("regular", regular, total_keys);
+  PrintStats("prefix", prefix, total_keys);
+
+  return 0;
+}
@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "prefix_page.h"
+
+namespace bustub {
+
+namespace {
+
+/** Number of leading bytes two buffers have in common, at most `size`. */
+auto CommonPrefixSize(const char *lhs, const char *rhs, int size) -> int {
+  int i = 0;
+  while (i < size && lhs[i] == rhs[i]) {
+    i++;
+  }
+  return i;
+}
+
+}  // namespace
+
+/*****************************************************************************
+ * LEAF PAGE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Init() {
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetSize(0);
+  SetMaxSize(DATA_SIZE / (KEY_SIZE + sizeof(ValueType)));
+  SetNextPageId(INVALID_PAGE_ID);
+  prefix_size_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::GetPrefixSize() const -> int { return prefix_size_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::GetFreeSpace() const -> int {
+  return DATA_SIZE - prefix_size_ - GetSize() * SlotSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
+  KeyType key;
+  memcpy(key.data_, data_, prefix_size_);
+  memcpy(key.data_ + prefix_size_, SlotAt(index), KEY_SIZE - prefix_size_);
+  return key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType {
+  ValueType value;
+  memcpy(static_cast<void *>(&value), SlotAt(index) + KEY_SIZE - prefix_size_, sizeof(ValueType));
+  return value;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::WriteSlot(int index, const KeyType &key, const ValueType &value) {
+  char *slot = SlotAt(index);
+  memcpy(slot, key.data_ + prefix_size_, KEY_SIZE - prefix_size_);
+  memcpy(slot + KEY_SIZE - prefix_size_, static_cast<const void *>(&value), sizeof(ValueType));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  int lo = 0;
+  int hi = GetSize();
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (comparator(KeyAt(mid), key) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value,
+                                               const KeyComparator &comparator) const -> bool {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(KeyAt(index), key) != 0) {
+    return false;
+  }
+  *value = ValueAt(index);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value,
+                                               const KeyComparator &comparator) -> bool {
+  int size = GetSize();
+  if (size == 0) {
+    // A single key is all prefix.
+    memcpy(data_, key.data_, KEY_SIZE);
+    prefix_size_ = KEY_SIZE;
+    WriteSlot(0, key, value);
+    SetSize(1);
+    return true;
+  }
+
+  int index = KeyIndex(key, comparator);
+  if (index < size && comparator(KeyAt(index), key) == 0) {
+    return false;
+  }
+
+  int prefix_size = CommonPrefixSize(data_, key.data_, prefix_size_);
+  if (prefix_size == prefix_size_) {
+    if (GetFreeSpace() < SlotSize()) {
+      return false;
+    }
+    memmove(SlotAt(index + 1), SlotAt(index), (size - index) * SlotSize());
+    WriteSlot(index, key, value);
+    IncreaseSize(1);
+    return true;
+  }
+
+  // The new key shares fewer bytes with the page, so every slot grows: decode and write the page again.
+  int slot_size = KEY_SIZE - prefix_size + static_cast<int>(sizeof(ValueType));
+  if (prefix_size + (size + 1) * slot_size > DATA_SIZE) {
+    return false;
+  }
+  std::vector<std::pair<KeyType, ValueType>> pairs;
+  pairs.reserve(size + 1);
+  for (int i = 0; i < size; i++) {
+    pairs.emplace_back(KeyAt(i), ValueAt(i));
+  }
+  pairs.insert(pairs.begin() + index, {key, value});
+  // The shorter prefix is a prefix of the old one, so the bytes in front of the slots stay valid.
+  prefix_size_ = prefix_size;
+  for (int i = 0; i <= size; i++) {
+    WriteSlot(i, pairs[i].first, pairs[i].second);
+  }
+  SetSize(size + 1);
+  return true;
+}
+
+/*****************************************************************************
+ * INTERNAL PAGE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::Init() {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetSize(0);
+  SetMaxSize(DATA_SIZE / (KEY_SIZE + sizeof(Slot)));
+  SetNextPageId(INVALID_PAGE_ID);
+  prefix_size_ = 0;
+  heap_start_ = DATA_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::GetPrefixSize() const -> int { return prefix_size_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::GetFreeSpace() const -> int {
+  return heap_start_ - GetSize() * static_cast<int>(sizeof(Slot));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
+  KeyType key;
+  memset(key.data_, 0, KEY_SIZE);
+  memcpy(key.data_, Prefix(), prefix_size_);
+  memcpy(key.data_ + prefix_size_, data_ + Slots()[index].offset_, Slots()[index].length_);
+  return key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return Slots()[index].value_; }
+
+/*
+ * Find the last key that is not greater than `key`, skipping the invalid first key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::ChildIndex(const KeyType &key, const KeyComparator &comparator) const
+    -> int {
+  int lo = 1;
+  int hi = GetSize();
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (comparator(KeyAt(mid), key) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo - 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const
+    -> ValueType {
+  return ValueAt(ChildIndex(key, comparator));
+}
+
+/*
+ * Store the bytes of `key` past the prefix, minus trailing zeros, at the bottom of the suffix heap.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::AppendSlot(const KeyType &key, const ValueType &value) {
+  int length = KEY_SIZE - prefix_size_;
+  while (length > 0 && key.data_[prefix_size_ + length - 1] == 0) {
+    length--;
+  }
+  heap_start_ -= length;
+  memcpy(data_ + heap_start_, key.data_ + prefix_size_, length);
+  Slots()[GetSize()] = Slot{static_cast<uint16_t>(heap_start_), static_cast<uint16_t>(length), value};
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) -> bool {
+  int size = GetSize();
+  if (size == 0) {
+    // The first key is never used, so it takes no space at all.
+    if (GetFreeSpace() < static_cast<int>(sizeof(Slot))) {
+      return false;
+    }
+    Slots()[0] = Slot{static_cast<uint16_t>(heap_start_), 0, value};
+    SetSize(1);
+    return true;
+  }
+
+  if (size == 1) {
+    // The first separator becomes the prefix in full.
+    if (GetFreeSpace() < KEY_SIZE + static_cast<int>(sizeof(Slot))) {
+      return false;
+    }
+    prefix_size_ = KEY_SIZE;
+    heap_start_ = DATA_SIZE - KEY_SIZE;
+    memcpy(data_ + heap_start_, key.data_, KEY_SIZE);
+    Slots()[0].offset_ = heap_start_;
+    AppendSlot(key, value);
+    return true;
+  }
+
+  int prefix_size = CommonPrefixSize(Prefix(), key.data_, prefix_size_);
+  if (prefix_size == prefix_size_) {
+    int length = KEY_SIZE - prefix_size_;
+    while (length > 0 && key.data_[prefix_size_ + length - 1] == 0) {
+      length--;
+    }
+    if (GetFreeSpace() < length + static_cast<int>(sizeof(Slot))) {
+      return false;
+    }
+    AppendSlot(key, value);
+    return true;
+  }
+
+  // The prefix shrinks: decode every separator and lay the page out again.
+  std::vector<std::pair<KeyType, ValueType>> pairs;
+  pairs.reserve(size + 1);
+  for (int i = 0; i < size; i++) {
+    pairs.emplace_back(KeyAt(i), ValueAt(i));
+  }
+  pairs.emplace_back(key, value);
+  int needed = prefix_size + (size + 1) * static_cast<int>(sizeof(Slot));
+  for (int i = 1; i <= size; i++) {
+    int length = KEY_SIZE - prefix_size;
+    while (length > 0 && pairs[i].first.data_[prefix_size + length - 1] == 0) {
+      length--;
+    }
+    needed += length;
+  }
+  if (needed > DATA_SIZE) {
+    return false;
+  }
+
+  KeyType prefix = pairs[1].first;
+  SetSize(0);
+  prefix_size_ = prefix_size;
+  heap_start_ = DATA_SIZE - prefix_size;
+  memcpy(data_ + heap_start_, prefix.data_, prefix_size);
+  Slots()[0] = Slot{static_cast<uint16_t>(heap_start_), 0, pairs[0].second};
+  SetSize(1);
+  for (int i = 1; i <= size; i++) {
+    AppendSlot(pairs[i].first, pairs[i].second);
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE::ShortestSeparator(const KeyType &left, const KeyType &right,
+                                                              const KeyComparator &comparator) -> KeyType {
+  KeyType separator;
+  for (int length = 0; length < KEY_SIZE; length++) {
+    memset(separator.data_, 0, KEY_SIZE);
+    memcpy(separator.data_, right.data_, length);
+    if (comparator(left, separator) < 0 && comparator(separator, right) <= 0) {
+      return separator;
+    }
+  }
+  return right;
+}
+
+template class BPlusTreePrefixLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BPlusTreePrefixInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
+}  // namespace bustub
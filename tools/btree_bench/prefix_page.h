@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE BPlusTreePrefixLeafPage<KeyType, ValueType, KeyComparator>
+#define B_PLUS_TREE_PREFIX_INTERNAL_PAGE_TYPE BPlusTreePrefixInternalPage<KeyType, ValueType, KeyComparator>
+#define PREFIX_LEAF_PAGE_HEADER_SIZE 20
+#define PREFIX_INTERNAL_PAGE_HEADER_SIZE 24
+
+/**
+ * Prefix-compressed leaf page. Keys are the raw bytes of a GenericKey; the bytes every key in the page starts with
+ * are stored once, and each slot only keeps the remaining suffix next to its value. Keys are still ordered by the
+ * comparator, so the layout works with any key schema.
+ *
+ * Leaf page format (keys are stored in order):
+ *  ------------------------------------------------------------------------------------
+ * | HEADER | PREFIX | SUFFIX(1) + VALUE(1) | SUFFIX(2) + VALUE(2) | ... | SUFFIX(n) + VALUE(n)
+ *  ------------------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 20 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | NextPageId (4) | PrefixSize (4) |
+ *  ---------------------------------------------------------------------
+ *
+ * The capacity depends on how long the shared prefix is. MaxSize records how many pairs fit without any shared
+ * prefix; a compressed page usually holds more, see GetFreeSpace().
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreePrefixLeafPage : public BPlusTreePage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  BPlusTreePrefixLeafPage() = delete;
+  BPlusTreePrefixLeafPage(const BPlusTreePrefixLeafPage &other) = delete;
+
+  /**
+   * After creating a new leaf page from buffer pool, must call initialize
+   * method to set default values
+   */
+  void Init();
+
+  // helper methods
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  auto GetPrefixSize() const -> int;
+  auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+
+  /** @return number of bytes left for new slots at the current prefix size */
+  auto GetFreeSpace() const -> int;
+
+  /**
+   * @return the index of the first key that is not less than `key`, or GetSize() if there is none
+   */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /**
+   * @param[out] value the value stored with `key`, if found
+   * @return true if `key` exists in this page
+   */
+  auto Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const -> bool;
+
+  /**
+   * Insert a pair keeping the keys sorted, re-encoding the page if `key` shortens the shared prefix.
+   * @return false if `key` already exists or the page has no room for it
+   */
+  auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> bool;
+
+  /**
+   * @brief for test only return a string representing all keys in
+   * this leaf page formatted as "(key1,key2,key3,...)"
+   *
+   * @return std::string
+   */
+  auto ToString() const -> std::string {
+    std::string kstr = "(";
+    for (int i = 0; i < GetSize(); i++) {
+      if (i > 0) {
+        kstr.append(",");
+      }
+      kstr.append(std::to_string(KeyAt(i).ToString()));
+    }
+    kstr.append(")");
+    return kstr;
+  }
+
+ private:
+  static constexpr int KEY_SIZE = sizeof(KeyType);
+  static constexpr int DATA_SIZE = BUSTUB_PAGE_SIZE - PREFIX_LEAF_PAGE_HEADER_SIZE;
+
+  auto SlotSize() const -> int { return KEY_SIZE - prefix_size_ + static_cast<int>(sizeof(ValueType)); }
+  auto SlotAt(int index) const -> const char * { return data_ + prefix_size_ + index * SlotSize(); }
+  auto SlotAt(int index) -> char * { return data_ + prefix_size_ + index * SlotSize(); }
+  void WriteSlot(int index, const KeyType &key, const ValueType &value);
+
+  page_id_t next_page_id_;
+  int32_t prefix_size_;
+  // Flexible array member for page data.
+  char data_[0];
+};
+
+/**
+ * Prefix-compressed internal page, built bottom-up in key order. Separators are stored as variable-length suffixes
+ * after the prefix they all share, with trailing zero bytes dropped, so truncated separators (see
+ * ShortestSeparator) take up only the bytes needed to route.
+ *
+ * Internal page format:
+ *  ------------------------------------------------------------------------------
+ * | HEADER | SLOT(0) | SLOT(1) | ... | SLOT(n) | FREE | SUFFIX(n) ... SUFFIX(1) | PREFIX |
+ *  ------------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 24 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | NextPageId (4) | PrefixSize (4) | HeapStart (4) |
+ *  ---------------------------------------------------------------------
+ *
+ * A slot holds the offset and length of its suffix and the child page id. As in BPlusTreeInternalPage the first key
+ * is invalid and ignored by lookups.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreePrefixInternalPage : public BPlusTreePage {
+ public:
+  // Deleted to disallow initialization
+  BPlusTreePrefixInternalPage() = delete;
+  BPlusTreePrefixInternalPage(const BPlusTreePrefixInternalPage &other) = delete;
+
+  /**
+   * Writes the necessary header information to a newly created page, must be called after
+   * the creation of a new page to make a valid BPlusTreePrefixInternalPage
+   */
+  void Init();
+
+  auto GetNextPageId() const -> page_id_t;
+  void SetNextPageId(page_id_t next_page_id);
+  auto GetPrefixSize() const -> int;
+
+  /**
+   * @param index The index of the key to get. Index must be non-zero.
+   * @return Key at index, zero padded past its stored bytes
+   */
+  auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+
+  /** @return number of bytes left for new slots and suffixes at the current prefix size */
+  auto GetFreeSpace() const -> int;
+
+  /**
+   * @param key the key to route
+   * @return the index of the child whose subtree may contain `key`
+   */
+  auto ChildIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /**
+   * @param key the key to route
+   * @return the child whose subtree may contain `key`
+   */
+  auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType;
+
+  /**
+   * Append a child after all existing ones. `key` is its separator and must be greater than every separator in the
+   * page; it is ignored for the first child.
+   * @return false if the page has no room for it
+   */
+  auto Append(const KeyType &key, const ValueType &value) -> bool;
+
+  /**
+   * Suffix truncation: find the shortest run of leading bytes of `right` that, zero padded, still separates the two
+   * pages. Truncated separators end in zeros, which internal pages do not store.
+   * @return a key S with left < S <= right
+   */
+  static auto ShortestSeparator(const KeyType &left, const KeyType &right, const KeyComparator &comparator)
+      -> KeyType;
+
+ private:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t length_;
+    ValueType value_;
+  };
+
+  static constexpr int KEY_SIZE = sizeof(KeyType);
+  static constexpr int DATA_SIZE = BUSTUB_PAGE_SIZE - PREFIX_INTERNAL_PAGE_HEADER_SIZE;
+
+  auto Slots() const -> const Slot * { return reinterpret_cast<const Slot *>(data_); }
+  auto Slots() -> Slot * { return reinterpret_cast<Slot *>(data_); }
+  auto Prefix() const -> const char * { return data_ + DATA_SIZE - prefix_size_; }
+  void AppendSlot(const KeyType &key, const ValueType &value);
+
+  page_id_t next_page_id_;
+  int32_t prefix_size_;
+  int32_t heap_start_;
+  // Flexible array member for page data.
+  char data_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,159 @@
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "container/hash/hash_function.h"
+#include "fmt/format.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/extendible_hash_table_index.h"
+#include "storage/index/generic_key.h"
+#include "test_util.h"
+#include "type/value_factory.h"
+
+/*
+ * Concurrent inserts and point lookups on an extendible hash index. Writers insert disjoint key ranges while readers
+ * look up keys that have already been inserted, each doing as many lookups as there are keys so a run always ends even
+ * when the latch lets readers starve writers. The table latches only the directory (shared) and the bucket it
+ * touches; the "serialized" run wraps every insert in one exclusive latch instead, the way a table-wide write latch
+ * would, for comparison.
+ */
+
+static const size_t TOTAL_KEYS = 50000;
+static const size_t BUSTUB_BPM_SIZE = 4096;
+
+using HashIndex = bustub::ExtendibleHashTableIndex<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>>;
+
+auto SecondsSince(std::chrono::steady_clock::time_point start) -> double {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct RunResult {
+  double insert_per_sec_;
+  double lookup_per_sec_;
+};
+
+auto Run(size_t total_keys, size_t writers, size_t readers, bool serialized) -> RunResult {
+  auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<bustub::BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get());
+  auto schema = bustub::ParseCreateStatement("a bigint");
+  HashIndex index(std::make_unique<bustub::IndexMetadata>("t_a", "t", schema.get(), std::vector<uint32_t>{0}),
+                  bpm.get(), bustub::HashFunction<bustub::GenericKey<8>>());
+  auto make_key = [&](int64_t a) { return bustub::Tuple({bustub::ValueFactory::GetBigIntValue(a)}, schema.get()); };
+
+  std::shared_mutex table_latch;
+  std::atomic<size_t> inserted{0};
+  std::atomic<size_t> lookups{0};
+
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t w = 0; w < writers; w++) {
+    threads.emplace_back([&, w] {
+      // keys interleave across writers so they share buckets
+      for (size_t i = w; i < total_keys; i += writers) {
+        auto key = make_key(static_cast<int64_t>(i));
+        bustub::RID rid(static_cast<bustub::page_id_t>(i), 0);
+        if (serialized) {
+          std::unique_lock lock(table_latch);
+          index.InsertEntry(key, rid, nullptr);
+        } else {
+          index.InsertEntry(key, rid, nullptr);
+        }
+        inserted.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  for (size_t r = 0; r < readers; r++) {
+    threads.emplace_back([&, r] {
+      size_t count = 0;
+      size_t i = r;
+      std::vector<bustub::RID> result;
+      while (count < total_keys) {
+        size_t bound = inserted.load(std::memory_order_relaxed);
+        if (bound == 0) {
+          std::this_thread::yield();
+          continue;
+        }
+        result.clear();
+        auto key = make_key(static_cast<int64_t>((i * 7919) % bound));
+        if (serialized) {
+          std::shared_lock lock(table_latch);
+          index.ScanKey(key, &result, nullptr);
+        } else {
+          index.ScanKey(key, &result, nullptr);
+        }
+        i++;
+        count++;
+      }
+      lookups.fetch_add(count);
+    });
+  }
+  for (size_t w = 0; w < writers; w++) {
+    threads[w].join();
+  }
+  double insert_elapsed = SecondsSince(start);
+  for (size_t t = writers; t < threads.size(); t++) {
+    threads[t].join();
+  }
+  double lookup_elapsed = SecondsSince(start);
+
+  std::vector<bustub::RID> result;
+  for (size_t i = 0; i < total_keys; i++) {
+    result.clear();
+    index.ScanKey(make_key(static_cast<int64_t>(i)), &result, nullptr);
+    if (result.size() != 1 || result[0].GetPageId() != static_cast<bustub::page_id_t>(i)) {
+      throw std::runtime_error(fmt::format("key {} not found", i));
+    }
+  }
+  return {total_keys / insert_elapsed, lookups.load() / lookup_elapsed};
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-hash-bench");
+  program.add_argument("--keys").help("number of keys to insert");
+  program.add_argument("--writers").help("number of insert threads");
+  program.add_argument("--readers").help("number of lookup threads");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t total_keys = TOTAL_KEYS;
+  if (program.present("--keys")) {
+    total_keys = std::stoul(program.get("--keys"));
+  }
+  size_t writers = 4;
+  if (program.present("--writers")) {
+    writers = std::stoul(program.get("--writers"));
+  }
+  size_t readers = 4;
+  if (program.present("--readers")) {
+    readers = std::stoul(program.get("--readers"));
+  }
+
+  fmt::print(stderr, "[info] total_keys={}, writers={}, readers={}, bpm_size={}\n", total_keys, writers, readers,
+             BUSTUB_BPM_SIZE);
+
+  auto serialized = Run(total_keys, writers, readers, true);
+  auto latched = Run(total_keys, writers, readers, false);
+
+  fmt::print("{:<12} {:>12} {:>12}\n", "", "insert/s", "lookup/s");
+  fmt::print("{:<12} {:>12.0f} {:>12.0f}\n", "serialized", serialized.insert_per_sec_, serialized.lookup_per_sec_);
+  fmt::print("{:<12} {:>12.0f} {:>12.0f}\n", "latched", latched.insert_per_sec_, latched.lookup_per_sec_);
+
+  return 0;
+}
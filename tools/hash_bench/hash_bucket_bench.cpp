@@ -0,0 +1,128 @@
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "common/config.h"
+#include "common/rid.h"
+#include "container/hash/hash_function.h"
+#include "fmt/format.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/hash_table_bucket_page.h"
+#include "test_util.h"
+#include "type/value_factory.h"
+
+/*
+ * Point lookups on one full extendible hash bucket page. "fingerprint" is HashTableBucketPage::GetValue, which
+ * compares a group of one-byte hash fingerprints at a time and runs the comparator on matches only; "scan" walks the
+ * readable slots and runs the comparator on each, which is how the bucket was probed before fingerprints.
+ */
+
+static const size_t TOTAL_LOOKUPS = 2000000;
+
+using bustub::BUSTUB_PAGE_SIZE;
+
+using KeyType = bustub::GenericKey<8>;
+using ValueType = bustub::RID;
+using KeyComparator = bustub::GenericComparator<8>;
+using BucketPage = bustub::HashTableBucketPage<KeyType, ValueType, KeyComparator>;
+
+auto SecondsSince(std::chrono::steady_clock::time_point start) -> double {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+auto ScanGetValue(const BucketPage *bucket, const KeyType &key, const KeyComparator &comparator,
+                  std::vector<ValueType> *result) -> bool {
+  bool found = false;
+  for (uint32_t bucket_idx = 0; bucket_idx < BUCKET_ARRAY_SIZE && bucket->IsOccupied(bucket_idx); bucket_idx++) {
+    if (bucket->IsReadable(bucket_idx) && comparator(key, bucket->KeyAt(bucket_idx)) == 0) {
+      result->push_back(bucket->ValueAt(bucket_idx));
+      found = true;
+    }
+  }
+  return found;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-hash-bucket-bench");
+  program.add_argument("--lookups").help("number of lookups per run");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t total_lookups = TOTAL_LOOKUPS;
+  if (program.present("--lookups")) {
+    total_lookups = std::stoul(program.get("--lookups"));
+  }
+
+  auto schema = bustub::ParseCreateStatement("a bigint");
+  KeyComparator comparator(schema.get());
+  bustub::HashFunction<KeyType> hash_fn;
+  auto make_key = [&](int64_t a) {
+    KeyType key;
+    key.SetFromKey(bustub::Tuple({bustub::ValueFactory::GetBigIntValue(a)}, schema.get()));
+    return key;
+  };
+
+  auto page = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+  std::memset(page.get(), 0, BUSTUB_PAGE_SIZE);
+  auto bucket = reinterpret_cast<BucketPage *>(page.get());
+  for (size_t i = 0; i < BUCKET_ARRAY_SIZE; i++) {
+    auto key = make_key(static_cast<int64_t>(i));
+    bucket->Insert(key, bustub::RID(static_cast<bustub::page_id_t>(i), 0), comparator,
+                   static_cast<uint32_t>(hash_fn.GetHash(key)));
+  }
+  if (!bucket->IsFull()) {
+    throw std::runtime_error("bucket not full");
+  }
+
+  // half of the probes hit a key in the bucket, half miss
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<int64_t> dis(0, 2 * BUCKET_ARRAY_SIZE - 1);
+  std::vector<KeyType> probes;
+  std::vector<uint32_t> probe_hashes;
+  for (size_t i = 0; i < 1024; i++) {
+    probes.push_back(make_key(dis(gen)));
+    probe_hashes.push_back(static_cast<uint32_t>(hash_fn.GetHash(probes.back())));
+  }
+
+  fmt::print(stderr, "[info] bucket_size={}, total_lookups={}\n", BUCKET_ARRAY_SIZE, total_lookups);
+
+  std::vector<ValueType> result;
+  size_t hits = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < total_lookups; i++) {
+    result.clear();
+    hits += bucket->GetValue(probes[i % probes.size()], comparator, probe_hashes[i % probes.size()], &result) ? 1 : 0;
+  }
+  double fingerprint_per_sec = total_lookups / SecondsSince(start);
+
+  size_t scan_hits = 0;
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < total_lookups; i++) {
+    result.clear();
+    scan_hits += ScanGetValue(bucket, probes[i % probes.size()], comparator, &result) ? 1 : 0;
+  }
+  double scan_per_sec = total_lookups / SecondsSince(start);
+
+  if (hits != scan_hits) {
+    throw std::runtime_error(fmt::format("fingerprint lookups found {} keys, scans {}", hits, scan_hits));
+  }
+
+  fmt::print("{:<12} {:>12}\n", "", "lookup/s");
+  fmt::print("{:<12} {:>12.0f}\n", "scan", scan_per_sec);
+  fmt::print("{:<12} {:>12.0f}\n", "fingerprint", fingerprint_per_sec);
+
+  return 0;
+}
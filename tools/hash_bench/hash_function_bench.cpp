@@ -0,0 +1,136 @@
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "common/util/hash_util.h"
+#include "container/hash/hash_function.h"
+#include "fmt/format.h"
+#include "storage/index/b_plus_tree_index.h"
+
+/*
+ * Hashes per second of the hash policies on integer keys, on the two-integer index key, and on varchar-like byte
+ * strings of several lengths. "bytewise" is the shift-xor loop HashUtil::HashBytes used to be, which aggregations and
+ * joins hashed their keys with; "murmur3" is what HashFunction used to compute.
+ */
+
+static const size_t TOTAL_HASHES = 10000000;
+
+/** The former HashUtil::HashBytes */
+auto BytewiseHash(const char *bytes, size_t length) -> uint64_t {
+  uint64_t hash = length;
+  for (size_t i = 0; i < length; ++i) {
+    hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+  }
+  return hash;
+}
+
+struct BytewisePolicy {
+  static auto Hash(const void *data, size_t length) -> uint64_t {
+    return BytewiseHash(static_cast<const char *>(data), length);
+  }
+};
+
+auto SecondsSince(std::chrono::steady_clock::time_point start) -> double {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** @return hashes per second of HashFunction<KeyType, Policy> over `keys`, cycled `total` times in all */
+template <typename KeyType, typename Policy>
+auto BenchKeys(const std::vector<KeyType> &keys, size_t total, uint64_t *sink) -> double {
+  bustub::HashFunction<KeyType, Policy> hash_fn;
+  uint64_t acc = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < total; i++) {
+    acc += hash_fn.GetHash(keys[i % keys.size()]);
+  }
+  double per_sec = total / SecondsSince(start);
+  *sink ^= acc;
+  return per_sec;
+}
+
+/** @return hashes per second of Policy over the strings in `keys` */
+template <typename Policy>
+auto BenchStrings(const std::vector<std::string> &keys, size_t total, uint64_t *sink) -> double {
+  uint64_t acc = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < total; i++) {
+    const auto &key = keys[i % keys.size()];
+    acc += Policy::Hash(key.data(), key.size());
+  }
+  double per_sec = total / SecondsSince(start);
+  *sink ^= acc;
+  return per_sec;
+}
+
+template <typename KeyType>
+void PrintKeysRow(const std::string &name, const std::vector<KeyType> &keys, size_t total, uint64_t *sink) {
+  fmt::print("{:<14} {:>12.1f} {:>12.1f} {:>12.1f}\n", name,
+             BenchKeys<KeyType, BytewisePolicy>(keys, total, sink) / 1e6,
+             BenchKeys<KeyType, bustub::MurmurHash3Policy>(keys, total, sink) / 1e6,
+             BenchKeys<KeyType, bustub::FastHashPolicy>(keys, total, sink) / 1e6);
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-hash-function-bench");
+  program.add_argument("--hashes").help("number of hashes per key kind and policy");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t total_hashes = TOTAL_HASHES;
+  if (program.present("--hashes")) {
+    total_hashes = std::stoul(program.get("--hashes"));
+  }
+
+  // A few thousand distinct keys, so that they stay in cache and the hash itself is measured
+  std::mt19937_64 gen(15445);
+  const size_t distinct = 4096;
+  std::vector<int32_t> int32_keys;
+  std::vector<int64_t> int64_keys;
+  std::vector<bustub::IntegerKeyType> index_keys;
+  for (size_t i = 0; i < distinct; i++) {
+    auto v = gen();
+    int32_keys.push_back(static_cast<int32_t>(v));
+    int64_keys.push_back(static_cast<int64_t>(v));
+    bustub::IntegerKeyType key;
+    std::memcpy(key.data_, &v, sizeof(v));
+    index_keys.push_back(key);
+  }
+
+  fmt::print(stderr, "[info] total_hashes={}\n", total_hashes);
+  uint64_t sink = 0;
+  fmt::print("{:<14} {:>12} {:>12} {:>12}\n", "Mhash/s", "bytewise", "murmur3", "fast");
+  PrintKeysRow("int32", int32_keys, total_hashes, &sink);
+  PrintKeysRow("int64", int64_keys, total_hashes, &sink);
+  PrintKeysRow("index key", index_keys, total_hashes, &sink);
+
+  std::uniform_int_distribution<int> letter('a', 'z');
+  for (size_t length : {4, 8, 16, 32, 64, 256}) {
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < distinct; i++) {
+      std::string key(length, ' ');
+      for (auto &c : key) {
+        c = static_cast<char>(letter(gen));
+      }
+      keys.push_back(std::move(key));
+    }
+    fmt::print("{:<14} {:>12.1f} {:>12.1f} {:>12.1f}\n", fmt::format("varchar({})", length),
+               BenchStrings<BytewisePolicy>(keys, total_hashes, &sink) / 1e6,
+               BenchStrings<bustub::MurmurHash3Policy>(keys, total_hashes, &sink) / 1e6,
+               BenchStrings<bustub::FastHashPolicy>(keys, total_hashes, &sink) / 1e6);
+  }
+  fmt::print(stderr, "[info] checksum={:x}\n", sink);
+
+  return 0;
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "container/disk/hash/linear_probe_hash_table.h"
+#include "fmt/format.h"
+#include "storage/disk/disk_manager_memory.h"
+
+/*
+ * Insert latency of a LinearProbeHashTable that starts at one block and grows to hold every key. Resizes move one old
+ * block per write, so the slowest insert should stay within a small multiple of the median however large the table
+ * gets, instead of paying for a full rebuild.
+ */
+
+static const size_t TOTAL_KEYS = 200000;
+static const size_t BUSTUB_BPM_SIZE = 4096;
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-linear-probe-bench");
+  program.add_argument("--keys").help("number of keys to insert");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t total_keys = TOTAL_KEYS;
+  if (program.present("--keys")) {
+    total_keys = std::stoul(program.get("--keys"));
+  }
+
+  auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<bustub::BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get());
+  bustub::LinearProbeHashTable<int, int, bustub::IntComparator> ht("bench", bpm.get(), bustub::IntComparator(), 1,
+                                                                    bustub::HashFunction<int>());
+
+  fmt::print(stderr, "[info] total_keys={}, bpm_size={}, initial_size={}\n", total_keys, BUSTUB_BPM_SIZE,
+             ht.GetSize());
+
+  std::vector<double> latencies_us;
+  latencies_us.reserve(total_keys);
+  size_t resizes = 0;
+  size_t size = ht.GetSize();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < total_keys; i++) {
+    auto insert_start = std::chrono::steady_clock::now();
+    if (!ht.Insert(nullptr, static_cast<int>(i), static_cast<int>(i))) {
+      throw std::runtime_error(fmt::format("insert {} failed", i));
+    }
+    latencies_us.push_back(
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - insert_start).count());
+    if (ht.GetSize() != size) {
+      size = ht.GetSize();
+      resizes++;
+    }
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<int> result;
+  for (size_t i = 0; i < total_keys; i++) {
+    result.clear();
+    if (!ht.GetValue(nullptr, static_cast<int>(i), &result) || result.size() != 1) {
+      throw std::runtime_error(fmt::format("key {} not found", i));
+    }
+  }
+
+  std::sort(latencies_us.begin(), latencies_us.end());
+  auto percentile = [&](double p) { return latencies_us[static_cast<size_t>(p * (latencies_us.size() - 1))]; };
+  fmt::print("inserts/s {:.0f}, resizes {}, final size {}\n", total_keys / seconds, resizes, size);
+  fmt::print("{:<8} {:>10} {:>10} {:>10} {:>10}\n", "", "p50", "p99", "p99.99", "max");
+  fmt::print("{:<8} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f}\n", "us", percentile(0.5), percentile(0.99),
+             percentile(0.9999), latencies_us.back());
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include <malloc.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "fmt/format.h"
+#include "primer/trie.h"
+
+/*
+ * Builds a Trie out of one key set at a time with Put, then looks every key up with Get, in random order, along with
+ * as many keys that are not in the trie. Prints the heap the trie takes, as malloc reports it, and puts and gets per
+ * second. "sequential" keys look like the ones the TrieStore tests use; "random" keys are random lowercase strings.
+ */
+
+static const size_t TOTAL_KEYS = 200000;
+
+auto SecondsSince(std::chrono::steady_clock::time_point start) -> double {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+auto HeapInUse() -> size_t { return mallinfo2().uordblks; }
+
+void Bench(const std::string &name, const std::vector<std::string> &keys, const std::vector<std::string> &misses) {
+  auto heap_before = HeapInUse();
+  auto trie = bustub::Trie();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < keys.size(); i++) {
+    trie = trie.Put<uint64_t>(keys[i], i);
+  }
+  double put_per_sec = keys.size() / SecondsSince(start);
+  auto heap = HeapInUse() - heap_before;
+
+  std::vector<const std::string *> probes;
+  for (size_t i = 0; i < keys.size(); i++) {
+    probes.push_back(&keys[i]);
+    probes.push_back(&misses[i]);
+  }
+  std::shuffle(probes.begin(), probes.end(), std::mt19937(15445));
+  size_t hits = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto *probe : probes) {
+    hits += trie.Get<uint64_t>(*probe) != nullptr ? 1 : 0;
+  }
+  double get_per_sec = probes.size() / SecondsSince(start);
+  if (hits != keys.size()) {
+    throw std::runtime_error(fmt::format("found {} of {} keys", hits, keys.size()));
+  }
+
+  fmt::print("{:<12} {:>14.1f} {:>14.0f} {:>14.0f}\n", name, heap / static_cast<double>(keys.size()), put_per_sec,
+             get_per_sec);
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-trie-bench");
+  program.add_argument("--keys").help("number of keys per key set");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t total_keys = TOTAL_KEYS;
+  if (program.present("--keys")) {
+    total_keys = std::stoul(program.get("--keys"));
+  }
+
+  fmt::print(stderr, "[info] total_keys={}\n", total_keys);
+  fmt::print("{:<12} {:>14} {:>14} {:>14}\n", "", "heap B/key", "put/s", "get/s");
+
+  std::vector<std::string> keys;
+  std::vector<std::string> misses;
+  for (size_t i = 0; i < total_keys; i++) {
+    keys.push_back(fmt::format("key-{:08}", i * 2));
+    misses.push_back(fmt::format("key-{:08}", i * 2 + 1));
+  }
+  Bench("sequential", keys, misses);
+
+  std::mt19937_64 gen(15445);
+  std::uniform_int_distribution<size_t> length(8, 24);
+  std::uniform_int_distribution<int> letter('a', 'z');
+  auto random_key = [&]() {
+    std::string key(length(gen), ' ');
+    for (auto &c : key) {
+      c = static_cast<char>(letter(gen));
+    }
+    return key;
+  };
+  keys.clear();
+  misses.clear();
+  for (size_t i = 0; i < total_keys; i++) {
+    keys.push_back(random_key());
+    misses.push_back(random_key());
+  }
+  // Duplicates would be counted twice as hits
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  misses.resize(keys.size());
+  std::shuffle(keys.begin(), keys.end(), gen);
+  Bench("random", keys, misses);
+
+  return 0;
+}